@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <iostream>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+
+/**
+This program measures the cost of formatting events with
+abbreviated logger and class names, %c{1}, %c{1.} and %C{2},
+against the unabbreviated %c.
+*/
+class AbbreviationBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                int count = 1000000;
+                if (argc == 2)
+                {
+                        count = atoi(argv[1]);
+                }
+                if (count <= 0)
+                {
+                        usage(argv[0]);
+                }
+
+                run(LOG4CXX_STR("%c"), count);
+                run(LOG4CXX_STR("%c{1}"), count);
+                run(LOG4CXX_STR("%c{1.}"), count);
+                run(LOG4CXX_STR("%C"), count);
+                run(LOG4CXX_STR("%C{2}"), count);
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [eventCount]" << std::endl;
+                exit(1);
+        }
+
+        static void run(const LogString& pattern, int count)
+        {
+                Pool p;
+                PatternLayout layout(pattern);
+                layout.activateOptions(p);
+
+                const char* const names[] = {
+                    "org.apache.log4cxx.net.SocketAppender",
+                    "org.apache.log4cxx.rolling.RollingFileAppender",
+                    "com.example.service.RequestHandler",
+                    "com.example.service.db.ConnectionPool" };
+                const int nameCount = sizeof(names) / sizeof(names[0]);
+                LoggingEventPtr events[nameCount];
+                for (int i = 0; i < nameCount; i++)
+                {
+                        LOG4CXX_DECODE_CHAR(name, names[i]);
+                        events[i] = new LoggingEvent(name, Level::getInfo(),
+                            LOG4CXX_STR("Hello, world."), LOG4CXX_LOCATION);
+                }
+
+                LogString output;
+                apr_time_t start = apr_time_now();
+                for (int i = 0; i < count; i++)
+                {
+                        output.erase();
+                        layout.format(output, events[i % nameCount], p);
+                }
+                apr_time_t elapsed = apr_time_now() - start;
+
+                LOG4CXX_ENCODE_CHAR(patternStr, pattern);
+                std::cout << patternStr << ": " << count << " events in "
+                          << (elapsed / 1000) << " ms, "
+                          << (elapsed * 1000 / count) << " ns/event" << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        AbbreviationBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
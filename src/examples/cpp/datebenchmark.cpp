@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/simpledateformat.h>
+#include <log4cxx/helpers/cacheddateformat.h>
+#include <log4cxx/helpers/timezone.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <iostream>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::pattern;
+
+
+/**
+This program measures date formatting in the local time zone
+from several threads sharing one formatter, both for the uncached
+SimpleDateFormat and for CachedDateFormat.  Each thread advances
+its own timestamps by a little over a millisecond per call.
+*/
+class DateBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                int count = 1000000;
+                int threadCount = 4;
+                if (argc >= 2)
+                {
+                        count = atoi(argv[1]);
+                }
+                if (argc >= 3)
+                {
+                        threadCount = atoi(argv[2]);
+                }
+                if (argc > 3 || count <= 0 || threadCount <= 0 || threadCount > MAX_THREADS)
+                {
+                        usage(argv[0]);
+                }
+
+                LogString pattern(LOG4CXX_STR("yyyy-MM-dd HH:mm:ss,SSS"));
+                for (int threads = 1; threads <= threadCount; threads *= 2)
+                {
+                        SimpleDateFormat simple(pattern);
+                        run(LOG4CXX_STR("SimpleDateFormat"), simple, count, threads);
+
+                        DateFormatPtr underlying(new SimpleDateFormat(pattern));
+                        CachedDateFormat cached(underlying, 1000000);
+                        run(LOG4CXX_STR("CachedDateFormat"), cached, count, threads);
+                }
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [formatCount [threadCount]]" << std::endl;
+                exit(1);
+        }
+
+private:
+        enum { MAX_THREADS = 64 };
+
+        struct Task
+        {
+                const DateFormat* format;
+                int count;
+                apr_time_t start;
+        };
+
+        static void* LOG4CXX_THREAD_FUNC formatDates(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                Pool p;
+                LogString output;
+                apr_time_t time = task->start;
+                for (int i = 0; i < task->count; i++)
+                {
+                        output.erase();
+                        task->format->format(output, time, p);
+                        time += 1013;
+                }
+                return 0;
+        }
+
+        static void run(const LogString& name, const DateFormat& format,
+                        int count, int threadCount)
+        {
+                Task tasks[MAX_THREADS];
+                Thread threads[MAX_THREADS];
+                apr_time_t now = apr_time_now();
+                for (int i = 0; i < threadCount; i++)
+                {
+                        tasks[i].format = &format;
+                        tasks[i].count = count / threadCount;
+                        tasks[i].start = now + i * 7;
+                }
+
+                apr_time_t start = apr_time_now();
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].run(formatDates, &tasks[i]);
+                }
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].join();
+                }
+                apr_time_t elapsed = apr_time_now() - start;
+
+                LOG4CXX_ENCODE_CHAR(nameStr, name);
+                std::cout << nameStr << ", " << threadCount << " thread(s): "
+                          << count << " dates in "
+                          << (elapsed / 1000) << " ms, "
+                          << (elapsed * 1000 / count) << " ns/date" << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        DateBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/logstring.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <iostream>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+
+/**
+This program measures the throughput of a FileAppender written
+by 1 to 64 threads, with every append serialized on the appender
+lock and with ConcurrentWrites where each thread formats its own
+event and writes it into a reserved range of the file.
+*/
+class FileAppenderBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                int count = 1000000;
+                int threadCount = MAX_THREADS;
+                if (argc >= 2)
+                {
+                        count = atoi(argv[1]);
+                }
+                if (argc >= 3)
+                {
+                        threadCount = atoi(argv[2]);
+                }
+                if (argc > 3 || count <= 0 || threadCount <= 0 || threadCount > MAX_THREADS)
+                {
+                        usage(argv[0]);
+                }
+
+                LoggerPtr locked(createLogger(LOG4CXX_STR("locked"), false));
+                LoggerPtr concurrent(createLogger(LOG4CXX_STR("concurrent"), true));
+                for (int threads = 1; threads <= threadCount; threads *= 2)
+                {
+                        run(LOG4CXX_STR("locked"), locked, count, threads);
+                        run(LOG4CXX_STR("concurrent"), concurrent, count, threads);
+                }
+                LogManager::shutdown();
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [eventCount [threadCount]]" << std::endl;
+                exit(1);
+        }
+
+private:
+        enum { MAX_THREADS = 64 };
+
+        struct Task
+        {
+                LoggerPtr logger;
+                int count;
+        };
+
+        static LoggerPtr createLogger(const LogString& name, bool concurrentWrites)
+        {
+                Pool p;
+                FileAppenderPtr appender(new FileAppender());
+                appender->setFile(LOG4CXX_STR("output/fileappenderbenchmark-") + name + LOG4CXX_STR(".log"));
+                appender->setAppend(false);
+                appender->setImmediateFlush(false);
+                appender->setConcurrentWrites(concurrentWrites);
+                appender->setLayout(new PatternLayout(LOG4CXX_STR("%d %-5p [%t] %c - %m%n")));
+                appender->activateOptions(p);
+
+                LoggerPtr logger(Logger::getLogger(name));
+                logger->setAdditivity(false);
+                logger->addAppender(appender);
+                return logger;
+        }
+
+        static void* LOG4CXX_THREAD_FUNC log(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                for (int i = 0; i < task->count; i++)
+                {
+                        LOG4CXX_INFO(task->logger, "Hello, World");
+                }
+                return 0;
+        }
+
+        static void run(const LogString& name, const LoggerPtr& logger,
+                        int count, int threadCount)
+        {
+                Task tasks[MAX_THREADS];
+                Thread threads[MAX_THREADS];
+                for (int i = 0; i < threadCount; i++)
+                {
+                        tasks[i].logger = logger;
+                        tasks[i].count = count / threadCount;
+                }
+
+                apr_time_t start = apr_time_now();
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].run(log, &tasks[i]);
+                }
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].join();
+                }
+                apr_time_t elapsed = apr_time_now() - start;
+                if (elapsed <= 0)
+                {
+                        elapsed = 1;
+                }
+
+                LOG4CXX_ENCODE_CHAR(nameStr, name);
+                std::cout << nameStr << ", " << threadCount << " thread(s): "
+                          << count << " events in "
+                          << (elapsed / 1000) << " ms, "
+                          << ((apr_int64_t) count * 1000000 / elapsed) << " events/s" << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        FileAppenderBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/logstring.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/fileappender.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <apr_file_io.h>
+#include <apr_atomic.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+
+/**
+This program measures the time taken to append each event to a
+FileAppender, with blocking writes and with AsyncIO, while another
+thread keeps the file system busy with large synchronous writes.
+Run it on a directory of a tmpfs or loop device file system so the
+load does not disturb other work.
+*/
+class FileLatencyBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                std::string dir("output");
+                int count = 100000;
+                if (argc >= 2)
+                {
+                        dir = argv[1];
+                }
+                if (argc >= 3)
+                {
+                        count = atoi(argv[2]);
+                }
+                if (argc > 3 || count <= 0)
+                {
+                        usage(argv[0]);
+                }
+
+                Load load;
+                load.path = dir + "/filelatencybenchmark-load.tmp";
+                load.stop = 0;
+                Thread loadThread;
+                loadThread.run(writeLoad, &load);
+
+                LogString logDir;
+                Transcoder::decode(dir, logDir);
+                run(LOG4CXX_STR("blocking"), logDir, false, count);
+                run(LOG4CXX_STR("asyncio"), logDir, true, count);
+
+                apr_atomic_set32(&load.stop, 1);
+                loadThread.join();
+                LogManager::shutdown();
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [directory [eventCount]]" << std::endl;
+                exit(1);
+        }
+
+private:
+        struct Load
+        {
+                std::string path;
+                apr_uint32_t volatile stop;
+        };
+
+        /**
+         *  Writes and syncs 1 MB blocks until stopped.
+         */
+        static void* LOG4CXX_THREAD_FUNC writeLoad(apr_thread_t* /* thread */, void* data)
+        {
+                Load* load = (Load*) data;
+                apr_pool_t* pool;
+                apr_pool_create(&pool, NULL);
+                apr_file_t* file;
+                if (apr_file_open(&file, load->path.c_str(),
+                        APR_WRITE | APR_CREATE | APR_TRUNCATE, APR_OS_DEFAULT, pool) == APR_SUCCESS)
+                {
+                        std::vector<char> block(1024 * 1024, 'x');
+                        for(int i = 0; apr_atomic_read32(&load->stop) == 0; i++)
+                        {
+                                apr_size_t len = block.size();
+                                apr_file_write(file, &block[0], &len);
+                                apr_file_sync(file);
+                                if (i % 64 == 63)
+                                {
+                                        apr_off_t start = 0;
+                                        apr_file_trunc(file, start);
+                                }
+                        }
+                        apr_file_close(file);
+                        apr_file_remove(load->path.c_str(), pool);
+                }
+                apr_pool_destroy(pool);
+                return 0;
+        }
+
+        static void run(const LogString& name, const LogString& dir,
+                        bool asyncIO, int count)
+        {
+                Pool p;
+                FileAppenderPtr appender(new FileAppender());
+                appender->setFile(dir + LOG4CXX_STR("/filelatencybenchmark-") + name + LOG4CXX_STR(".log"));
+                appender->setAppend(false);
+                appender->setBufferSize(64 * 1024);
+                appender->setAsyncIO(asyncIO);
+                appender->setLayout(new PatternLayout(LOG4CXX_STR("%d %-5p [%t] %c - %m%n")));
+                appender->activateOptions(p);
+
+                LoggerPtr logger(Logger::getLogger(name));
+                logger->setAdditivity(false);
+                logger->addAppender(appender);
+
+                std::vector<apr_time_t> latencies(count);
+                for (int i = 0; i < count; i++)
+                {
+                        apr_time_t start = apr_time_now();
+                        LOG4CXX_INFO(logger, "Hello, World");
+                        latencies[i] = apr_time_now() - start;
+                }
+                logger->removeAppender(appender);
+                appender->close();
+
+                std::sort(latencies.begin(), latencies.end());
+                LOG4CXX_ENCODE_CHAR(nameStr, name);
+                std::cout << nameStr << ": " << count << " events, latency in us"
+                          << " p50=" << latencies[count / 2]
+                          << " p99=" << latencies[(count * 99) / 100]
+                          << " p99.9=" << latencies[(count * 999) / 1000]
+                          << " max=" << latencies[count - 1] << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        FileLatencyBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
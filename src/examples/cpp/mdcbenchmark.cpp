@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <iostream>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+
+/**
+This program measures the cost of the thread specific diagnostic
+contexts: MDC put, get and remove, and NDC push and pop.  Each
+operation is run on several threads at once, the remove and pop
+cases empty the context on every iteration which is the case
+where the thread specific data may be released and recreated.
+*/
+class MDCBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                int count = 1000000;
+                int threadCount = 4;
+                if (argc >= 2)
+                {
+                        count = atoi(argv[1]);
+                }
+                if (argc >= 3)
+                {
+                        threadCount = atoi(argv[2]);
+                }
+                if (argc > 3 || count <= 0 || threadCount <= 0 || threadCount > MAX_THREADS)
+                {
+                        usage(argv[0]);
+                }
+
+                for (int threads = 1; threads <= threadCount; threads *= 2)
+                {
+                        run(LOG4CXX_STR("MDC put"), mdcPut, count, threads);
+                        run(LOG4CXX_STR("MDC get"), mdcGet, count, threads);
+                        run(LOG4CXX_STR("MDC put/remove"), mdcPutRemove, count, threads);
+                        run(LOG4CXX_STR("NDC push/pop"), ndcPushPop, count, threads);
+                        run(LOG4CXX_STR("nested NDC push/pop"), ndcNestedPushPop, count, threads);
+                }
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [operationCount [threadCount]]" << std::endl;
+                exit(1);
+        }
+
+private:
+        enum { MAX_THREADS = 64 };
+
+        struct Task
+        {
+                int count;
+                int result;
+        };
+
+        static void* LOG4CXX_THREAD_FUNC mdcPut(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                LogString key(LOG4CXX_STR("key"));
+                LogString values[2] = { LOG4CXX_STR("value1"), LOG4CXX_STR("value2") };
+                for (int i = 0; i < task->count; i++)
+                {
+                        MDC::putLS(key, values[i & 1]);
+                }
+                MDC::clear();
+                return 0;
+        }
+
+        static void* LOG4CXX_THREAD_FUNC mdcGet(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                LogString key(LOG4CXX_STR("key"));
+                MDC::putLS(key, LOG4CXX_STR("value"));
+                int handle = MDC::getKey(key);
+                LogString value;
+                for (int i = 0; i < task->count; i++)
+                {
+                        value.erase();
+                        if (MDC::get(handle, value))
+                        {
+                                task->result++;
+                        }
+                }
+                MDC::clear();
+                return 0;
+        }
+
+        static void* LOG4CXX_THREAD_FUNC mdcPutRemove(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                LogString key(LOG4CXX_STR("key"));
+                LogString value(LOG4CXX_STR("value"));
+                LogString previous;
+                for (int i = 0; i < task->count; i++)
+                {
+                        MDC::putLS(key, value);
+                        previous.erase();
+                        if (MDC::remove(key, previous))
+                        {
+                                task->result++;
+                        }
+                }
+                return 0;
+        }
+
+        static void* LOG4CXX_THREAD_FUNC ndcPushPop(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                LogString message(LOG4CXX_STR("request"));
+                for (int i = 0; i < task->count; i++)
+                {
+                        NDC::pushLS(message);
+                        task->result += NDC::pop().length();
+                }
+                return 0;
+        }
+
+        static void* LOG4CXX_THREAD_FUNC ndcNestedPushPop(apr_thread_t* /* thread */, void* data)
+        {
+                Task* task = (Task*) data;
+                LogString message(LOG4CXX_STR("request"));
+                NDC::pushLS(LOG4CXX_STR("session"));
+                for (int i = 0; i < task->count; i++)
+                {
+                        NDC::pushLS(message);
+                        task->result += NDC::pop().length();
+                }
+                NDC::remove();
+                return 0;
+        }
+
+        static void run(const LogString& name, Runnable fn,
+                        int count, int threadCount)
+        {
+                Task tasks[MAX_THREADS];
+                Thread threads[MAX_THREADS];
+                for (int i = 0; i < threadCount; i++)
+                {
+                        tasks[i].count = count / threadCount;
+                        tasks[i].result = 0;
+                }
+
+                apr_time_t start = apr_time_now();
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].run(fn, &tasks[i]);
+                }
+                for (int i = 0; i < threadCount; i++)
+                {
+                        threads[i].join();
+                }
+                apr_time_t elapsed = apr_time_now() - start;
+
+                LOG4CXX_ENCODE_CHAR(nameStr, name);
+                std::cout << nameStr << ", " << threadCount << " thread(s): "
+                          << count << " operations in "
+                          << (elapsed / 1000) << " ms, "
+                          << (elapsed * 1000 / count) << " ns/operation" << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        MDCBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
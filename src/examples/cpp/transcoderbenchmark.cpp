@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/charsetencoder.h>
+#include <log4cxx/helpers/charsetdecoder.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_general.h>
+#include <apr_time.h>
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+
+/**
+This program measures the throughput of the UTF-8, ISO-8859-1 and
+US-ASCII encoders and decoders on typical log messages that are
+pure ASCII, mostly Latin-1 and a mix of Cyrillic and CJK.
+*/
+class TranscoderBenchmark
+{
+public:
+        static void main(int argc, const char * const argv[])
+        {
+                int count = 100000;
+                if (argc >= 2)
+                {
+                        count = atoi(argv[1]);
+                }
+                if (argc > 2 || count <= 0)
+                {
+                        usage(argv[0]);
+                }
+
+                const char* const corpora[][2] = {
+                        { "ascii", "2026-10-19 12:00:00,123 INFO  [main] org.example.OrderService - "
+                                   "Order 4711 accepted for customer 42, total 99.95 EUR\n" },
+                        { "latin-1", "2026-10-19 12:00:00,123 INFO  [main] org.example.OrderService - "
+                                   "Commande accept\xC3\xA9\x65 pour le caf\xC3\xA9 \xC3\xA0 Z\xC3\xBCrich, "
+                                   "total 99,95 \xE2\x82\xAC\n" },
+                        { "cyrillic-cjk", "2026-10-19 12:00:00,123 INFO  [main] org.example.OrderService - "
+                                   "\xD0\x97\xD0\xB0\xD0\xBA\xD0\xB0\xD0\xB7 4711 \xD0\xBF\xD1\x80\xD0\xB8\xD0\xBD\xD1\x8F\xD1\x82 "
+                                   "\xE8\xA8\x82\xE5\x8D\x95\xE5\xB7\xB2\xE6\x8E\xA5\xE5\x8F\x97 "
+                                   "\xE6\xB3\xA8\xE6\x96\x87\xE3\x82\x92\xE5\x8F\x97\xE3\x81\x91\xE4\xBB\x98\xE3\x81\x91\xE3\x81\xBE\xE3\x81\x97\xE3\x81\x9F\n" }
+                };
+                const char* const charsets[] = { "UTF-8", "ISO-8859-1", "US-ASCII" };
+
+                for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++)
+                {
+                        LogString msg;
+                        Transcoder::decodeUTF8(corpora[i][1], msg);
+                        for (size_t j = 0; j < sizeof(charsets) / sizeof(charsets[0]); j++)
+                        {
+                                LogString charset;
+                                Transcoder::decode(charsets[j], charset);
+                                run(corpora[i][0], charsets[j], charset, msg, count);
+                        }
+                }
+        }
+
+        static void usage(const char * programName)
+        {
+                std::cout << "Usage: " << programName <<
+                                " [messageCount]" << std::endl;
+                exit(1);
+        }
+
+private:
+        enum { BUFSIZE = 1024 };
+
+        static void run(const char* corpus, const char* charsetName,
+                        const LogString& charset, const LogString& msg, int count)
+        {
+                CharsetEncoderPtr enc(CharsetEncoder::getEncoder(charset));
+                CharsetDecoderPtr dec(CharsetDecoder::getDecoder(charset));
+                char buf[BUFSIZE];
+                ByteBuffer out(buf, BUFSIZE);
+
+                //
+                //   encode once to get the bytes for the decoder
+                //     and the number of bytes per message
+                //
+                for(LogString::const_iterator iter = msg.begin();
+                    iter != msg.end();)
+                {
+                        CharsetEncoder::encode(enc, msg, iter, out);
+                }
+                out.flip();
+                std::string encoded(out.data(), out.limit());
+
+                apr_time_t start = apr_time_now();
+                for (int i = 0; i < count; i++)
+                {
+                        out.clear();
+                        for(LogString::const_iterator iter = msg.begin();
+                            iter != msg.end();)
+                        {
+                                CharsetEncoder::encode(enc, msg, iter, out);
+                        }
+                }
+                apr_time_t encodeTime = apr_time_now() - start;
+
+                LogString decoded;
+                start = apr_time_now();
+                for (int i = 0; i < count; i++)
+                {
+                        decoded.erase();
+                        ByteBuffer in(&encoded[0], encoded.length());
+                        while (in.remaining() > 0)
+                        {
+                                if (CharsetDecoder::isError(dec->decode(in, decoded)))
+                                {
+                                        decoded.append(1, Transcoder::LOSSCHAR);
+                                        in.position(in.position() + 1);
+                                }
+                        }
+                }
+                apr_time_t decodeTime = apr_time_now() - start;
+
+                double megabytes = (double) encoded.length() * count / (1024 * 1024);
+                std::cout << corpus << " " << charsetName << ": encode "
+                          << megabytes * APR_USEC_PER_SEC / (encodeTime > 0 ? encodeTime : 1)
+                          << " MB/s, decode "
+                          << megabytes * APR_USEC_PER_SEC / (decodeTime > 0 ? decodeTime : 1)
+                          << " MB/s" << std::endl;
+        }
+};
+
+int main(int argc, const char * const argv[])
+{
+    apr_app_initialize(&argc, &argv, NULL);
+    int result = EXIT_SUCCESS;
+    try
+    {
+        TranscoderBenchmark::main(argc, argv);
+    }
+    catch(std::exception&)
+    {
+        result = EXIT_FAILURE;
+    }
+
+    apr_terminate();
+    return result;
+}
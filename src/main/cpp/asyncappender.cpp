@@ -32,6 +32,7 @@
 #include <log4cxx/helpers/stringhelper.h>
 #include <apr_atomic.h>
 #include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/formatbuffer.h>
 
 
 using namespace log4cxx;
@@ -110,11 +111,12 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p) {
 
         // Set the NDC and thread name for the calling thread as these
         // LoggingEvent fields were not set at event creation time.
-        LogString ndcVal;
-        event->getNDC(ndcVal);
+        event->getNDCCopy();
         event->getThreadName();
         // Get a copy of this thread's MDC.
         event->getMDCCopy();
+        // Produce a lazily supplied message on the calling thread.
+        event->getMessage();
 
 
         {
@@ -354,6 +356,7 @@ void* LOG4CXX_THREAD_FUNC AsyncAppender::dispatch(apr_thread_t* /*thread*/, void
                  synchronized sync(pThis->appenders->getMutex());
                  pThis->appenders->appendLoopOnAppenders(*iter, p);
             }
+            FormatBuffer::clearFormatted();
         }
     } catch(InterruptedException& ex) {
             Thread::currentThreadInterrupt();
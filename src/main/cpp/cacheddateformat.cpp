@@ -20,8 +20,14 @@
 
 
 #include <apr_time.h>
+#include <apr_thread_proc.h>
+#include <apr_atomic.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/synchronized.h>
 #include <limits>
+#include <map>
+#include <set>
 #include <log4cxx/helpers/exception.h>
 
 using namespace log4cxx;
@@ -58,6 +64,121 @@ const logchar CachedDateFormat::zeroString[] = { 0x30, 0x30, 0x30, 0 };
 
 #undef min
 
+/**
+ *  Process-wide table of the per-thread caches.  A single thread key
+ *  holds a map from format identifier to cache for each thread, so
+ *  creating formats does not consume thread keys.  A format only
+ *  retires its identifier when destroyed, each thread drops the caches
+ *  of retired formats the next time it allocates one and frees the
+ *  rest when it ends, so neither path touches a destroyed format.
+ */
+class CachedDateFormat::ThreadCacheTable {
+public:
+    typedef std::map<unsigned int, ThreadCache*> CacheMap;
+
+    /**
+     *  Gets the table, which is intentionally never freed so that
+     *  formats destroyed during static destruction can still use it.
+     */
+    static ThreadCacheTable& getInstance() {
+        static ThreadCacheTable* table = new ThreadCacheTable();
+        return *table;
+    }
+
+    unsigned int add() {
+        synchronized sync(mutex);
+        unsigned int id = nextId++;
+        live.insert(id);
+        return id;
+    }
+
+    void remove(unsigned int id) {
+        synchronized sync(mutex);
+        live.erase(id);
+    }
+
+    ThreadCache& get(unsigned int id) {
+        CacheMap& caches = getCaches();
+        CacheMap::const_iterator iter = caches.find(id);
+        if (iter != caches.end()) {
+            return *iter->second;
+        }
+        {
+            synchronized sync(mutex);
+            for(CacheMap::iterator iter = caches.begin();
+                iter != caches.end();) {
+                if (live.find(iter->first) == live.end()) {
+                    delete iter->second;
+                    caches.erase(iter++);
+                } else {
+                    iter++;
+                }
+            }
+        }
+        ThreadCache* cache = new ThreadCache();
+        caches.insert(CacheMap::value_type(id, cache));
+        return *cache;
+    }
+
+private:
+    ThreadCacheTable() : pool(), mutex(pool), key(0), live(), nextId(0)
+#if !APR_HAS_THREADS
+        , noThreadCaches()
+#endif
+    {
+#if APR_HAS_THREADS
+        apr_status_t stat = apr_threadkey_private_create(&key,
+            releaseCaches, pool.getAPRPool());
+        if (stat != APR_SUCCESS) {
+            throw RuntimeException(stat);
+        }
+#endif
+    }
+
+    ThreadCacheTable(const ThreadCacheTable&);
+    ThreadCacheTable& operator=(const ThreadCacheTable&);
+
+    CacheMap& getCaches() {
+#if APR_HAS_THREADS
+        void* caches = 0;
+        apr_threadkey_private_get(&caches, key);
+        if (caches == 0) {
+            caches = new CacheMap();
+            apr_threadkey_private_set(caches, key);
+        }
+        return *((CacheMap*) caches);
+#else
+        return noThreadCaches;
+#endif
+    }
+
+    /**
+     *  Releases a thread's caches when the thread ends.
+     */
+    static void releaseCaches(void* ptr) {
+        CacheMap* caches = (CacheMap*) ptr;
+        for(CacheMap::iterator iter = caches->begin();
+            iter != caches->end();
+            iter++) {
+            delete iter->second;
+        }
+        delete caches;
+    }
+
+    Pool pool;
+    /**
+     *  Guards live and nextId.
+     */
+    Mutex mutex;
+    apr_threadkey_t* key;
+    std::set<unsigned int> live;
+    unsigned int nextId;
+#if !APR_HAS_THREADS
+    CacheMap noThreadCaches;
+#endif
+};
+
+
 /**
  *  Creates a new CachedDateFormat object.
  *  @param dateFormat Date format, may not be null.
@@ -69,17 +190,32 @@ const logchar CachedDateFormat::zeroString[] = { 0x30, 0x30, 0x30, 0 };
 CachedDateFormat::CachedDateFormat(const DateFormatPtr& dateFormat,
         int expiration1) :
        formatter(dateFormat),
-       millisecondStart(0),
-       slotBegin(std::numeric_limits<log4cxx_time_t>::min()),
-       cache(50, 0x20),
        expiration(expiration1),
-       previousTime(std::numeric_limits<log4cxx_time_t>::min()) {
+       generation(0),
+       id(0) {
   if (dateFormat == NULL) {
     throw IllegalArgumentException(LOG4CXX_STR("dateFormat cannot be null"));
   }
   if (expiration1 < 0) {
     throw IllegalArgumentException(LOG4CXX_STR("expiration must be non-negative"));
   }
+  id = ThreadCacheTable::getInstance().add();
+}
+
+CachedDateFormat::~CachedDateFormat() {
+  ThreadCacheTable::getInstance().remove(id);
+}
+
+CachedDateFormat::ThreadCache::ThreadCache() :
+       generation(0),
+       millisecondStart(0),
+       slotBegin(std::numeric_limits<log4cxx_time_t>::min()),
+       cache(50, 0x20),
+       previousTime(std::numeric_limits<log4cxx_time_t>::min()) {
+}
+
+CachedDateFormat::ThreadCache& CachedDateFormat::getThreadCache() const {
+  return ThreadCacheTable::getInstance().get(id);
 }
 
 
@@ -161,6 +297,22 @@ int CachedDateFormat::findMillisecondStart(
  *  @param sbuf the string buffer to write to
  */
  void CachedDateFormat::format(LogString& buf, log4cxx_time_t now, Pool& p) const {
+  ThreadCache& tc = getThreadCache();
+  LogString& cache = tc.cache;
+  int& millisecondStart = tc.millisecondStart;
+  log4cxx_time_t& slotBegin = tc.slotBegin;
+  log4cxx_time_t& previousTime = tc.previousTime;
+
+  //
+  //   If the time zone changed since this thread's cache was filled
+  //      then discard it.
+  //
+  unsigned int currentGeneration = apr_atomic_read32((volatile apr_uint32_t*) &generation);
+  if (tc.generation != currentGeneration) {
+      tc.generation = currentGeneration;
+      previousTime = std::numeric_limits<log4cxx_time_t>::min();
+      slotBegin = std::numeric_limits<log4cxx_time_t>::min();
+  }
 
   //
   // If the current requested time is identical to the previously
@@ -247,8 +399,7 @@ void CachedDateFormat::millisecondFormat(int millis,
  */
 void CachedDateFormat::setTimeZone(const TimeZonePtr& timeZone) {
   formatter->setTimeZone(timeZone);
-  previousTime = std::numeric_limits<log4cxx_time_t>::min();
-  slotBegin = std::numeric_limits<log4cxx_time_t>::min();
+  apr_atomic_inc32((volatile apr_uint32_t*) &generation);
 }
 
 
@@ -273,6 +424,10 @@ int CachedDateFormat::getMaximumCacheValidity(const LogString& pattern) {
    //
    const logchar S = 0x53;
    const logchar SSS[] = { 0x53, 0x53, 0x53, 0 };
+   const logchar NINE_S[] = { 0x53, 0x53, 0x53, 0x53, 0x53, 0x53, 0x53, 0x53, 0x53, 0 };
+   if (pattern.find(NINE_S) != LogString::npos) {
+           return 0;
+   }
    size_t firstS = pattern.find(S);
    size_t len = pattern.length();
    //
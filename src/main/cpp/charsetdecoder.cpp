@@ -30,6 +30,7 @@
 #include <apr_portable.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/singlebytecharset.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -246,10 +247,20 @@ public:
 private:
     virtual log4cxx_status_t decode(ByteBuffer& in,
         LogString& out) {
+        size_t ascii = Transcoder::asciiLength(in.current(), in.remaining());
+        Transcoder::widen(in.current(), ascii, out);
+        in.position(in.position() + ascii);
         if (in.remaining() > 0) {
           std::string tmp(in.current(), in.remaining());
           std::string::const_iterator iter = tmp.begin();
           while(iter != tmp.end()) {
+               size_t offset = iter - tmp.begin();
+               ascii = Transcoder::asciiLength(tmp.data() + offset, tmp.length() - offset);
+               if (ascii > 0) {
+                   Transcoder::widen(tmp.data() + offset, ascii, out);
+                   iter += ascii;
+                   continue;
+               }
                unsigned int sv = Transcoder::decode(tmp, iter);
                if (sv == 0xFFFF) {
                    size_t offset = iter - tmp.begin();
@@ -287,13 +298,24 @@ private:
     virtual log4cxx_status_t decode(ByteBuffer& in,
         LogString& out) {
         if (in.remaining() > 0) {
-
-          const unsigned char* src = (unsigned char*) in.current();
-          const unsigned char* srcEnd = src + in.remaining();
+#if LOG4CXX_LOGCHAR_IS_UTF8
+          const char* src = in.current();
+          const char* srcEnd = src + in.remaining();
           while(src < srcEnd) {
-             unsigned int sv = *(src++);
-             Transcoder::encode(sv, out);
+             size_t ascii = Transcoder::asciiLength(src, srcEnd - src);
+             if (ascii > 0) {
+                Transcoder::widen(src, ascii, out);
+                src += ascii;
+             } else {
+                unsigned int sv = (unsigned char) *(src++);
+                Transcoder::encode(sv, out);
+             }
           }
+#else
+          //
+          //   ISO-8859-1 bytes are the code points
+          Transcoder::widen(in.current(), in.remaining(), out);
+#endif
           in.position(in.limit());
         }
         return APR_SUCCESS;
@@ -307,6 +329,52 @@ private:
 };
 
 
+/**
+*    Converts from a single byte character set to LogString
+*      using the character set's mapping table.
+*
+*/
+class SingleByteCharsetDecoder : public CharsetDecoder
+{
+public:
+    SingleByteCharsetDecoder(const SingleByteCharset& charset1) : charset(charset1) {
+    }
+
+    virtual ~SingleByteCharsetDecoder() {
+    }
+
+private:
+    virtual log4cxx_status_t decode(ByteBuffer& in,
+        LogString& out) {
+        log4cxx_status_t stat = APR_SUCCESS;
+        const char* src = in.current();
+        const char* srcEnd = src + in.remaining();
+        while(src < srcEnd) {
+           size_t ascii = Transcoder::asciiLength(src, srcEnd - src);
+           if (ascii > 0) {
+              Transcoder::widen(src, ascii, out);
+              src += ascii;
+              continue;
+           }
+           unsigned int sv = charset.upper[(unsigned char) *src - 0x80];
+           if (sv == SingleByteCharset::UNDEFINED) {
+              stat = APR_BADARG;
+              break;
+           }
+           src++;
+           Transcoder::encode(sv, out);
+        }
+        in.position(in.position() + (src - in.current()));
+        return stat;
+    }
+
+private:
+        SingleByteCharsetDecoder(const SingleByteCharsetDecoder&);
+        SingleByteCharsetDecoder& operator=(const SingleByteCharsetDecoder&);
+        const SingleByteCharset& charset;
+};
+
+
 /**
 *    Converts from US-ASCII to LogString.
 *
@@ -327,19 +395,12 @@ private:
       log4cxx_status_t stat = APR_SUCCESS;
       if (in.remaining() > 0) {
 
-        const unsigned char* src = (unsigned char*) in.current();
-        const unsigned char* srcEnd = src + in.remaining();
-        while(src < srcEnd) {
-           unsigned char sv = *src;
-           if (sv < 0x80) {
-              src++;
-              Transcoder::encode(sv, out);
-           } else {
-             stat = APR_BADARG;
-             break;
-           }
+        size_t ascii = Transcoder::asciiLength(in.current(), in.remaining());
+        Transcoder::widen(in.current(), ascii, out);
+        if (ascii < in.remaining()) {
+           stat = APR_BADARG;
         }
-        in.position(src - (const unsigned char*) in.data());
+        in.position(in.position() + ascii);
       }
       return stat;
     }
@@ -476,6 +537,10 @@ CharsetDecoderPtr CharsetDecoder::getDecoder(const LogString& charset) {
         StringHelper::equalsIgnoreCase(charset, LOG4CXX_STR("ISO-LATIN-1"), LOG4CXX_STR("iso-latin-1"))) {
         return new ISOLatinCharsetDecoder();
     }
+    const SingleByteCharset* table = SingleByteCharset::forName(charset);
+    if (table != 0) {
+        return new SingleByteCharsetDecoder(*table);
+    }
 #if APR_HAS_XLATE || !defined(_WIN32)
     return new APRCharsetDecoder(charset);
 #else    
@@ -28,6 +28,9 @@
 #include <apr_portable.h>
 #include <log4cxx/helpers/mutex.h>
 #include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/singlebytecharset.h>
+#include <map>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -39,6 +42,28 @@ namespace log4cxx
 
         namespace helpers {
 
+          /**
+          *   Copies the run of ASCII characters at iter
+          *   that fits in out and advances iter past it.
+          *   @return number of characters copied.
+          */
+          static size_t encodeASCII(const LogString& in,
+                LogString::const_iterator& iter,
+                ByteBuffer& out) {
+              size_t offset = iter - in.begin();
+              size_t length = in.length() - offset;
+              if (length > out.remaining()) {
+                  length = out.remaining();
+              }
+              size_t ascii = Transcoder::asciiLength(in.data() + offset, length);
+              if (ascii > 0) {
+                  Transcoder::narrow(in.data() + offset, ascii, out.current());
+                  out.position(out.position() + ascii);
+                  iter += ascii;
+              }
+              return ascii;
+          }
+
 #if APR_HAS_XLATE
           /**
           * A character encoder implemented using apr_xlate.
@@ -194,6 +219,9 @@ namespace log4cxx
                   log4cxx_status_t stat = APR_SUCCESS;
                   if (iter != in.end()) {
                       while(out.remaining() > 0 && iter != in.end()) {
+                          if (encodeASCII(in, iter, out) > 0) {
+                              continue;
+                          }
                           LogString::const_iterator prev(iter);
                           unsigned int sv = Transcoder::decode(in, iter);
                           if (sv <= 0x7F) {
@@ -228,6 +256,9 @@ namespace log4cxx
                   log4cxx_status_t stat = APR_SUCCESS;
                   if (iter != in.end()) {
                       while(out.remaining() > 0 && iter != in.end()) {
+                          if (encodeASCII(in, iter, out) > 0) {
+                              continue;
+                          }
                           LogString::const_iterator prev(iter);
                           unsigned int sv = Transcoder::decode(in, iter);
                           if (sv <= 0xFF) {
@@ -247,6 +278,70 @@ namespace log4cxx
                   ISOLatinCharsetEncoder& operator=(const ISOLatinCharsetEncoder&);
           };
 
+          /**
+          *   Converts a LogString to a single byte character set
+          *   using a reverse of the character set's mapping table.
+          */
+          class SingleByteCharsetEncoder : public CharsetEncoder
+          {
+          public:
+              SingleByteCharsetEncoder(const SingleByteCharset& charset) : pages() {
+                  for(int i = 0; i < 256; i++) {
+                      pageIndex[i] = -1;
+                  }
+                  for(int i = 0; i < 128; i++) {
+                      unsigned int sv = charset.upper[i];
+                      if (sv != SingleByteCharset::UNDEFINED) {
+                          if (pageIndex[sv >> 8] < 0) {
+                              pageIndex[sv >> 8] = (short) (pages.size() / 256);
+                              pages.resize(pages.size() + 256);
+                          }
+                          pages[pageIndex[sv >> 8] * 256 + (sv & 0xFF)] = (unsigned char) (0x80 + i);
+                      }
+                  }
+              }
+
+              virtual log4cxx_status_t encode(const LogString& in,
+                    LogString::const_iterator& iter,
+                    ByteBuffer& out) {
+                  log4cxx_status_t stat = APR_SUCCESS;
+                  while(out.remaining() > 0 && iter != in.end()) {
+                      if (encodeASCII(in, iter, out) > 0) {
+                          continue;
+                      }
+                      LogString::const_iterator prev(iter);
+                      unsigned int sv = Transcoder::decode(in, iter);
+                      //
+                      //   zero marks an unmapped code point,
+                      //      NUL was copied as ASCII
+                      unsigned char b = 0;
+                      if (sv <= 0xFFFF && pageIndex[sv >> 8] >= 0) {
+                          b = pages[pageIndex[sv >> 8] * 256 + (sv & 0xFF)];
+                      }
+                      if (b == 0) {
+                          iter = prev;
+                          stat = APR_BADARG;
+                          break;
+                      }
+                      out.put((char) b);
+                  }
+                  return stat;
+              }
+
+          private:
+                  SingleByteCharsetEncoder(const SingleByteCharsetEncoder&);
+                  SingleByteCharsetEncoder& operator=(const SingleByteCharsetEncoder&);
+                  /**
+                   *  Index into pages for each high byte of a code point,
+                   *  -1 if no code point with that high byte is mapped.
+                   */
+                  short pageIndex[256];
+                  /**
+                   *  Bytes for each low byte of the code point.
+                   */
+                  std::vector<unsigned char> pages;
+          };
+
           /**
           *   Encodes a LogString to a byte array when the encodings are identical.
           */
@@ -274,6 +369,10 @@ namespace log4cxx
                   return APR_SUCCESS;
               }
 
+              virtual bool isIdentity() const {
+                  return true;
+              }
+
           private:
                   TrivialCharsetEncoder(const TrivialCharsetEncoder&);
                   TrivialCharsetEncoder& operator=(const TrivialCharsetEncoder&);
@@ -294,6 +393,9 @@ public:
          LogString::const_iterator& iter,
          ByteBuffer& out) {
          while(iter != in.end() && out.remaining() >= 8) {
+              if (encodeASCII(in, iter, out) > 0) {
+                  continue;
+              }
               unsigned int sv = Transcoder::decode(in, iter);
               if (sv == 0xFFFF) {
                    return APR_BADARG;
@@ -420,6 +522,43 @@ private:
 };
 
 
+          /**
+          *   Process wide cache of stateless encoders by lower case charset
+          *   name, so appenders with the same encoding share one encoder.
+          */
+          class EncoderCache {
+          public:
+              EncoderCache() : pool(), mutex(pool), encoders() {
+              }
+
+              static EncoderCache& getInstance() {
+                  static EncoderCache cache;
+                  return cache;
+              }
+
+              CharsetEncoderPtr get(const LogString& charset) {
+                  synchronized sync(mutex);
+                  EncoderMap::const_iterator iter = encoders.find(charset);
+                  if (iter != encoders.end()) {
+                      return iter->second;
+                  }
+                  return CharsetEncoderPtr();
+              }
+
+              void put(const LogString& charset, const CharsetEncoderPtr& encoder) {
+                  synchronized sync(mutex);
+                  encoders.insert(EncoderMap::value_type(charset, encoder));
+              }
+
+          private:
+              EncoderCache(const EncoderCache&);
+              EncoderCache& operator=(const EncoderCache&);
+              typedef std::map<LogString, CharsetEncoderPtr> EncoderMap;
+              Pool pool;
+              Mutex mutex;
+              EncoderMap encoders;
+          };
+
         } // namespace helpers
 
 }  //namespace log4cxx
@@ -467,6 +606,29 @@ CharsetEncoderPtr CharsetEncoder::getUTF8Encoder() {
 
 
 CharsetEncoderPtr CharsetEncoder::getEncoder(const LogString& charset) {
+    LogString key(StringHelper::toLowerCase(charset));
+    EncoderCache& cache = EncoderCache::getInstance();
+    CharsetEncoderPtr encoder(cache.get(key));
+    if (encoder == 0) {
+        encoder = createEncoder(charset);
+        if (encoder != 0) {
+            cache.put(key, encoder);
+        }
+    }
+    if (encoder != 0) {
+        return encoder;
+    }
+#if APR_HAS_XLATE || !defined(_WIN32)
+    //
+    //   apr_xlate keeps shift state and byte order marks per handle,
+    //      so each caller gets its own
+    return new APRCharsetEncoder(charset);
+#else    
+    throw IllegalArgumentException(charset);
+#endif
+}
+
+CharsetEncoder* CharsetEncoder::createEncoder(const LogString& charset) {
     if (StringHelper::equalsIgnoreCase(charset, LOG4CXX_STR("UTF-8"), LOG4CXX_STR("utf-8"))) {
         return new UTF8CharsetEncoder();
     } else if (StringHelper::equalsIgnoreCase(charset, LOG4CXX_STR("C"), LOG4CXX_STR("c")) ||
@@ -484,20 +646,23 @@ CharsetEncoderPtr CharsetEncoder::getEncoder(const LogString& charset) {
     } else if (StringHelper::equalsIgnoreCase(charset, LOG4CXX_STR("UTF-16LE"), LOG4CXX_STR("utf-16le"))) {
         return new UTF16LECharsetEncoder();
     }
-#if APR_HAS_XLATE || !defined(_WIN32)
-    return new APRCharsetEncoder(charset);
-#else    
-    throw IllegalArgumentException(charset);
-#endif
+    const SingleByteCharset* table = SingleByteCharset::forName(charset);
+    if (table != 0) {
+        return new SingleByteCharsetEncoder(*table);
+    }
+    return 0;
 }
 
-
 void CharsetEncoder::reset() {
 }
 
 void CharsetEncoder::flush(ByteBuffer& /* out */ ) {
 }
 
+bool CharsetEncoder::isIdentity() const {
+    return false;
+}
+
 
 void CharsetEncoder::encode(CharsetEncoderPtr& enc,
     const LogString& src,
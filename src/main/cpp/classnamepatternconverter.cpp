@@ -50,7 +50,6 @@ void ClassNamePatternConverter::format(
    const LoggingEventPtr& event,
    LogString& toAppendTo,
    Pool& /* p */) const {
-    int initialLength = toAppendTo.length();
-    append(toAppendTo, event->getLocationInformation().getClassName());
-    abbreviate(initialLength, toAppendTo);
+    LogString buf;
+    appendAbbreviated(event->getLocationInformation().getClassName(buf), toAppendTo);
   }
@@ -0,0 +1,257 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/clock.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/synchronized.h>
+
+#include <apr_time.h>
+#include <apr_atomic.h>
+#include <time.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define LOG4CXX_HAS_TSC 1
+#include <cpuid.h>
+#else
+#define LOG4CXX_HAS_TSC 0
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(Clock)
+
+namespace log4cxx
+{
+  namespace helpers
+  {
+    namespace ClockImpl
+    {
+      /** Clock based on apr_time_now. */
+      class DefaultClock : public Clock
+      {
+      public:
+        log4cxx_int64_t currentTimeNanos() const
+        {
+          return ((log4cxx_int64_t) apr_time_now()) * 1000;
+        }
+      };
+
+
+      /** Clock based on CLOCK_REALTIME_COARSE. */
+      class CoarseClock : public Clock
+      {
+      public:
+        log4cxx_int64_t currentTimeNanos() const
+        {
+#if defined(CLOCK_REALTIME_COARSE)
+          struct timespec ts;
+          if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+            return ((log4cxx_int64_t) ts.tv_sec) * APR_INT64_C(1000000000) + ts.tv_nsec;
+          }
+#endif
+          return ((log4cxx_int64_t) apr_time_now()) * 1000;
+        }
+      };
+
+
+#if LOG4CXX_HAS_TSC
+      /**
+       * Clock extrapolated from the time stamp counter.  The calibration
+       * is guarded by a sequence number that is odd while it is updated,
+       * readers retry if the sequence number changed while they read.
+       */
+      class TSCClock : public Clock
+      {
+      public:
+        TSCClock() : pool(), mutex(pool), sequence(0),
+           baseTicks(0), baseNanos(0), scale(0), resyncTicks(0),
+           calibrationTicks(0), calibrationNanos(0)
+        {
+          calibrationTicks = readTicks();
+          calibrationNanos = systemTimeNanos();
+          apr_sleep(10000);
+          synchronized sync(mutex);
+          resync(readTicks(), systemTimeNanos());
+        }
+
+        /**
+         * Determines if the processor has a time stamp counter that
+         * runs at a constant rate in all power states.
+         */
+        static bool isAvailable()
+        {
+          unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+          if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0
+              || eax < 0x80000007) {
+            return false;
+          }
+          if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+            return false;
+          }
+          return (edx & (1 << 8)) != 0;
+        }
+
+        log4cxx_int64_t currentTimeNanos() const
+        {
+          log4cxx_int64_t ticks0;
+          log4cxx_int64_t nanos0;
+          log4cxx_int64_t scale0;
+          log4cxx_int64_t limit;
+          apr_uint32_t seq;
+          do {
+            seq = sequence;
+            ticks0 = baseTicks;
+            nanos0 = baseNanos;
+            scale0 = scale;
+            limit = resyncTicks;
+          } while ((seq & 1) != 0 || seq != sequence);
+
+          log4cxx_int64_t ticks = readTicks();
+          log4cxx_int64_t elapsed = ticks - ticks0;
+          if (elapsed >= 0 && elapsed < limit) {
+            return nanos0 + ((elapsed * scale0) >> SHIFT);
+          }
+          log4cxx_int64_t nanos = systemTimeNanos();
+          synchronized sync(mutex);
+          resync(ticks, nanos);
+          return nanos;
+        }
+
+      private:
+        /**
+         *  Fixed point position of the nanoseconds per tick.
+         */
+        enum { SHIFT = 24 };
+
+        static log4cxx_int64_t readTicks()
+        {
+          unsigned int lo, hi;
+          __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+          return (log4cxx_int64_t) ((((apr_uint64_t) hi) << 32) | lo);
+        }
+
+        static log4cxx_int64_t systemTimeNanos()
+        {
+#if defined(CLOCK_REALTIME)
+          struct timespec ts;
+          if (clock_gettime(CLOCK_REALTIME, &ts) == 0) {
+            return ((log4cxx_int64_t) ts.tv_sec) * APR_INT64_C(1000000000) + ts.tv_nsec;
+          }
+#endif
+          return ((log4cxx_int64_t) apr_time_now()) * 1000;
+        }
+
+        /**
+         *  Sets the base to the specified reading of the counter and system
+         *  clock and, if enough time has elapsed for an accurate measurement,
+         *  recalibrates the rate.  Must be called while holding the mutex.
+         */
+        void resync(log4cxx_int64_t ticks, log4cxx_int64_t nanos) const
+        {
+          const log4cxx_int64_t nanosPerSecond = APR_INT64_C(1000000000);
+          log4cxx_int64_t elapsedTicks = ticks - calibrationTicks;
+          log4cxx_int64_t elapsedNanos = nanos - calibrationNanos;
+          log4cxx_int64_t newScale = scale;
+          if (elapsedTicks > 0 && elapsedNanos >= nanosPerSecond / 100
+              && elapsedNanos < (APR_INT64_C(1) << (62 - SHIFT))) {
+            newScale = (elapsedNanos << SHIFT) / elapsedTicks;
+            calibrationTicks = ticks;
+            calibrationNanos = nanos;
+          } else if (elapsedNanos < 0 || elapsedNanos >= (APR_INT64_C(1) << (62 - SHIFT))) {
+            calibrationTicks = ticks;
+            calibrationNanos = nanos;
+          }
+          if (newScale <= 0) {
+            newScale = APR_INT64_C(1) << SHIFT;
+          }
+
+          apr_atomic_inc32(&sequence);
+          baseTicks = ticks;
+          baseNanos = nanos;
+          scale = newScale;
+          resyncTicks = (nanosPerSecond << SHIFT) / newScale;
+          apr_atomic_inc32(&sequence);
+        }
+
+        Pool pool;
+        Mutex mutex;
+        mutable volatile apr_uint32_t sequence;
+        mutable volatile log4cxx_int64_t baseTicks;
+        mutable volatile log4cxx_int64_t baseNanos;
+        mutable volatile log4cxx_int64_t scale;
+        mutable volatile log4cxx_int64_t resyncTicks;
+        mutable log4cxx_int64_t calibrationTicks;
+        mutable log4cxx_int64_t calibrationNanos;
+      };
+#endif
+    }
+  }
+}
+
+
+Clock::Clock() {
+}
+
+Clock::~Clock() {
+}
+
+const ClockPtr& Clock::getDefault() {
+  static ClockPtr clock(new ClockImpl::DefaultClock());
+  return clock;
+}
+
+const ClockPtr& Clock::getCoarse() {
+#if defined(CLOCK_REALTIME_COARSE)
+  static ClockPtr clock(new ClockImpl::CoarseClock());
+  return clock;
+#else
+  return getDefault();
+#endif
+}
+
+const ClockPtr& Clock::getTSC() {
+#if LOG4CXX_HAS_TSC
+  if (ClockImpl::TSCClock::isAvailable()) {
+     static ClockPtr clock(new ClockImpl::TSCClock());
+     return clock;
+  }
+#endif
+  return getDefault();
+}
+
+ClockPtr Clock::getClock(const LogString& name, const ClockPtr& defaultClock) {
+  if (StringHelper::equalsIgnoreCase(name,
+        LOG4CXX_STR("DEFAULT"), LOG4CXX_STR("default"))) {
+    return getDefault();
+  }
+  if (StringHelper::equalsIgnoreCase(name,
+        LOG4CXX_STR("COARSE"), LOG4CXX_STR("coarse"))) {
+    return getCoarse();
+  }
+  if (StringHelper::equalsIgnoreCase(name,
+        LOG4CXX_STR("TSC"), LOG4CXX_STR("tsc"))) {
+    return getTSC();
+  }
+  return defaultClock;
+}
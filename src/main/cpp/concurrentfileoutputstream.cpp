@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/concurrentfileoutputstream.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#include <apr_atomic.h>
+#include <apr_thread_proc.h>
+#if !defined(LOG4CXX)
+#define LOG4CXX 1
+#endif
+#include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#if LOG4CXX_HAS_PWRITE
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(ConcurrentFileOutputStream)
+
+ConcurrentFileOutputStream::ConcurrentFileOutputStream(const LogString& filename,
+    bool append) : pool(), mutex(pool), fileptr(0), fd(-1),
+    offset(0), activeWrites(0), closing(0) {
+#if LOG4CXX_HAS_PWRITE
+    //
+    //   not opened with APR_APPEND since positional writes
+    //      ignore the offset on some platforms for such files
+    apr_int32_t flags = APR_WRITE | APR_CREATE;
+    if (!append) {
+        flags |= APR_TRUNCATE;
+    }
+    File fn;
+    fn.setPath(filename);
+    apr_status_t stat = fn.open(&fileptr, flags, APR_OS_DEFAULT, pool);
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+    apr_os_file_t osfile;
+    stat = apr_os_file_get(&osfile, fileptr);
+    apr_off_t end = 0;
+    if (stat == APR_SUCCESS && append) {
+        stat = apr_file_seek(fileptr, APR_END, &end);
+    }
+    if (stat != APR_SUCCESS) {
+        apr_file_close(fileptr);
+        throw IOException(stat);
+    }
+    fd = osfile;
+    offset = end;
+#else
+    throw IOException(APR_ENOTIMPL);
+#endif
+}
+
+ConcurrentFileOutputStream::~ConcurrentFileOutputStream() {
+  if (fileptr != NULL && !APRInitializer::isDestructed) {
+    apr_file_close(fileptr);
+  }
+}
+
+bool ConcurrentFileOutputStream::isSupported() {
+#if LOG4CXX_HAS_PWRITE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ConcurrentFileOutputStream::close(Pool& /* p */) {
+  if (apr_atomic_cas32((apr_uint32_t*) &closing, 1, 0) != 0) {
+    return;
+  }
+  //
+  //   wait for writes that reserved a range before closing
+  while(apr_atomic_read32((apr_uint32_t*) &activeWrites) != 0) {
+    apr_thread_yield();
+  }
+  if (fileptr != NULL) {
+    apr_status_t stat = apr_file_close(fileptr);
+    fileptr = NULL;
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+  }
+}
+
+void ConcurrentFileOutputStream::flush(Pool& /* p */) {
+}
+
+void ConcurrentFileOutputStream::sync(Pool& /* p */) {
+  if (fileptr == NULL) {
+     throw IOException(-1);
+  }
+  FileOutputStream::datasync(fileptr);
+}
+
+log4cxx_int64_t ConcurrentFileOutputStream::reserve(size_t length) {
+#if defined(__GNUC__)
+  return __sync_fetch_and_add(&offset, (log4cxx_int64_t) length);
+#else
+  synchronized sync(mutex);
+  log4cxx_int64_t start = offset;
+  offset += length;
+  return start;
+#endif
+}
+
+void ConcurrentFileOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
+  size_t nbytes = buf.remaining();
+  if (nbytes == 0) {
+     return;
+  }
+  apr_atomic_inc32((apr_uint32_t*) &activeWrites);
+  if (apr_atomic_read32((apr_uint32_t*) &closing) != 0) {
+     apr_atomic_dec32((apr_uint32_t*) &activeWrites);
+     throw IOException(-1);
+  }
+#if LOG4CXX_HAS_PWRITE
+  log4cxx_int64_t pos = reserve(nbytes);
+  const char* data = buf.current();
+  while(nbytes > 0) {
+    ssize_t written = ::pwrite(fd, data, nbytes, (off_t) pos);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      apr_status_t stat = APR_FROM_OS_ERROR(errno);
+      apr_atomic_dec32((apr_uint32_t*) &activeWrites);
+      throw IOException(stat);
+    }
+    data += written;
+    pos += written;
+    nbytes -= written;
+  }
+#endif
+  apr_atomic_dec32((apr_uint32_t*) &activeWrites);
+  buf.position(buf.limit());
+}
@@ -68,3 +68,24 @@ void Condition::await(Mutex& mutex)
 #endif
 }
 
+bool Condition::await(Mutex& mutex, int millis)
+{
+#if APR_HAS_THREADS
+        if (Thread::interrupted()) {
+             throw InterruptedException();
+        }
+        apr_status_t stat = apr_thread_cond_timedwait(
+             condition,
+             mutex.getAPRMutex(),
+             ((apr_interval_time_t) millis) * 1000);
+        if (APR_STATUS_IS_TIMEUP(stat)) {
+                return false;
+        }
+        if (stat != APR_SUCCESS) {
+                throw InterruptedException(stat);
+        }
+        return true;
+#else
+        return false;
+#endif
+}
@@ -20,6 +20,8 @@
 #include <log4cxx/helpers/systemoutwriter.h>
 #include <log4cxx/helpers/systemerrwriter.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/optionconverter.h>
+#include <log4cxx/helpers/synchronized.h>
 #include <log4cxx/layout.h>
 
 using namespace log4cxx;
@@ -27,13 +29,53 @@ using namespace log4cxx::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT(ConsoleAppender)
 
+namespace {
+/**
+ * Writer that marks each string written as one event of
+ * a console stream, so the stream keeps or drops it whole
+ * even when the encoder writes it in several pieces.
+ */
+class ConsoleEventWriter : public Writer {
+public:
+  ConsoleEventWriter(const WriterPtr& writer1,
+      const ConsoleOutputStreamPtr& stream1) :
+      writer(writer1), stream(stream1) {
+  }
+
+  void close(Pool& p) {
+    writer->close(p);
+  }
+
+  void flush(Pool& p) {
+    writer->flush(p);
+  }
+
+  void write(const LogString& str, Pool& p) {
+    stream->beginEvent();
+    try {
+      writer->write(str, p);
+    } catch(...) {
+      stream->endEvent();
+      throw;
+    }
+    stream->endEvent();
+  }
+
+private:
+  WriterPtr writer;
+  ConsoleOutputStreamPtr stream;
+};
+}
+
 ConsoleAppender::ConsoleAppender()
- : target(getSystemOut())
+ : target(getSystemOut()), directWrite(false), nonBlocking(false),
+   bufferSize(256 * 1024), stream()
 {
 }
 
 ConsoleAppender::ConsoleAppender(const LayoutPtr& layout1)
- :target(getSystemOut())
+ :target(getSystemOut()), directWrite(false), nonBlocking(false),
+  bufferSize(256 * 1024), stream()
 {
     setLayout(layout1);
     Pool p;
@@ -43,7 +85,8 @@ ConsoleAppender::ConsoleAppender(const LayoutPtr& layout1)
 }
 
 ConsoleAppender::ConsoleAppender(const LayoutPtr& layout1, const LogString& target1)
- : target(target1)
+ : target(target1), directWrite(false), nonBlocking(false),
+   bufferSize(256 * 1024), stream()
 {
       setLayout(layout1);
       Pool p;
@@ -97,19 +140,62 @@ void ConsoleAppender::targetWarn(const LogString& val)
         LogLog::warn(LOG4CXX_STR("Using previously set target, System.out by default."));
 }
 
+void ConsoleAppender::setDirectWrite(bool value)
+{
+        synchronized sync(mutex);
+        directWrite = value;
+}
+
+void ConsoleAppender::setNonBlocking(bool value)
+{
+        synchronized sync(mutex);
+        nonBlocking = value;
+}
+
+void ConsoleAppender::setBufferSize(int bufferSize1)
+{
+        synchronized sync(mutex);
+        bufferSize = bufferSize1;
+}
+
+unsigned int ConsoleAppender::getDroppedCount() const
+{
+        synchronized sync(mutex);
+        return stream == 0 ? 0 : stream->getDropped();
+}
+
 void ConsoleAppender::activateOptions(Pool& p)
 {
-        if(StringHelper::equalsIgnoreCase(target,
-              LOG4CXX_STR("SYSTEM.OUT"), LOG4CXX_STR("system.out")))
+        bool out = StringHelper::equalsIgnoreCase(target,
+              LOG4CXX_STR("SYSTEM.OUT"), LOG4CXX_STR("system.out"));
+        bool err = StringHelper::equalsIgnoreCase(target,
+              LOG4CXX_STR("SYSTEM.ERR"), LOG4CXX_STR("system.err"));
+        if ((out || err) && (directWrite || nonBlocking))
+        {
+                ConsoleOutputStreamPtr newStream(new ConsoleOutputStream(err,
+                      nonBlocking && bufferSize > 0 ? bufferSize : 0));
+                OutputStreamPtr os(newStream);
+                WriterPtr writer1(createWriter(os));
+                if (nonBlocking && bufferSize > 0) {
+                    writer1 = new ConsoleEventWriter(writer1, newStream);
+                }
+                setWriter(writer1);
+                synchronized sync(mutex);
+                stream = newStream;
+        }
+        else if(out)
         {
                 WriterPtr writer1(new SystemOutWriter());
                 setWriter(writer1);
+                synchronized sync(mutex);
+                stream = 0;
         }
-        else if (StringHelper::equalsIgnoreCase(target,
-              LOG4CXX_STR("SYSTEM.ERR"), LOG4CXX_STR("system.err")))
+        else if (err)
         {
               WriterPtr writer1(new SystemErrWriter());
               setWriter(writer1);
+              synchronized sync(mutex);
+              stream = 0;
         }
         WriterAppender::activateOptions(p);
 }
@@ -121,6 +207,21 @@ void ConsoleAppender::setOption(const LogString& option, const LogString& value)
         {
                 setTarget(value);
         }
+        else if (StringHelper::equalsIgnoreCase(option,
+              LOG4CXX_STR("DIRECTWRITE"), LOG4CXX_STR("directwrite")))
+        {
+                setDirectWrite(OptionConverter::toBoolean(value, false));
+        }
+        else if (StringHelper::equalsIgnoreCase(option,
+              LOG4CXX_STR("NONBLOCKING"), LOG4CXX_STR("nonblocking")))
+        {
+                setNonBlocking(OptionConverter::toBoolean(value, false));
+        }
+        else if (StringHelper::equalsIgnoreCase(option,
+              LOG4CXX_STR("BUFFERSIZE"), LOG4CXX_STR("buffersize")))
+        {
+                setBufferSize((int) OptionConverter::toFileSize(value, 256 * 1024));
+        }
         else
         {
                 WriterAppender::setOption(option, value);
@@ -0,0 +1,285 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/consoleoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/loglog.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#include <apr_atomic.h>
+#include <apr_thread_proc.h>
+#include <stdio.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#endif
+#if !defined(PIPE_BUF)
+#define PIPE_BUF 512
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(ConsoleOutputStream)
+
+ConsoleOutputStream::ConsoleOutputStream(bool err, size_t bufferSize1)
+    : pool(), file(0), fd(-1), bufferSize(bufferSize1),
+      mutex(pool), bufferNotEmpty(pool),
+      front(), back(), pending(), inEvent(false), eventDropped(false),
+      dropped(0), closed(false), thread() {
+    //
+    //   output already in the stdio buffer goes first
+    fflush(err ? stderr : stdout);
+    apr_status_t stat = err ?
+        apr_file_open_stderr(&file, pool.getAPRPool()) :
+        apr_file_open_stdout(&file, pool.getAPRPool());
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+#if !defined(_WIN32)
+    apr_os_file_t osfile;
+    if (apr_os_file_get(&osfile, file) == APR_SUCCESS) {
+        fd = osfile;
+    }
+#endif
+#if APR_HAS_THREADS
+    if (bufferSize > 0) {
+        front.reserve(bufferSize);
+        back.reserve(bufferSize);
+        thread.run(writer, this);
+    }
+#else
+    bufferSize = 0;
+#endif
+}
+
+ConsoleOutputStream::~ConsoleOutputStream() {
+    try {
+        Pool p;
+        close(p);
+    } catch(std::exception&) {
+    }
+}
+
+void ConsoleOutputStream::close(Pool& /* p */ ) {
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            return;
+        }
+        closed = true;
+        bufferNotEmpty.signalAll();
+    }
+#if APR_HAS_THREADS
+    //
+    //   the background thread gives up waiting on a stalled
+    //      console CLOSE_MILLIS after close, so joining is bounded
+    if (bufferSize > 0) {
+        try {
+            thread.join();
+        } catch(InterruptedException& e) {
+            Thread::currentThreadInterrupt();
+            LogLog::error(LOG4CXX_STR("Got an InterruptedException while waiting for the console writer to finish,"), e);
+        }
+    }
+#endif
+    //
+    //   the descriptor belongs to the process, so it is left open
+}
+
+void ConsoleOutputStream::flush(Pool& /* p */ ) {
+    //
+    //   writes are unbuffered and the background thread
+    //      writes as soon as output arrives, waiting here
+    //      would let a stalled console block the caller
+}
+
+void ConsoleOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
+    if (bufferSize == 0) {
+        writeFully(buf.current(), buf.remaining());
+        buf.position(buf.limit());
+        return;
+    }
+    if (inEvent) {
+        //
+        //   the event is kept whole until endEvent
+        //      or dropped whole once it cannot fit
+        if (!eventDropped) {
+            if (pending.size() + buf.remaining() > bufferSize) {
+                eventDropped = true;
+                pending.clear();
+            } else {
+                pending.insert(pending.end(), buf.current(), buf.current() + buf.remaining());
+            }
+        }
+    } else {
+        enqueue(buf.current(), buf.remaining());
+    }
+    buf.position(buf.limit());
+}
+
+void ConsoleOutputStream::beginEvent() {
+    if (bufferSize > 0) {
+        inEvent = true;
+        eventDropped = false;
+        pending.clear();
+    }
+}
+
+void ConsoleOutputStream::endEvent() {
+    if (!inEvent) {
+        return;
+    }
+    inEvent = false;
+    if (eventDropped) {
+        apr_atomic_inc32((apr_uint32_t*) &dropped);
+    } else if (!pending.empty()) {
+        enqueue(&pending[0], pending.size());
+    }
+    pending.clear();
+}
+
+/**
+ *  Appends bytes to the buffer of the background thread
+ *  or counts them as one dropped event if they do not fit.
+ */
+void ConsoleOutputStream::enqueue(const char* data, size_t length) {
+    synchronized sync(mutex);
+    if (closed) {
+        throw IOException(-1);
+    }
+    if (front.size() + length > bufferSize) {
+        apr_atomic_inc32((apr_uint32_t*) &dropped);
+    } else {
+        if (front.empty()) {
+            bufferNotEmpty.signalAll();
+        }
+        front.insert(front.end(), data, data + length);
+    }
+}
+
+unsigned int ConsoleOutputStream::getDropped() const {
+    return apr_atomic_read32((apr_uint32_t*) &dropped);
+}
+
+void ConsoleOutputStream::writeFully(const char* data, size_t length) {
+    while(length > 0) {
+        apr_size_t nbytes = length;
+        apr_status_t stat = apr_file_write(file, data, &nbytes);
+        if (stat != APR_SUCCESS) {
+            throw IOException(stat);
+        }
+        data += nbytes;
+        length -= nbytes;
+    }
+}
+
+/**
+ *  Writes from the background thread, waiting for the console in
+ *  slices of POLL_MILLIS.  Writes of at most PIPE_BUF bytes
+ *  once the descriptor is writable do not block on a pipe.
+ *  @return false once the console has kept this waiting
+ *  for CLOSE_MILLIS after close.
+ */
+bool ConsoleOutputStream::writeBounded(const char* data, size_t length) {
+#if !defined(_WIN32)
+    if (fd >= 0) {
+        int waited = 0;
+        while(length > 0) {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            int ready = poll(&pfd, 1, POLL_MILLIS);
+            if (ready < 0 && errno != EINTR) {
+                throw IOException(APR_FROM_OS_ERROR(errno));
+            }
+            if (ready == 0) {
+                synchronized sync(mutex);
+                if (closed) {
+                    waited += POLL_MILLIS;
+                    if (waited >= CLOSE_MILLIS) {
+                        return false;
+                    }
+                }
+            }
+            if (ready <= 0) {
+                continue;
+            }
+            size_t count = length < PIPE_BUF ? length : PIPE_BUF;
+            ssize_t nbytes = ::write(fd, data, count);
+            if (nbytes < 0) {
+                if (errno == EINTR || errno == EAGAIN) {
+                    continue;
+                }
+                throw IOException(APR_FROM_OS_ERROR(errno));
+            }
+            data += nbytes;
+            length -= nbytes;
+        }
+        return true;
+    }
+#endif
+    writeFully(data, length);
+    return true;
+}
+
+void* LOG4CXX_THREAD_FUNC ConsoleOutputStream::writer(apr_thread_t* /* thread */, void* data) {
+    ConsoleOutputStream* pThis = (ConsoleOutputStream*) data;
+    bool isActive = true;
+    try {
+        while(isActive) {
+            {
+                synchronized sync(pThis->mutex);
+                while(!pThis->closed && pThis->front.empty()) {
+                    pThis->bufferNotEmpty.await(pThis->mutex);
+                }
+                //
+                //   everything written since the last pass
+                //      goes out in one call
+                pThis->front.swap(pThis->back);
+                isActive = !pThis->closed;
+            }
+            //
+            //   LogLog writes to stderr through stdio, which may be
+            //      the stalled console, so failures are not reported
+            //      from this thread and drops only through getDropped
+            if (!pThis->back.empty()) {
+                try {
+                    if (!pThis->writeBounded(&pThis->back[0], pThis->back.size())) {
+                        isActive = false;
+                    }
+                } catch(IOException&) {
+                }
+                pThis->back.clear();
+            }
+        }
+    } catch(InterruptedException&) {
+        Thread::currentThreadInterrupt();
+    } catch(...) {
+    }
+    return 0;
+}
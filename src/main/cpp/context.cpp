@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/context.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+Context::Context() : mdc(0), ndc(0) {
+    ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
+    if (data != 0) {
+        mdc = data->getMDCSnapshot();
+        ndc = data->getNDCSnapshot();
+    }
+}
+
+Context::Context(const Context& src) : mdc(src.mdc), ndc(src.ndc) {
+    if (mdc != 0) {
+        mdc->addRef();
+    }
+    if (ndc != 0) {
+        ndc->addRef();
+    }
+}
+
+Context& Context::operator=(const Context& src) {
+    if (src.mdc != 0) {
+        src.mdc->addRef();
+    }
+    if (src.ndc != 0) {
+        src.ndc->addRef();
+    }
+    if (mdc != 0) {
+        mdc->releaseRef();
+    }
+    if (ndc != 0) {
+        ndc->releaseRef();
+    }
+    mdc = src.mdc;
+    ndc = src.ndc;
+    return *this;
+}
+
+Context::~Context() {
+    if (mdc != 0) {
+        mdc->releaseRef();
+    }
+    if (ndc != 0) {
+        ndc->releaseRef();
+    }
+}
+
+void Context::install() const {
+    ThreadSpecificData::install(mdc, ndc);
+}
+
+Context::Scope::Scope(const Context& context) : previous() {
+    context.install();
+}
+
+Context::Scope::~Scope() {
+    previous.install();
+}
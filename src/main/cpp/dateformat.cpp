@@ -27,6 +27,14 @@ IMPLEMENT_LOG4CXX_OBJECT(DateFormat)
 
 DateFormat::~DateFormat() {}
 
+void DateFormat::formatNanos(LogString& s, log4cxx_int64_t nanos, Pool& p) const {
+    log4cxx_time_t micros = nanos / 1000;
+    if (micros * 1000 > nanos) {
+        micros--;
+    }
+    format(s, micros, p);
+}
+
 void DateFormat::setTimeZone(const TimeZonePtr&) {}
 
 void DateFormat::numberFormat(LogString& s, int n, Pool& p) const {
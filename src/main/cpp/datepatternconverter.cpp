@@ -101,7 +101,7 @@ void DatePatternConverter::format(
   const LoggingEventPtr& event,
   LogString& toAppendTo,
   Pool& p) const {
-   df->format(toAppendTo, event->getTimeStamp(), p);
+   df->formatNanos(toAppendTo, event->getTimeStampNanos(), p);
  }
 
   /**
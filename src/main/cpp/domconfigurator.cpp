@@ -101,6 +101,7 @@ IMPLEMENT_LOG4CXX_OBJECT(DOMConfigurator)
 #define ADDITIVITY_ATTR "additivity"
 #define THRESHOLD_ATTR "threshold"
 #define CONFIG_DEBUG_ATTR "configDebug"
+#define CLOCK_ATTR "clock"
 #define INTERNAL_DEBUG_ATTR "debug"
 
 DOMConfigurator::DOMConfigurator()
@@ -914,6 +915,13 @@ void DOMConfigurator::parse(
                 repository->setThreshold(thresholdStr);
     }
 
+    LogString clockStr = subst(getAttribute(utf8Decoder, element, CLOCK_ATTR));
+    if(!clockStr.empty() && clockStr != NuLL)
+        {
+                LogLog::debug(LOG4CXX_STR("Clock =\"") + clockStr + LOG4CXX_STR("\"."));
+                repository->setClock(Clock::getClock(clockStr, repository->getClock()));
+    }
+
     apr_xml_elem* currentElement;
     for(currentElement = element->first_child;
         currentElement;
@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/doublebufferedoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/loglog.h>
+#include <apr_thread_proc.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(DoubleBufferedOutputStream)
+
+DoubleBufferedOutputStream::DoubleBufferedOutputStream(OutputStreamPtr& out1,
+    size_t bufferSize1, int flushIntervalMillis1)
+    : pool(), out(out1),
+      bufferSize(bufferSize1 > 0 ? bufferSize1 : 1),
+      flushIntervalMillis(flushIntervalMillis1),
+      mutex(pool), writeMutex(pool),
+      bufferFull(pool), bufferSwapped(pool),
+      front(), back(), closed(false), thread() {
+    if (out1 == 0) {
+       throw NullPointerException(LOG4CXX_STR("out parameter may not be null."));
+    }
+    front.reserve(bufferSize);
+    back.reserve(bufferSize);
+#if APR_HAS_THREADS
+    thread.run(flusher, this);
+#endif
+}
+
+DoubleBufferedOutputStream::~DoubleBufferedOutputStream() {
+    try {
+        Pool p;
+        close(p);
+    } catch(std::exception&) {
+    }
+}
+
+void DoubleBufferedOutputStream::close(Pool& p) {
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            return;
+        }
+        closed = true;
+        bufferFull.signalAll();
+        bufferSwapped.signalAll();
+    }
+#if APR_HAS_THREADS
+    try {
+        thread.join();
+    } catch(InterruptedException& e) {
+        Thread::currentThreadInterrupt();
+        LogLog::error(LOG4CXX_STR("Got an InterruptedException while waiting for the flusher to finish,"), e);
+    }
+#endif
+    {
+        synchronized sync(writeMutex);
+        writeBuffer(p);
+    }
+    out->close(p);
+}
+
+void DoubleBufferedOutputStream::flush(Pool& p) {
+    synchronized sync(writeMutex);
+    writeBuffer(p);
+    out->flush(p);
+}
+
+#if APR_HAS_THREADS
+void DoubleBufferedOutputStream::write(ByteBuffer& buf, Pool& /* p */) {
+#else
+void DoubleBufferedOutputStream::write(ByteBuffer& buf, Pool& p) {
+#endif
+    bool full = false;
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            throw IOException(-1);
+        }
+#if APR_HAS_THREADS
+        //
+        //   wait for the flusher thread to catch up
+        //      rather than growing the buffer without limit
+        while(!closed && front.size() >= MAX_BUFFERS * bufferSize) {
+            bufferSwapped.await(mutex);
+        }
+        if (closed) {
+            throw IOException(-1);
+        }
+#endif
+        front.insert(front.end(), buf.current(), buf.current() + buf.remaining());
+        buf.position(buf.limit());
+        full = front.size() >= bufferSize;
+        if (full) {
+            bufferFull.signalAll();
+        }
+    }
+#if !APR_HAS_THREADS
+    if (full) {
+        flush(p);
+    }
+#endif
+}
+
+/**
+ *  Swaps the buffers and writes the bytes collected so far,
+ *  the caller must hold writeMutex.
+ */
+void DoubleBufferedOutputStream::writeBuffer(Pool& p) {
+    {
+        synchronized sync(mutex);
+        front.swap(back);
+        bufferSwapped.signalAll();
+    }
+    if (!back.empty()) {
+        ByteBuffer buf(&back[0], back.size());
+        try {
+            out->write(buf, p);
+        } catch(...) {
+            back.clear();
+            throw;
+        }
+        back.clear();
+    }
+}
+
+void* LOG4CXX_THREAD_FUNC DoubleBufferedOutputStream::flusher(apr_thread_t* /* thread */, void* data) {
+    DoubleBufferedOutputStream* pThis = (DoubleBufferedOutputStream*) data;
+    Pool p;
+    bool isActive = true;
+    try {
+        while(isActive) {
+            {
+                synchronized sync(pThis->mutex);
+                if (!pThis->closed && pThis->front.size() < pThis->bufferSize) {
+                    if (pThis->flushIntervalMillis > 0) {
+                        pThis->bufferFull.await(pThis->mutex, pThis->flushIntervalMillis);
+                    } else {
+                        pThis->bufferFull.await(pThis->mutex);
+                    }
+                }
+                isActive = !pThis->closed;
+            }
+            if (isActive) {
+                try {
+                    synchronized sync(pThis->writeMutex);
+                    pThis->writeBuffer(p);
+                } catch(IOException& e) {
+                    LogLog::error(LOG4CXX_STR("Unable to write buffered output,"), e);
+                }
+            }
+        }
+    } catch(InterruptedException& ex) {
+        Thread::currentThreadInterrupt();
+    } catch(...) {
+    }
+    return 0;
+}
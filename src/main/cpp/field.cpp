@@ -0,0 +1,198 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/spi/field.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <apr_strings.h>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
+
+Field::Field(const std::string& key1, Type type1)
+    : key(), type(type1), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = 0;
+}
+
+Field::Field(const std::string& key1, int val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = val;
+}
+
+Field::Field(const std::string& key1, unsigned int val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = val;
+}
+
+Field::Field(const std::string& key1, long val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = val;
+}
+
+Field::Field(const std::string& key1, unsigned long val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = (log4cxx_int64_t) val;
+}
+
+Field::Field(const std::string& key1, log4cxx_int64_t val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = val;
+}
+
+Field::Field(const std::string& key1, unsigned long long val)
+    : key(), type(INT64), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = (log4cxx_int64_t) val;
+}
+
+Field::Field(const std::string& key1, double val)
+    : key(), type(DOUBLE), text(), data() {
+    Transcoder::decode(key1, key);
+    value.dbl = val;
+}
+
+Field::Field(const std::string& key1, bool val)
+    : key(), type(BOOLEAN), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = 0;
+    value.boolean = val;
+}
+
+Field::Field(const std::string& key1, const char* val)
+    : key(), type(STRING), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = 0;
+    Transcoder::decode(val, text);
+}
+
+Field::Field(const std::string& key1, const std::string& val)
+    : key(), type(STRING), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = 0;
+    Transcoder::decode(val, text);
+}
+
+#if LOG4CXX_WCHAR_T_API
+Field::Field(const std::string& key1, const std::wstring& val)
+    : key(), type(STRING), text(), data() {
+    Transcoder::decode(key1, key);
+    value.int64 = 0;
+    Transcoder::decode(val, text);
+}
+#endif
+
+Field Field::bytes(const std::string& key, const void* bytes, size_t length) {
+    Field field(key, BYTES);
+    field.data.assign((const char*) bytes, length);
+    return field;
+}
+
+const logchar* Field::getTypeName() const {
+    switch(type) {
+        case INT64:
+        return LOG4CXX_STR("long");
+
+        case DOUBLE:
+        return LOG4CXX_STR("double");
+
+        case BOOLEAN:
+        return LOG4CXX_STR("boolean");
+
+        case BYTES:
+        return LOG4CXX_STR("bytes");
+
+        default:
+        break;
+    }
+    return LOG4CXX_STR("string");
+}
+
+void Field::format(LogString& dest) const {
+    switch(type) {
+        case INT64:
+        {
+            //
+            //   digits are produced from the least significant end,
+            //      negative values are handled in the negative range
+            //      so the smallest value does not overflow
+            logchar digits[21];
+            logchar* end = digits + sizeof(digits)/sizeof(digits[0]);
+            logchar* start = end;
+            log4cxx_int64_t remain = value.int64;
+            do {
+                int digit = (int) (remain % 10);
+                if (digit < 0) digit = -digit;
+                *(--start) = (logchar) (0x30 + digit);
+                remain /= 10;
+            } while(remain != 0);
+            if (value.int64 < 0) {
+                *(--start) = (logchar) 0x2D; // '-'
+            }
+            dest.append(start, end);
+        }
+        break;
+
+        case DOUBLE:
+        {
+            //
+            //   use the shorter representation unless it
+            //      does not read back as the same value
+            char buf[32];
+            apr_snprintf(buf, sizeof(buf), "%.15g", value.dbl);
+            if (strtod(buf, 0) != value.dbl) {
+                apr_snprintf(buf, sizeof(buf), "%.17g", value.dbl);
+            }
+            Transcoder::decode(buf, dest);
+        }
+        break;
+
+        case BOOLEAN:
+        dest.append(value.boolean ? LOG4CXX_STR("true") : LOG4CXX_STR("false"));
+        break;
+
+        case BYTES:
+        {
+            static const logchar hex[] = {
+                0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+                0x38, 0x39, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66 };
+            dest.reserve(dest.length() + 2 * data.length());
+            for(std::string::const_iterator iter = data.begin();
+                iter != data.end();
+                iter++) {
+                unsigned char byte = (unsigned char) *iter;
+                dest.append(1, hex[byte >> 4]);
+                dest.append(1, hex[byte & 0x0F]);
+            }
+        }
+        break;
+
+        default:
+        dest.append(text);
+        break;
+    }
+}
@@ -25,6 +25,14 @@
 #include <log4cxx/helpers/fileoutputstream.h>
 #include <log4cxx/helpers/outputstreamwriter.h>
 #include <log4cxx/helpers/bufferedwriter.h>
+#include <log4cxx/helpers/doublebufferedoutputstream.h>
+#include <log4cxx/helpers/concurrentfileoutputstream.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/uringfileoutputstream.h>
+#include <log4cxx/helpers/formatbuffer.h>
+#include <log4cxx/spi/filter.h>
+#include <apr_atomic.h>
+#include <apr_thread_proc.h>
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/synchronized.h>
 
@@ -35,22 +43,40 @@ using namespace log4cxx::spi;
 IMPLEMENT_LOG4CXX_OBJECT(FileAppender)
 
 
-FileAppender::FileAppender() {
+FileAppender::FileAppender()
+    : concurrentAppends(0), appendBarriers(0), concurrentFile(false) {
     synchronized sync(mutex);
     fileAppend = true;
     bufferedIO = false;
     bufferSize = 8 * 1024;
+    flushIntervalMillis = 0;
+    concurrentWrites = false;
+    mapWindowSize = 0;
+    asyncIO = false;
+    commitIntervalMillis = 0;
+    commitSize = 0;
+    preallocationSize = 0;
+    dropCacheSize = 0;
 }
 
 FileAppender::FileAppender(const LayoutPtr& layout1, const LogString& fileName1,
         bool append1, bool bufferedIO1, int bufferSize1) 
-           : WriterAppender(layout1) {
+           : WriterAppender(layout1),
+             concurrentAppends(0), appendBarriers(0), concurrentFile(false) {
         {  
             synchronized sync(mutex);
             fileAppend = append1;
             fileName = fileName1;
             bufferedIO = bufferedIO1;
             bufferSize = bufferSize1;
+            flushIntervalMillis = 0;
+            concurrentWrites = false;
+            mapWindowSize = 0;
+            asyncIO = false;
+            commitIntervalMillis = 0;
+            commitSize = 0;
+            preallocationSize = 0;
+            dropCacheSize = 0;
          }
         Pool p;
         activateOptions(p);
@@ -58,26 +84,44 @@ FileAppender::FileAppender(const LayoutPtr& layout1, const LogString& fileName1,
 
 FileAppender::FileAppender(const LayoutPtr& layout1, const LogString& fileName1,
         bool append1)
-: WriterAppender(layout1) {
+: WriterAppender(layout1),
+  concurrentAppends(0), appendBarriers(0), concurrentFile(false) {
         {
             synchronized sync(mutex);
             fileAppend = append1;
             fileName = fileName1;
             bufferedIO = false;
             bufferSize = 8 * 1024;
+            flushIntervalMillis = 0;
+            concurrentWrites = false;
+            mapWindowSize = 0;
+            asyncIO = false;
+            commitIntervalMillis = 0;
+            commitSize = 0;
+            preallocationSize = 0;
+            dropCacheSize = 0;
          }
         Pool p;
         activateOptions(p);
 }
 
 FileAppender::FileAppender(const LayoutPtr& layout1, const LogString& fileName1)
-: WriterAppender(layout1) {
+: WriterAppender(layout1),
+  concurrentAppends(0), appendBarriers(0), concurrentFile(false) {
         {
             synchronized sync(mutex);
             fileAppend = true;
             fileName = fileName1;
             bufferedIO = false;
             bufferSize = 8 * 1024;
+            flushIntervalMillis = 0;
+            concurrentWrites = false;
+            mapWindowSize = 0;
+            asyncIO = false;
+            commitIntervalMillis = 0;
+            commitSize = 0;
+            preallocationSize = 0;
+            dropCacheSize = 0;
         }
         Pool p;
         activateOptions(p);
@@ -111,6 +155,60 @@ void FileAppender::setBufferedIO(bool bufferedIO1)
         }
 }
 
+void FileAppender::setFlushIntervalMillis(int millis)
+{
+        synchronized sync(mutex);
+        flushIntervalMillis = millis;
+}
+
+void FileAppender::setConcurrentWrites(bool value)
+{
+        synchronized sync(mutex);
+        concurrentWrites = value;
+}
+
+void FileAppender::setMapWindowSize(int bytes)
+{
+        synchronized sync(mutex);
+        mapWindowSize = bytes;
+}
+
+void FileAppender::setAsyncIO(bool value)
+{
+        synchronized sync(mutex);
+        asyncIO = value;
+}
+
+void FileAppender::setCommitIntervalMillis(int millis)
+{
+        synchronized sync(mutex);
+        commitIntervalMillis = millis;
+}
+
+void FileAppender::setCommitSize(int bytes)
+{
+        synchronized sync(mutex);
+        commitSize = bytes;
+}
+
+void FileAppender::setCommitLevel(const LevelPtr& level)
+{
+        synchronized sync(mutex);
+        commitLevel = level;
+}
+
+void FileAppender::setPreallocationSize(int bytes)
+{
+        synchronized sync(mutex);
+        preallocationSize = bytes;
+}
+
+void FileAppender::setDropCacheSize(int bytes)
+{
+        synchronized sync(mutex);
+        dropCacheSize = bytes;
+}
+
 void FileAppender::setOption(const LogString& option,
         const LogString& value)
 {
@@ -140,6 +238,51 @@ void FileAppender::setOption(const LogString& option,
                 synchronized sync(mutex);
                 bufferSize = OptionConverter::toFileSize(value, 8*1024);
         }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("FLUSHINTERVALMILLIS"), LOG4CXX_STR("flushintervalmillis")))
+        {
+                synchronized sync(mutex);
+                flushIntervalMillis = OptionConverter::toInt(value, 0);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("CONCURRENTWRITES"), LOG4CXX_STR("concurrentwrites")))
+        {
+                synchronized sync(mutex);
+                concurrentWrites = OptionConverter::toBoolean(value, false);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("MAPWINDOWSIZE"), LOG4CXX_STR("mapwindowsize")))
+        {
+                synchronized sync(mutex);
+                mapWindowSize = (int) OptionConverter::toFileSize(value, 0);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("ASYNCIO"), LOG4CXX_STR("asyncio")))
+        {
+                synchronized sync(mutex);
+                asyncIO = OptionConverter::toBoolean(value, false);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMMITINTERVALMILLIS"), LOG4CXX_STR("commitintervalmillis")))
+        {
+                synchronized sync(mutex);
+                commitIntervalMillis = OptionConverter::toInt(value, 0);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMMITSIZE"), LOG4CXX_STR("commitsize")))
+        {
+                synchronized sync(mutex);
+                commitSize = (int) OptionConverter::toFileSize(value, 0);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("COMMITLEVEL"), LOG4CXX_STR("commitlevel")))
+        {
+                synchronized sync(mutex);
+                commitLevel = Level::toLevelLS(value);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("PREALLOCATIONSIZE"), LOG4CXX_STR("preallocationsize")))
+        {
+                synchronized sync(mutex);
+                preallocationSize = (int) OptionConverter::toFileSize(value, 0);
+        }
+        else if (StringHelper::equalsIgnoreCase(option, LOG4CXX_STR("DROPCACHESIZE"), LOG4CXX_STR("dropcachesize")))
+        {
+                synchronized sync(mutex);
+                dropCacheSize = (int) OptionConverter::toFileSize(value, 0);
+        }
         else
         {
                 WriterAppender::setOption(option, value);
@@ -241,9 +384,11 @@ void FileAppender::setFile(
       size_t bufferSize1,
       Pool& p) {
   synchronized sync(mutex);
+  AppendBarrier barrier(*this);
 
-  // It does not make sense to have immediate flush and bufferedIO.
-  if (bufferedIO1) {
+  // It does not make sense to have immediate flush and bufferedIO
+  //    or output written on a background thread.
+  if (bufferedIO1 || flushIntervalMillis > 0) {
     setImmediateFlush(false);
   }
 
@@ -264,16 +409,17 @@ void FileAppender::setFile(
       }
   }
 
+  this->bufferedIO = bufferedIO1;
   OutputStreamPtr outStream;
   try {
-      outStream = new FileOutputStream(filename, append1);
+      outStream = createFileOutputStream(filename, append1);
   } catch(IOException& ex) {
       LogString parentName = File().setPath(filename).getParent(p);
       if (!parentName.empty()) {
           File parentDir;
           parentDir.setPath(parentName);
           if(!parentDir.exists(p) && parentDir.mkdirs(p)) {
-             outStream = new FileOutputStream(filename, append1);
+             outStream = createFileOutputStream(filename, append1);
           } else {
              throw ex;
           }
@@ -294,7 +440,10 @@ void FileAppender::setFile(
 
   WriterPtr newWriter(createWriter(outStream));
 
-  if (bufferedIO1) {
+  //
+  //   a BufferedWriter would hold output
+  //      that the background thread should write
+  if (bufferedIO1 && flushIntervalMillis <= 0) {
     newWriter = new BufferedWriter(newWriter, bufferSize1);
   }
   setWriter(newWriter);
@@ -307,3 +456,148 @@ void FileAppender::setFile(
 
 }
 
+WriterPtr FileAppender::createWriter(OutputStreamPtr& os) {
+  OutputStreamPtr buffered(createBufferedOutputStream(os));
+  return WriterAppender::createWriter(buffered);
+}
+
+OutputStreamPtr FileAppender::createBufferedOutputStream(OutputStreamPtr& os) {
+  if (flushIntervalMillis > 0) {
+    return new DoubleBufferedOutputStream(os, bufferSize, flushIntervalMillis);
+  }
+  return os;
+}
+
+OutputStreamPtr FileAppender::createFileOutputStream(const LogString& filename,
+    bool append1) {
+  concurrentFile = false;
+  OutputStreamPtr os;
+  if (concurrentWrites && !bufferedIO && flushIntervalMillis <= 0
+      && ConcurrentFileOutputStream::isSupported()) {
+    os = new ConcurrentFileOutputStream(filename, append1);
+    concurrentFile = true;
+  } else if (mapWindowSize > 0 && MappedFileOutputStream::isSupported()) {
+    os = new MappedFileOutputStream(filename, append1, mapWindowSize);
+  } else if (asyncIO && commitIntervalMillis <= 0
+      && UringFileOutputStream::isSupported()) {
+    try {
+      os = new UringFileOutputStream(filename, append1, bufferSize);
+    } catch(IOException&) {
+      //
+      //   the kernel may not provide io_uring,
+      //      an unusable file fails again below
+      LogLog::debug(LOG4CXX_STR("io_uring not available, using blocking writes."));
+    }
+  }
+  if (os == 0) {
+    os = new FileOutputStream(filename, append1,
+        preallocationSize > 0 ? preallocationSize : 0,
+        dropCacheSize > 0 ? dropCacheSize : 0);
+  }
+  return createCommitStream(os);
+}
+
+OutputStreamPtr FileAppender::createCommitStream(OutputStreamPtr& os) {
+  if (commitIntervalMillis > 0) {
+    commitStream = new GroupCommitOutputStream(os, commitIntervalMillis, commitSize);
+    return commitStream;
+  }
+  commitStream = 0;
+  return os;
+}
+
+bool FileAppender::canAppendConcurrently(const LoggingEventPtr& /* event */) {
+  return true;
+}
+
+void FileAppender::doAppend(const LoggingEventPtr& event, Pool& p) {
+  if (concurrentFile) {
+    apr_atomic_inc32((apr_uint32_t*) &concurrentAppends);
+    //
+    //   the writer, layout and filters only change
+    //      while an AppendBarrier holds back concurrent appends
+    if (apr_atomic_read32((apr_uint32_t*) &appendBarriers) == 0
+        && concurrentFile && !closed && getWriter() != 0 && layout != 0) {
+      bool accepted = isAsSevereAsThreshold(event->getLevel());
+      try {
+        for(Filter* f = headFilter; accepted && f != 0;) {
+          switch(f->decide(event)) {
+            case Filter::DENY:
+              accepted = false;
+              break;
+            case Filter::ACCEPT:
+              f = 0;
+              break;
+            case Filter::NEUTRAL:
+              f = f->getNext();
+          }
+        }
+        if (accepted && canAppendConcurrently(event)) {
+          FormatBuffer msg(event, layout);
+          if (!msg.isFormatted()) {
+            layout->format(msg.get(), event, p);
+            msg.setFormatted();
+          }
+          getWriter()->write(msg.get(), p);
+          apr_atomic_dec32((apr_uint32_t*) &concurrentAppends);
+          awaitCommit(event, p);
+          return;
+        }
+      } catch(...) {
+        apr_atomic_dec32((apr_uint32_t*) &concurrentAppends);
+        throw;
+      }
+      apr_atomic_dec32((apr_uint32_t*) &concurrentAppends);
+      if (!accepted) {
+        return;
+      }
+    } else {
+      apr_atomic_dec32((apr_uint32_t*) &concurrentAppends);
+    }
+  }
+  WriterAppender::doAppend(event, p);
+  awaitCommit(event, p);
+}
+
+/**
+ *  Waits outside the appender lock, so other threads append
+ *  while a sync is in progress and share the next one.
+ *  Output held by BufferedIO or FlushIntervalMillis is
+ *  written to the stream first so the commit covers it.
+ */
+void FileAppender::awaitCommit(const LoggingEventPtr& event, Pool& p) {
+  if (commitLevel != 0 && event->getLevel()->isGreaterOrEqual(commitLevel)) {
+    GroupCommitOutputStreamPtr stream;
+    {
+      synchronized sync(mutex);
+      stream = commitStream;
+      if (stream != 0 && getWriter() != 0
+          && (bufferedIO || flushIntervalMillis > 0)) {
+        getWriter()->flush(p);
+      }
+    }
+    if (stream != 0) {
+      stream->awaitCommit(p);
+    }
+  }
+}
+
+void FileAppender::close() {
+  synchronized sync(mutex);
+  AppendBarrier barrier(*this);
+  concurrentFile = false;
+  WriterAppender::close();
+  commitStream = 0;
+}
+
+FileAppender::AppendBarrier::AppendBarrier(FileAppender& appender1)
+  : appender(appender1) {
+  apr_atomic_inc32((apr_uint32_t*) &appender.appendBarriers);
+  while(apr_atomic_read32((apr_uint32_t*) &appender.concurrentAppends) != 0) {
+    apr_thread_yield();
+  }
+}
+
+FileAppender::AppendBarrier::~AppendBarrier() {
+  apr_atomic_dec32((apr_uint32_t*) &appender.appendBarriers);
+}
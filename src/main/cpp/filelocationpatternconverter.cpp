@@ -46,5 +46,6 @@ void FileLocationPatternConverter::format(
    const LoggingEventPtr& event,
    LogString& toAppendTo,
    Pool& /* p */ ) const {
-    append(toAppendTo, event->getLocationInformation().getFileName());
+    LogString buf;
+    toAppendTo.append(event->getLocationInformation().getFileName(buf));
 }
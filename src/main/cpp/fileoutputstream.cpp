@@ -19,12 +19,22 @@
 #include <log4cxx/helpers/fileoutputstream.h>
 #include <log4cxx/helpers/exception.h>
 #include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/loglog.h>
 #include <apr_file_io.h>
+#include <apr_portable.h>
 #include <log4cxx/helpers/transcoder.h>
 #if !defined(LOG4CXX)
 #define LOG4CXX 1
 #endif
 #include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -32,11 +42,31 @@ using namespace log4cxx::helpers;
 IMPLEMENT_LOG4CXX_OBJECT(FileOutputStream)
 
 FileOutputStream::FileOutputStream(const LogString& filename,
-    bool append) : pool(), fileptr(open(filename, append, pool)) {
+    bool append) : pool(), fileptr(open(filename, append, pool)),
+    preallocationSize(0), dropCacheSize(0),
+    position(0), allocated(0), flushed(0), dropped(0) {
 }
 
 FileOutputStream::FileOutputStream(const logchar* filename,
-    bool append) : pool(), fileptr(open(filename, append, pool)) {
+    bool append) : pool(), fileptr(open(filename, append, pool)),
+    preallocationSize(0), dropCacheSize(0),
+    position(0), allocated(0), flushed(0), dropped(0) {
+}
+
+FileOutputStream::FileOutputStream(const LogString& filename,
+    bool append, size_t preallocationSize1, size_t dropCacheSize1)
+    : pool(), fileptr(open(filename, append, pool)),
+    preallocationSize(preallocationSize1), dropCacheSize(dropCacheSize1),
+    position(0), allocated(0), flushed(0), dropped(0) {
+    if (append && (preallocationSize > 0 || dropCacheSize > 0)) {
+        apr_finfo_t finfo;
+        if (apr_file_info_get(&finfo, APR_FINFO_SIZE, fileptr) == APR_SUCCESS) {
+            position = finfo.size;
+        }
+    }
+    allocated = position;
+    flushed = position;
+    dropped = position;
 }
 
 apr_file_t* FileOutputStream::open(const LogString& filename,
@@ -66,6 +96,20 @@ FileOutputStream::~FileOutputStream() {
 
 void FileOutputStream::close(Pool& /* p */) {
   if (fileptr != NULL) {
+#if LOG4CXX_HAS_FALLOCATE
+    if (allocated > position) {
+      //
+      //   release the blocks allocated beyond the end,
+      //      using the size on disk in case other processes
+      //      appended to the file
+      apr_os_file_t fd;
+      struct stat st;
+      if (apr_os_file_get(&fd, fileptr) == APR_SUCCESS && fstat(fd, &st) == 0
+          && ftruncate(fd, st.st_size) != 0) {
+        LogLog::debug(LOG4CXX_STR("Unable to release preallocated blocks."));
+      }
+    }
+#endif
     apr_status_t stat = apr_file_close(fileptr);
     if (stat != APR_SUCCESS) {
         throw IOException(stat);
@@ -82,6 +126,9 @@ void FileOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
      throw IOException(-1);
   }
   size_t nbytes = buf.remaining();
+  if (preallocationSize > 0 && position + (log4cxx_int64_t) nbytes > allocated) {
+    allocate(position + nbytes);
+  }
   size_t pos = buf.position();
   const char* data = buf.data();
   while(nbytes > 0) {
@@ -91,8 +138,96 @@ void FileOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
       throw IOException(stat);
     }
     pos += nbytes;
+    position += nbytes;
     buf.position(pos);
     nbytes = buf.remaining();
   }
+  if (dropCacheSize > 0 && position - flushed >= (log4cxx_int64_t) dropCacheSize) {
+    dropCache();
+  }
+}
+
+/**
+ *  Allocates disk blocks from the end of the allocated range
+ *  to the first multiple of preallocationSize after end.
+ *  The file size is unchanged.
+ */
+void FileOutputStream::allocate(log4cxx_int64_t end) {
+#if LOG4CXX_HAS_FALLOCATE
+  log4cxx_int64_t start = allocated > position ? allocated : position;
+  log4cxx_int64_t newEnd = (end / preallocationSize + 1) * preallocationSize;
+  apr_os_file_t fd;
+  if (apr_os_file_get(&fd, fileptr) == APR_SUCCESS
+      && fallocate(fd, FALLOC_FL_KEEP_SIZE, (off_t) start, (off_t) (newEnd - start)) == 0) {
+    allocated = newEnd;
+    return;
+  }
+#endif
+  //
+  //   not supported by the platform or file system
+  preallocationSize = 0;
+}
+
+/**
+ *  Starts write-back of the bytes written since the last call
+ *  and drops the bytes started by the last call from the page cache.
+ *  Errors are ignored since the calls are only advice.
+ */
+void FileOutputStream::dropCache() {
+#if LOG4CXX_HAS_SYNC_FILE_RANGE || LOG4CXX_HAS_POSIX_FADVISE
+  apr_os_file_t fd;
+  if (apr_os_file_get(&fd, fileptr) == APR_SUCCESS) {
+#if LOG4CXX_HAS_SYNC_FILE_RANGE
+    //
+    //   the previous range is usually written back by now,
+    //      waiting for it makes its pages clean so they can be dropped
+    if (flushed > dropped) {
+      sync_file_range(fd, (off_t) dropped, (off_t) (flushed - dropped),
+          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    }
+    sync_file_range(fd, (off_t) flushed, (off_t) (position - flushed), SYNC_FILE_RANGE_WRITE);
+#endif
+#if LOG4CXX_HAS_POSIX_FADVISE
+    if (flushed > dropped) {
+      posix_fadvise(fd, (off_t) dropped, (off_t) (flushed - dropped), POSIX_FADV_DONTNEED);
+    }
+#endif
+  }
+#endif
+  dropped = flushed;
+  flushed = position;
+}
+
+
+void FileOutputStream::sync(Pool& /* p */) {
+  if (fileptr == NULL) {
+     throw IOException(-1);
+  }
+  datasync(fileptr);
 }
 
+void FileOutputStream::datasync(apr_file_t* file) {
+  apr_os_file_t osfile;
+  apr_status_t stat = apr_os_file_get(&osfile, file);
+  if (stat == APR_SUCCESS) {
+#if defined(_WIN32)
+    if (!FlushFileBuffers(osfile)) {
+      stat = apr_get_os_error();
+    }
+#elif LOG4CXX_HAS_FDATASYNC
+    //
+    //   file size changes are still written,
+    //      other metadata such as times is not
+    if (fdatasync(osfile) != 0) {
+      stat = APR_FROM_OS_ERROR(errno);
+    }
+#else
+    if (fsync(osfile) != 0) {
+      stat = APR_FROM_OS_ERROR(errno);
+    }
+#endif
+  }
+  if (stat != APR_SUCCESS) {
+    throw IOException(stat);
+  }
+}
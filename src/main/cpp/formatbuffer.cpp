@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/formatbuffer.h>
+#include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/spi/loggingevent.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+FormatBuffer::FormatBuffer()
+    : data(ThreadSpecificData::getCurrentData()), buf(&local), local(),
+      event(0), layout(0), formatted(false) {
+    acquire();
+    if (data != 0) {
+        data->setFormatted(0, 0);
+        buf->erase();
+    }
+}
+
+FormatBuffer::FormatBuffer(const LoggingEventPtr& event1,
+                           const LayoutPtr& layout1)
+    : data(ThreadSpecificData::getCurrentData()), buf(&local), local(),
+      event(event1), layout(layout1), formatted(false) {
+    acquire();
+    if (data != 0) {
+        if (data->formattedEvent == event &&
+            layout->isEquivalent(*data->formattedLayout)) {
+            formatted = true;
+        } else {
+            data->setFormatted(0, 0);
+            buf->erase();
+        }
+    }
+}
+
+void FormatBuffer::acquire() {
+    if (data == 0) {
+        data = ThreadSpecificData::createCurrentData();
+    }
+    if (data != 0 && !data->formatBufferInUse) {
+        data->formatBufferInUse = true;
+        buf = &data->formatBuffer;
+    } else {
+        data = 0;
+    }
+}
+
+FormatBuffer::~FormatBuffer() {
+    if (data != 0) {
+        if (buf->capacity() > HIGH_WATER) {
+            data->setFormatted(0, 0);
+            LogString().swap(*buf);
+        } else if (!formatted) {
+            buf->erase();
+        }
+        data->formatBufferInUse = false;
+    }
+}
+
+void FormatBuffer::setFormatted() {
+    //
+    //   only keep output that an equivalent layout could reuse
+    if (data != 0 && event != 0 && layout->isEquivalent(*layout)) {
+        data->setFormatted(event, layout);
+        formatted = true;
+    }
+}
+
+void FormatBuffer::clearFormatted() {
+    ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
+    if (data != 0 && !data->formatBufferInUse && data->formattedEvent != 0) {
+        data->setFormatted(0, 0);
+        data->formatBuffer.erase();
+    }
+}
+
+
+EncodeBuffer::EncodeBuffer()
+    : data(ThreadSpecificData::getCurrentData()), buf(&local), local() {
+    if (data == 0) {
+        data = ThreadSpecificData::createCurrentData();
+    }
+    if (data != 0 && !data->encodeBufferInUse) {
+        data->encodeBufferInUse = true;
+        buf = &data->encodeBuffer;
+    } else {
+        data = 0;
+    }
+}
+
+EncodeBuffer::~EncodeBuffer() {
+    if (data != 0) {
+        if (buf->size() > HIGH_WATER) {
+            std::vector<char>().swap(*buf);
+        }
+        data->encodeBufferInUse = false;
+    }
+}
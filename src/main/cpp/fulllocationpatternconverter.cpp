@@ -47,7 +47,8 @@ void FullLocationPatternConverter::format(
   const LoggingEventPtr& event,
   LogString& toAppendTo,
   Pool& p) const {
-   append(toAppendTo, event->getLocationInformation().getFileName());
+   LogString buf;
+   toAppendTo.append(event->getLocationInformation().getFileName(buf));
    toAppendTo.append(1, (logchar) 0x28 /* '(' */);
    StringHelper::toString(
        event->getLocationInformation().getLineNumber(),
@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/groupcommitoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/loglog.h>
+#include <apr_thread_proc.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(GroupCommitOutputStream)
+
+GroupCommitOutputStream::GroupCommitOutputStream(OutputStreamPtr& out1,
+    int commitIntervalMillis1, size_t commitSize1)
+    : pool(), out(out1),
+      commitIntervalMillis(commitIntervalMillis1 > 0 ? commitIntervalMillis1 : 1000),
+      commitSize(commitSize1),
+      mutex(pool), commitWanted(pool), committed(pool),
+      written(0), durable(0), failed(0), failure(), waiters(0), closed(false), thread() {
+    if (out1 == 0) {
+       throw NullPointerException(LOG4CXX_STR("out parameter may not be null."));
+    }
+#if APR_HAS_THREADS
+    thread.run(committer, this);
+#endif
+}
+
+GroupCommitOutputStream::~GroupCommitOutputStream() {
+    try {
+        Pool p;
+        close(p);
+    } catch(std::exception&) {
+    }
+}
+
+void GroupCommitOutputStream::close(Pool& p) {
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            return;
+        }
+    }
+    //
+    //   commit before stopping so threads waiting in awaitCommit
+    //      are released by the commit rather than by closed
+    try {
+        commit(p);
+    } catch(...) {
+        if (stopCommitter()) {
+            out->close(p);
+        }
+        throw;
+    }
+    if (stopCommitter()) {
+        out->close(p);
+    }
+}
+
+/**
+ *  Stops the committer thread.
+ *  @return true if this call stopped it.
+ */
+bool GroupCommitOutputStream::stopCommitter() {
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            return false;
+        }
+        closed = true;
+        commitWanted.signalAll();
+        committed.signalAll();
+    }
+#if APR_HAS_THREADS
+    try {
+        thread.join();
+    } catch(InterruptedException& e) {
+        Thread::currentThreadInterrupt();
+        LogLog::error(LOG4CXX_STR("Got an InterruptedException while waiting for the committer to finish,"), e);
+    }
+#endif
+    return true;
+}
+
+void GroupCommitOutputStream::flush(Pool& p) {
+    out->flush(p);
+}
+
+void GroupCommitOutputStream::sync(Pool& p) {
+    awaitCommit(p);
+}
+
+void GroupCommitOutputStream::write(ByteBuffer& buf, Pool& p) {
+    size_t nbytes = buf.remaining();
+    out->write(buf, p);
+    synchronized sync(mutex);
+    written += nbytes;
+    if (commitSize > 0 && written - durable >= (log4cxx_int64_t) commitSize) {
+        commitWanted.signalAll();
+    }
+}
+
+#if APR_HAS_THREADS
+void GroupCommitOutputStream::awaitCommit(Pool& /* p */) {
+    synchronized sync(mutex);
+    log4cxx_int64_t target = written;
+    if (durable < target && failed < target && !closed) {
+        waiters++;
+        commitWanted.signalAll();
+        try {
+            while(durable < target && failed < target && !closed) {
+                committed.await(mutex);
+            }
+        } catch(...) {
+            waiters--;
+            throw;
+        }
+        waiters--;
+    }
+    if (durable < target && failed >= target) {
+        throw IOException(failure);
+    }
+}
+#else
+void GroupCommitOutputStream::awaitCommit(Pool& p) {
+    commit(p);
+}
+#endif
+
+/**
+ *  Syncs the destination and marks the bytes written
+ *  before the sync started as durable.
+ */
+void GroupCommitOutputStream::commit(Pool& p) {
+    log4cxx_int64_t target = 0;
+    {
+        synchronized sync(mutex);
+        target = written;
+        if (target == durable) {
+            return;
+        }
+    }
+    try {
+        out->sync(p);
+    } catch(IOException& e) {
+        fail(target, e);
+        throw;
+    } catch(...) {
+        fail(target, IOException());
+        throw;
+    }
+    synchronized sync(mutex);
+    //
+    //   a concurrent commit with a larger target
+    //      may have finished first
+    if (target > durable) {
+        durable = target;
+    }
+    committed.signalAll();
+}
+
+/**
+ *  Records a failed commit so that the threads waiting
+ *  for the bytes it covered receive the failure.
+ */
+void GroupCommitOutputStream::fail(log4cxx_int64_t target, const IOException& e) {
+    synchronized sync(mutex);
+    if (target > failed) {
+        failed = target;
+        failure = e;
+    }
+    committed.signalAll();
+}
+
+void* LOG4CXX_THREAD_FUNC GroupCommitOutputStream::committer(apr_thread_t* /* thread */, void* data) {
+    GroupCommitOutputStream* pThis = (GroupCommitOutputStream*) data;
+    Pool p;
+    bool isActive = true;
+    try {
+        while(isActive) {
+            {
+                synchronized sync(pThis->mutex);
+                //
+                //   bytes covered by a failed commit are retried
+                //      on the interval rather than immediately
+                log4cxx_int64_t attempted = pThis->durable > pThis->failed ?
+                    pThis->durable : pThis->failed;
+                if (!pThis->closed && pThis->waiters == 0
+                    && (pThis->commitSize == 0
+                        || pThis->written - attempted < (log4cxx_int64_t) pThis->commitSize)) {
+                    pThis->commitWanted.await(pThis->mutex, pThis->commitIntervalMillis);
+                }
+                isActive = !pThis->closed;
+            }
+            if (isActive) {
+                try {
+                    pThis->commit(p);
+                } catch(IOException& e) {
+                    LogLog::error(LOG4CXX_STR("Unable to commit output,"), e);
+                }
+            }
+        }
+    } catch(InterruptedException& ex) {
+        Thread::currentThreadInterrupt();
+    } catch(...) {
+    }
+    return 0;
+}
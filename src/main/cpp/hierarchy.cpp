@@ -62,6 +62,7 @@ provisionNodes(new ProvisionNodeMap())
         configured = false;
         thresholdInt = Level::ALL_INT;
         threshold = Level::getAll();
+        clock = Clock::getDefault();
         emittedNoResourceBundleWarning = false;
 }
 
@@ -201,6 +202,19 @@ const LevelPtr& Hierarchy::getThreshold() const
         return threshold;
 }
 
+void Hierarchy::setClock(const ClockPtr& clock1)
+{
+        if (clock1 != 0)
+        {
+                clock = clock1;
+        }
+}
+
+const ClockPtr& Hierarchy::getClock() const
+{
+        return clock;
+}
+
 LoggerPtr Hierarchy::getLogger(const LogString& name)
 {
         return getLogger(name, defaultFactory);
@@ -278,6 +292,7 @@ void Hierarchy::resetConfiguration()
         getRootLogger()->setLevel(Level::getDebug());
         root->setResourceBundle(0);
         setThreshold(Level::getAll());
+        setClock(Clock::getDefault());
 
         shutdown(); // nested locks are OK
 
@@ -115,8 +115,8 @@ void HTMLLayout::format(LogString& output,
         {
                 output.append(LOG4CXX_STR("<td>"));
                 const LocationInfo& locInfo = event->getLocationInformation();
-                LOG4CXX_DECODE_CHAR(fileName, locInfo.getFileName());
-                Transform::appendEscapingTags(output, fileName);
+                LogString fileName;
+                Transform::appendEscapingTags(output, locInfo.getFileName(fileName));
                 output.append(1, (logchar) 0x3A /* ':' */);
                 int line = event->getLocationInformation().getLineNumber();
                 if (line != 0)
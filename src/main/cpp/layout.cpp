@@ -38,3 +38,5 @@ LogString Layout::getContentType() const { return LOG4CXX_STR("text/plain"); }
 void Layout::appendHeader(LogString&, log4cxx::helpers::Pool&) {}
 
 void Layout::appendFooter(LogString&, log4cxx::helpers::Pool&) {}
+
+bool Layout::isEquivalent(const Layout&) const { return false; }
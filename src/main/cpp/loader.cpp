@@ -29,6 +29,7 @@
 #include <log4cxx/spi/appenderattachable.h>
 #include <log4cxx/helpers/xml.h>
 #include <log4cxx/spi/triggeringeventevaluator.h>
+#include <log4cxx/spi/messagesupplier.h>
 #include <fstream>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/fileinputstream.h>
@@ -53,6 +54,7 @@ IMPLEMENT_LOG4CXX_OBJECT(XMLDOMDocument)
 IMPLEMENT_LOG4CXX_OBJECT(XMLDOMElement)
 IMPLEMENT_LOG4CXX_OBJECT(XMLDOMNodeList)
 IMPLEMENT_LOG4CXX_OBJECT(TriggeringEventEvaluator)
+IMPLEMENT_LOG4CXX_OBJECT(MessageSupplier)
 
 const Class& Loader::loadClass(const LogString& clazz)
 {
@@ -18,12 +18,68 @@
 #include <log4cxx/spi/location/locationinfo.h>
 #include <log4cxx/helpers/objectoutputstream.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/transcoder.h>
 #include "apr_pools.h"
 #include "apr_strings.h"
 
+using namespace ::log4cxx;
 using namespace ::log4cxx::spi;
 using namespace log4cxx::helpers;
 
+namespace {
+    std::string parseMethodName(const char* methodName) {
+        std::string tmp(methodName);
+        size_t colonPos = tmp.find("::");
+        if (colonPos != std::string::npos) {
+          tmp.erase(0, colonPos + 2);
+        } else {
+          size_t spacePos = tmp.find(' ');
+          if (spacePos != std::string::npos) {
+            tmp.erase(0, spacePos + 1);
+          }
+        }
+        size_t parenPos = tmp.find('(');
+        if (parenPos != std::string::npos) {
+          tmp.erase(parenPos);
+        }
+        return tmp;
+    }
+
+    std::string parseClassName(const char* methodName) {
+        std::string tmp(methodName);
+        size_t colonPos = tmp.find("::");
+        if (colonPos != std::string::npos) {
+           tmp.erase(colonPos);
+           size_t spacePos = tmp.find_last_of(' ');
+           if (spacePos != std::string::npos) {
+               tmp.erase(0, spacePos + 1);
+           }
+           return tmp;
+        }
+        tmp.erase(0, tmp.length() );
+        return tmp;
+    }
+
+    LogString decode(const std::string& src) {
+        LOG4CXX_DECODE_CHAR(dst, src);
+        return dst;
+    }
+
+    /**
+     *  Parses the names of a call site into storage that is never freed.
+     */
+    const LocationInfo::CallSite::Names* parseNames(const char* fileName,
+        const char* functionName) {
+        LocationInfo::CallSite::Names* names = new LocationInfo::CallSite::Names();
+        names->className = parseClassName(functionName);
+        names->methodName = parseMethodName(functionName);
+        names->decodedClassName = decode(names->className);
+        names->decodedMethodName = decode(names->methodName);
+        names->decodedFileName = decode(fileName);
+        return names;
+    }
+}
+
    /**
      When location information is not available the constant
      <code>NA</code> is returned. Current value of this string
@@ -36,6 +92,18 @@ using namespace log4cxx::helpers;
    return unavailable;
  }
 
+/**
+*   Parses and decodes the names of a call site.
+*/
+ LocationInfo::CallSite::CallSite( const char * const fileName1,
+              const char * const functionName1,
+              int lineNumber1 )
+     :  fileName( fileName1 ),
+        functionName( functionName1 ),
+        lineNumber( lineNumber1 ),
+        names( parseNames(fileName1, functionName1) ) {
+}
+
 /**
 *   Constructor.
 *   @remarks Used by LOG4CXX_LOCATION to generate
@@ -46,7 +114,19 @@ using namespace log4cxx::helpers;
               int lineNumber1 )
      :  lineNumber( lineNumber1 ),
         fileName( fileName1 ),
-        methodName( methodName1 ) {
+        methodName( methodName1 ),
+        callSite( 0 ) {
+}
+
+/**
+*   Constructor.
+*   @param site call site whose parsed names are shared by this location
+*/
+ LocationInfo::LocationInfo( const CallSite& site )
+     :  lineNumber( site.lineNumber ),
+        fileName( site.fileName ),
+        methodName( site.functionName ),
+        callSite( &site ) {
 }
 
 /**
@@ -55,7 +135,8 @@ using namespace log4cxx::helpers;
  LocationInfo::LocationInfo()
    : lineNumber( -1 ),
      fileName(LocationInfo::NA),
-     methodName(LocationInfo::NA_METHOD) {
+     methodName(LocationInfo::NA_METHOD),
+     callSite( 0 ) {
 }
 
 /**
@@ -65,7 +146,8 @@ using namespace log4cxx::helpers;
  LocationInfo::LocationInfo( const LocationInfo & src )
      :  lineNumber( src.lineNumber ),
         fileName( src.fileName ),
-        methodName( src.methodName ) {
+        methodName( src.methodName ),
+        callSite( src.callSite ) {
 }
 
 /**
@@ -77,6 +159,7 @@ using namespace log4cxx::helpers;
   fileName = src.fileName;
   methodName = src.methodName;
   lineNumber = src.lineNumber;
+  callSite = src.callSite;
   return * this;
 }
 
@@ -87,6 +170,7 @@ using namespace log4cxx::helpers;
   fileName = NA;
   methodName = NA_METHOD;
   lineNumber = -1;
+  callSite = 0;
 }
 
 
@@ -111,37 +195,42 @@ using namespace log4cxx::helpers;
 /** Returns the method name of the caller. */
  const std::string LocationInfo::getMethodName() const
 {
-    std::string tmp(methodName);
-    size_t colonPos = tmp.find("::");
-    if (colonPos != std::string::npos) {
-      tmp.erase(0, colonPos + 2);
-    } else {
-      size_t spacePos = tmp.find(' ');
-      if (spacePos != std::string::npos) {
-        tmp.erase(0, spacePos + 1);
-      }
-    }
-    size_t parenPos = tmp.find('(');
-    if (parenPos != std::string::npos) {
-      tmp.erase(parenPos);
+    if (callSite != 0) {
+      return callSite->names->methodName;
     }
-    return tmp;
+    return parseMethodName(methodName);
 }
 
 
 const std::string LocationInfo::getClassName() const {
-        std::string tmp(methodName);
-        size_t colonPos = tmp.find("::");
-        if (colonPos != std::string::npos) {
-           tmp.erase(colonPos);
-           size_t spacePos = tmp.find_last_of(' ');
-           if (spacePos != std::string::npos) {
-               tmp.erase(0, spacePos + 1);
-           }
-           return tmp;
-        }
-        tmp.erase(0, tmp.length() );
-        return tmp;
+    if (callSite != 0) {
+      return callSite->names->className;
+    }
+    return parseClassName(methodName);
+}
+
+const LogString& LocationInfo::getClassName(LogString& buf) const {
+    if (callSite != 0) {
+      return callSite->names->decodedClassName;
+    }
+    Transcoder::decode(parseClassName(methodName), buf);
+    return buf;
+}
+
+const LogString& LocationInfo::getFileName(LogString& buf) const {
+    if (callSite != 0) {
+      return callSite->names->decodedFileName;
+    }
+    Transcoder::decode(fileName, buf);
+    return buf;
+}
+
+const LogString& LocationInfo::getMethodName(LogString& buf) const {
+    if (callSite != 0) {
+      return callSite->names->decodedMethodName;
+    }
+    Transcoder::decode(parseMethodName(methodName), buf);
+    return buf;
 }
 
 void LocationInfo::write(ObjectOutputStream& os, Pool& p) const {
@@ -29,6 +29,7 @@
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/appenderattachableimpl.h>
 #include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/formatbuffer.h>
 #if !defined(LOG4CXX)
 #define LOG4CXX 1
 #endif
@@ -41,6 +42,18 @@ using namespace log4cxx::spi;
 
 IMPLEMENT_LOG4CXX_OBJECT(Logger)
 
+namespace {
+    /**
+     *  Clock used to time stamp the events of a logger.
+     */
+    inline const Clock& getClock(const LoggerRepository* repository) {
+        if (repository != 0) {
+            return *repository->getClock();
+        }
+        return *Clock::getDefault();
+    }
+}
+
 Logger::Logger(Pool& p, const LogString& name1)
 : pool(&p), name(), level(), parent(), resourceBundle(),
 repository(), aai(), mutex(p)
@@ -103,6 +116,8 @@ void Logger::callAppenders(const spi::LoggingEventPtr& event, Pool& p) const
                 }
         }
 
+        FormatBuffer::clearFormatted();
+
         if(writes == 0 && repository != 0)
         {
                 repository->emitNoAppenderWarning(const_cast<Logger*>(this));
@@ -124,7 +139,8 @@ void Logger::forcedLog(const LevelPtr& level1, const std::string& message,
 {
         Pool p;
         LOG4CXX_DECODE_CHAR(msg, message);
-        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location,
+              getClock(repository)));
         callAppenders(event, p);
 }
 
@@ -134,18 +150,63 @@ void Logger::forcedLog(const LevelPtr& level1, const std::string& message) const
         Pool p;
         LOG4CXX_DECODE_CHAR(msg, message);
         LoggingEventPtr event(new LoggingEvent(name, level1, msg,
-              LocationInfo::getLocationUnavailable()));
+              LocationInfo::getLocationUnavailable(), getClock(repository)));
         callAppenders(event, p);
 }
 
+void Logger::forcedLog(const LevelPtr& level1, const std::string& message,
+        const FieldList& fields, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_CHAR(msg, message);
+        forcedLogLS(level1, msg, fields, location);
+}
+
+void Logger::forcedLog(const LevelPtr& level1, const std::string& message,
+        const Field& field, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_CHAR(msg, message);
+        forcedLogLS(level1, msg, field, location);
+}
+
 void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
         const LocationInfo& location) const
 {
         Pool p;
-        LoggingEventPtr event(new LoggingEvent(name, level1, message, location));
+        LoggingEventPtr event(new LoggingEvent(name, level1, message, location,
+              getClock(repository)));
         callAppenders(event, p);
 }
 
+void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
+        const FieldList& fields, const LocationInfo& location) const
+{
+        Pool p;
+        LoggingEventPtr event(new LoggingEvent(name, level1, message, location,
+              getClock(repository)));
+        event->addFields(fields);
+        callAppenders(event, p);
+}
+
+void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
+        const Field& field, const LocationInfo& location) const
+{
+        Pool p;
+        LoggingEventPtr event(new LoggingEvent(name, level1, message, location,
+              getClock(repository)));
+        event->addField(field);
+        callAppenders(event, p);
+}
+
+void Logger::forcedLog(const LevelPtr& level1, const MessageSupplierPtr& supplier,
+        const LocationInfo& location) const
+{
+        Pool p;
+        LoggingEventPtr event(new LoggingEvent(name, level1, supplier, location,
+              getClock(repository)));
+        callAppenders(event, p);
+        event->detachSupplier();
+}
+
 
 bool Logger::getAdditivity() const
 {
@@ -625,7 +686,8 @@ void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message,
 {
         Pool p;
         LOG4CXX_DECODE_WCHAR(msg, message);
-        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location,
+              getClock(repository)));
         callAppenders(event, p);
 }
 
@@ -634,10 +696,24 @@ void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message) cons
         Pool p;
         LOG4CXX_DECODE_WCHAR(msg, message);
         LoggingEventPtr event(new LoggingEvent(name, level1, msg,
-           LocationInfo::getLocationUnavailable()));
+           LocationInfo::getLocationUnavailable(), getClock(repository)));
         callAppenders(event, p);
 }
 
+void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message,
+        const FieldList& fields, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_WCHAR(msg, message);
+        forcedLogLS(level1, msg, fields, location);
+}
+
+void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message,
+        const Field& field, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_WCHAR(msg, message);
+        forcedLogLS(level1, msg, field, location);
+}
+
 void Logger::getName(std::wstring& rv) const {
     Transcoder::encode(name, rv);
 }
@@ -747,7 +823,8 @@ void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>&
 {
         Pool p;
         LOG4CXX_DECODE_UNICHAR(msg, message);
-        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location,
+              getClock(repository)));
         callAppenders(event, p);
 }
 
@@ -756,9 +833,23 @@ void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>&
         Pool p;
         LOG4CXX_DECODE_UNICHAR(msg, message);
         LoggingEventPtr event(new LoggingEvent(name, level1, msg,
-           LocationInfo::getLocationUnavailable()));
+           LocationInfo::getLocationUnavailable(), getClock(repository)));
         callAppenders(event, p);
 }
+
+void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>& message,
+        const FieldList& fields, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_UNICHAR(msg, message);
+        forcedLogLS(level1, msg, fields, location);
+}
+
+void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>& message,
+        const Field& field, const LocationInfo& location) const
+{
+        LOG4CXX_DECODE_UNICHAR(msg, message);
+        forcedLogLS(level1, msg, field, location);
+}
 #endif
 
 #if LOG4CXX_UNICHAR_API
@@ -866,7 +957,8 @@ void Logger::forcedLog(const LevelPtr& level1, const CFStringRef& message,
 {
         Pool p;
         LOG4CXX_DECODE_CFSTRING(msg, message);
-        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+        LoggingEventPtr event(new LoggingEvent(name, level1, msg, location,
+              getClock(repository)));
         callAppenders(event, p);
 }
 
@@ -875,7 +967,7 @@ void Logger::forcedLog(const LevelPtr& level1, const CFStringRef& message) const
         Pool p;
         LOG4CXX_DECODE_CFSTRING(msg, message);
         LoggingEventPtr event(new LoggingEvent(name, level1, msg,
-           LocationInfo::getLocationUnavailable()));
+           LocationInfo::getLocationUnavailable(), getClock(repository)));
         callAppenders(event, p);
 }
 
@@ -49,7 +49,5 @@ void LoggerPatternConverter::format(
   const LoggingEventPtr& event,
   LogString& toAppendTo,
   Pool& /* p */ ) const {
-   int initialLength = toAppendTo.length();
-   toAppendTo.append(event->getLoggerName());
-   abbreviate(initialLength, toAppendTo);
+   appendAbbreviated(event->getLoggerName(), toAppendTo);
  }
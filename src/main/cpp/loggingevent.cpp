@@ -28,6 +28,9 @@
 #include <log4cxx/helpers/aprinitializer.h>
 #include <log4cxx/helpers/threadspecificdata.h>
 #include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/clock.h>
+#include <log4cxx/helpers/mdcmap.h>
+#include <algorithm>
 
 #include <apr_time.h>
 #include <apr_portable.h>
@@ -37,6 +40,7 @@
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/logger.h>
 #include <log4cxx/private/log4cxx_private.h>
+#include <apr_atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::spi;
@@ -44,6 +48,13 @@ using namespace log4cxx::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT(LoggingEvent)
 
+namespace {
+    /**
+     *  Number of fields reserved on the first addField.
+     */
+    const size_t INITIAL_FIELD_CAPACITY = 4;
+}
+
 
 //
 //   Accessor for start time.
@@ -56,9 +67,11 @@ LoggingEvent::LoggingEvent() :
    ndc(0),
    mdcCopy(0),
    properties(0),
+   fields(0),
    ndcLookupRequired(true),
    mdcCopyLookupRequired(true),
    timeStamp(0),
+   nanos(0),
    locationInfo() {
 }
 
@@ -70,54 +83,137 @@ LoggingEvent::LoggingEvent(
    ndc(0),
    mdcCopy(0),
    properties(0),
+   fields(0),
    ndcLookupRequired(true),
    mdcCopyLookupRequired(true),
    message(message1),
+   supplier(),
    timeStamp(apr_time_now()),
+   nanos(0),
    locationInfo(locationInfo1),
    threadName(getCurrentThreadName()) {
 }
 
+LoggingEvent::LoggingEvent(
+        const LogString& logger1, const LevelPtr& level1,
+        const LogString& message1, const LocationInfo& locationInfo1,
+        const Clock& clock) :
+   logger(logger1),
+   level(level1),
+   ndc(0),
+   mdcCopy(0),
+   properties(0),
+   fields(0),
+   ndcLookupRequired(true),
+   mdcCopyLookupRequired(true),
+   message(message1),
+   supplier(),
+   timeStamp(0),
+   nanos(0),
+   locationInfo(locationInfo1),
+   threadName(getCurrentThreadName()) {
+   log4cxx_int64_t now = clock.currentTimeNanos();
+   timeStamp = now / 1000;
+   nanos = (int) (now - ((log4cxx_int64_t) timeStamp) * 1000);
+}
+
+LoggingEvent::LoggingEvent(
+        const LogString& logger1, const LevelPtr& level1,
+        const MessageSupplierPtr& supplier1, const LocationInfo& locationInfo1,
+        const Clock& clock) :
+   logger(logger1),
+   level(level1),
+   ndc(0),
+   mdcCopy(0),
+   properties(0),
+   fields(0),
+   ndcLookupRequired(true),
+   mdcCopyLookupRequired(true),
+   message(),
+   supplier(supplier1),
+   timeStamp(0),
+   nanos(0),
+   locationInfo(locationInfo1),
+   threadName(getCurrentThreadName()) {
+   log4cxx_int64_t now = clock.currentTimeNanos();
+   timeStamp = now / 1000;
+   nanos = (int) (now - ((log4cxx_int64_t) timeStamp) * 1000);
+}
+
 LoggingEvent::~LoggingEvent()
 {
-        delete ndc;
-        delete mdcCopy;
+        if (ndc != 0) {
+            ndc->releaseRef();
+        }
+        if (mdcCopy != 0) {
+            mdcCopy->releaseRef();
+        }
         delete properties;
+        delete fields;
 }
 
-bool LoggingEvent::getNDC(LogString& dest) const
+void LoggingEvent::supplyMessage() const
+{
+        MessageSupplierPtr current(supplier);
+        supplier = 0;
+        current->supply(message);
+}
+
+void LoggingEvent::detachSupplier() const
+{
+        if (supplier != 0 && apr_atomic_read32(&ref) > 1)
+        {
+                supplyMessage();
+        }
+}
+
+void LoggingEvent::getNDCCopy() const
 {
         if(ndcLookupRequired)
         {
                 ndcLookupRequired = false;
-                LogString val;
-                if(NDC::get(val)) {
-                     ndc = new LogString(val);
+                ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
+                if (data != 0) {
+                     ndc = data->getNDCSnapshot();
                 }
         }
+}
+
+bool LoggingEvent::getNDC(LogString& dest) const
+{
+        getNDCCopy();
         if (ndc) {
-            dest.append(*ndc);
+            dest.append(ndc->getFullMessage());
             return true;
         }
         return false;
 }
 
 bool LoggingEvent::getMDC(const LogString& key, LogString& dest) const
+{
+        int handle;
+        if (MDC::findKey(key, handle))
+        {
+                return getMDC(handle, dest);
+        }
+        return false;
+}
+
+bool LoggingEvent::getMDC(int key, LogString& dest) const
 {
    // Note the mdcCopy is used if it exists. Otherwise we use the MDC
-    // that is associated with the thread.
-    if (mdcCopy != 0 && !mdcCopy->empty())
+    // that is associated with the thread.  Once taken, the copy is
+    // authoritative, keys set on the thread afterwards are not seen.
+    if (mdcCopy != 0)
         {
-                MDC::Map::const_iterator it = mdcCopy->find(key);
+                const LogString* value = mdcCopy->get(key);
 
-                if (it != mdcCopy->end())
+                if (value != 0 && !value->empty())
                 {
-                        if (!it->second.empty())
-                        {
-                                dest.append(it->second);
-                                return true;
-                        }
+                        dest.append(*value);
+                        return true;
                 }
+                return false;
     }
 
     return MDC::get(key, dest);
@@ -128,12 +224,12 @@ LoggingEvent::KeySet LoggingEvent::getMDCKeySet() const
 {
         LoggingEvent::KeySet set;
 
-        if (mdcCopy != 0 && !mdcCopy->empty())
+        if (mdcCopy != 0)
         {
-                MDC::Map::const_iterator it;
+                MDCMap::const_iterator it;
                 for (it = mdcCopy->begin(); it != mdcCopy->end(); it++)
                 {
-                        set.push_back(it->first);
+                        set.push_back(MDC::getKeyName(it->first));
 
                 }
         }
@@ -141,14 +237,18 @@ LoggingEvent::KeySet LoggingEvent::getMDCKeySet() const
         {
                 ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
                 if (data != 0) {
-                    MDC::Map& m = data->getMap();
+                    const MDCMap& m = data->getMDCMap();
 
-                    for(MDC::Map::const_iterator it = m.begin(); it != m.end(); it++) {
-                        set.push_back(it->first);
+                    for(MDCMap::const_iterator it = m.begin(); it != m.end(); it++) {
+                        set.push_back(MDC::getKeyName(it->first));
                     }
                 }
         }
 
+        //
+        //   handles follow the order of first use, keep the
+        //      alphabetical order of the former map
+        std::sort(set.begin(), set.end());
         return set;
 }
 
@@ -160,9 +260,11 @@ void LoggingEvent::getMDCCopy() const
                 // the clone call is required for asynchronous logging.
                 ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
                 if (data != 0) {
-                    mdcCopy = new MDC::Map(data->getMap());
+                    mdcCopy = data->getMDCSnapshot();
                 } else {
-                    mdcCopy = new MDC::Map();
+                    MDCMap* empty = new MDCMap();
+                    empty->addRef();
+                    mdcCopy = empty;
                 }
        }
 }
@@ -235,6 +337,60 @@ void LoggingEvent::setProperty(const LogString& key, const LogString& value)
 
 
 
+void LoggingEvent::addField(const Field& field)
+{
+        if (fields == 0)
+        {
+                fields = new FieldList();
+                fields->reserve(INITIAL_FIELD_CAPACITY);
+        }
+        fields->push_back(field);
+}
+
+void LoggingEvent::addFields(const FieldList& src)
+{
+        if (src.empty())
+        {
+                return;
+        }
+        if (fields == 0)
+        {
+                fields = new FieldList(src);
+        }
+        else
+        {
+                fields->insert(fields->end(), src.begin(), src.end());
+        }
+}
+
+const FieldList& LoggingEvent::getFields() const
+{
+        static const FieldList empty;
+        if (fields == 0)
+        {
+                return empty;
+        }
+        return *fields;
+}
+
+const Field* LoggingEvent::getField(const LogString& key) const
+{
+        if (fields != 0)
+        {
+                for(FieldList::const_iterator iter = fields->begin();
+                    iter != fields->end();
+                    iter++)
+                {
+                        if (iter->getKey() == key)
+                        {
+                                return &(*iter);
+                        }
+                }
+        }
+        return 0;
+}
+
+
 void LoggingEvent::writeProlog(ObjectOutputStream& os, Pool& p)  {
      char classDesc[] = {
         0x72, 0x00, 0x21, 
@@ -303,17 +459,24 @@ void LoggingEvent::write(helpers::ObjectOutputStream& os, Pool& p) const {
       os.writeLong(timeStamp/1000, p);
       os.writeObject(logger, p);
       locationInfo.write(os, p);
-      if (mdcCopy == 0 || mdcCopy->size() == 0) {
+      //
+      //   typed fields travel with the MDC as the
+      //      properties of a log4j 1.2 event do
+      if ((mdcCopy == 0 || mdcCopy->size() == 0) && fields == 0) {
           os.writeNull(p);
       } else {
-          os.writeObject(*mdcCopy, p);
+          MDC::Map map;
+          if (mdcCopy != 0) {
+              mdcCopy->toMap(map);
+          }
+          os.writeObject(map, getFields(), p);
       }
       if (ndc == 0) {
           os.writeNull(p);
       } else {
-          os.writeObject(*ndc, p);
+          os.writeObject(ndc->getFullMessage(), p);
       }
-      os.writeObject(message, p);
+      os.writeObject(getMessage(), p);
       os.writeObject(threadName, p);
       //  throwable
       os.writeNull(p);
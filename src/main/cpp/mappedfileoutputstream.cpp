@@ -0,0 +1,366 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/loglog.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#include <apr_thread_proc.h>
+#if !defined(LOG4CXX)
+#define LOG4CXX 1
+#endif
+#include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <string.h>
+#if LOG4CXX_HAS_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(MappedFileOutputStream)
+
+MappedFileOutputStream::MappedFileOutputStream(const LogString& filename,
+    bool append, size_t windowSize1)
+    : pool(), fileptr(0), fd(-1), windowSize(windowSize1), length(0),
+      mutex(pool), windowMapped(pool), windowWanted(pool),
+      nextReady(false), mapStatus(APR_SUCCESS), closed(false), thread() {
+    current.base = 0;
+    current.start = 0;
+    next = current;
+    retired = current;
+#if LOG4CXX_HAS_MMAP
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    windowSize = ((windowSize + pageSize - 1) / pageSize) * pageSize;
+    if (windowSize == 0) {
+        windowSize = pageSize;
+    }
+    //
+    //   a shared writable mapping needs the file open for reading
+    apr_int32_t flags = APR_READ | APR_WRITE | APR_CREATE;
+    if (!append) {
+        flags |= APR_TRUNCATE;
+    }
+    File fn;
+    fn.setPath(filename);
+    apr_status_t stat = fn.open(&fileptr, flags, APR_OS_DEFAULT, pool);
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+    apr_os_file_t osfile;
+    stat = apr_os_file_get(&osfile, fileptr);
+    apr_off_t end = 0;
+    if (stat == APR_SUCCESS) {
+        fd = osfile;
+    }
+    if (stat == APR_SUCCESS && append) {
+        stat = apr_file_seek(fileptr, APR_END, &end);
+        length = end;
+        if (stat == APR_SUCCESS) {
+            stat = trimZeroTail(length);
+        }
+    }
+    if (stat == APR_SUCCESS) {
+        stat = map(current, length - length % pageSize);
+    }
+    if (stat != APR_SUCCESS) {
+        apr_file_close(fileptr);
+        throw IOException(stat);
+    }
+#if APR_HAS_THREADS
+    thread.run(mapper, this);
+#endif
+#else
+    throw IOException(APR_ENOTIMPL);
+#endif
+}
+
+MappedFileOutputStream::~MappedFileOutputStream() {
+    if (fileptr != NULL && !APRInitializer::isDestructed) {
+        try {
+            Pool p;
+            close(p);
+        } catch(std::exception&) {
+        }
+    }
+}
+
+bool MappedFileOutputStream::isSupported() {
+#if LOG4CXX_HAS_MMAP
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MappedFileOutputStream::close(Pool& /* p */) {
+    {
+        synchronized sync(mutex);
+        if (closed) {
+            return;
+        }
+        closed = true;
+        windowWanted.signalAll();
+        windowMapped.signalAll();
+    }
+#if APR_HAS_THREADS
+    try {
+        thread.join();
+    } catch(InterruptedException& e) {
+        Thread::currentThreadInterrupt();
+        LogLog::error(LOG4CXX_STR("Got an InterruptedException while waiting for the mapper to finish,"), e);
+    }
+#endif
+    unmap(current);
+    unmap(next);
+    unmap(retired);
+    apr_status_t stat = APR_SUCCESS;
+#if LOG4CXX_HAS_MMAP
+    //
+    //   drop the allocated but unwritten end of the last window
+    if (ftruncate(fd, (off_t) length) != 0) {
+        stat = APR_FROM_OS_ERROR(errno);
+    }
+#endif
+    apr_status_t closeStat = apr_file_close(fileptr);
+    fileptr = NULL;
+    if (stat == APR_SUCCESS) {
+        stat = closeStat;
+    }
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+}
+
+/**
+ *  Bytes copied into the mapping are already visible to readers
+ *  of the file and are written to disk by the operating system.
+ */
+void MappedFileOutputStream::flush(Pool& /* p */) {
+}
+
+/**
+ *  Syncing the file also writes pages modified through the
+ *  mapping on Linux, where msync is not needed.
+ */
+void MappedFileOutputStream::sync(Pool& /* p */) {
+    if (fileptr == NULL) {
+        throw IOException(-1);
+    }
+    FileOutputStream::datasync(fileptr);
+}
+
+void MappedFileOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
+    if (current.base == 0) {
+        throw IOException(-1);
+    }
+    const char* data = buf.current();
+    size_t nbytes = buf.remaining();
+    while(nbytes > 0) {
+        size_t offset = (size_t) (length - current.start);
+        if (offset >= windowSize) {
+            nextWindow();
+            offset = (size_t) (length - current.start);
+        }
+        size_t count = windowSize - offset;
+        if (count > nbytes) {
+            count = nbytes;
+        }
+        memcpy(current.base + offset, data, count);
+        data += count;
+        nbytes -= count;
+        length += count;
+    }
+    buf.position(buf.limit());
+}
+
+/**
+ *  Removes the zero bytes that follow the written bytes when a
+ *  previous process ended without close, so that appending
+ *  continues after the last written byte.
+ *  @param end length of the file, receives the length once trimmed.
+ */
+log4cxx_status_t MappedFileOutputStream::trimZeroTail(log4cxx_int64_t& end) {
+#if LOG4CXX_HAS_MMAP
+    apr_off_t trimmed = end;
+    char buf[4096];
+    while(trimmed > 0) {
+        apr_off_t pos = trimmed > (apr_off_t) sizeof(buf) ?
+            trimmed - (apr_off_t) sizeof(buf) : 0;
+        apr_size_t len = (apr_size_t) (trimmed - pos);
+        apr_status_t stat = apr_file_seek(fileptr, APR_SET, &pos);
+        if (stat == APR_SUCCESS) {
+            stat = apr_file_read_full(fileptr, buf, len, &len);
+        }
+        if (stat != APR_SUCCESS) {
+            return stat;
+        }
+        while(len > 0 && buf[len - 1] == 0) {
+            len--;
+        }
+        trimmed = pos + len;
+        if (len > 0) {
+            break;
+        }
+    }
+    if (trimmed < (apr_off_t) end) {
+        if (ftruncate(fd, (off_t) trimmed) != 0) {
+            return APR_FROM_OS_ERROR(errno);
+        }
+        end = trimmed;
+    }
+    return apr_file_seek(fileptr, APR_SET, &trimmed);
+#else
+    return APR_ENOTIMPL;
+#endif
+}
+
+/**
+ *  Allocates the window starting at start and maps it.
+ */
+log4cxx_status_t MappedFileOutputStream::map(Window& window, log4cxx_int64_t start) {
+#if LOG4CXX_HAS_MMAP
+    bool allocated = false;
+#if LOG4CXX_HAS_POSIX_FALLOCATE
+    //
+    //   reserve the blocks now so a full disk fails here
+    //      rather than when a page of the mapping is first written,
+    //      only a file system without support falls back to
+    //      extending the file, which does not reserve blocks
+    int err = posix_fallocate(fd, (off_t) start, (off_t) windowSize);
+    if (err == 0) {
+        allocated = true;
+    } else if (err != EOPNOTSUPP && err != EINVAL) {
+        return APR_FROM_OS_ERROR(err);
+    }
+#endif
+    if (!allocated) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            return APR_FROM_OS_ERROR(errno);
+        }
+        if (st.st_size < start + (log4cxx_int64_t) windowSize
+            && ftruncate(fd, (off_t) (start + windowSize)) != 0) {
+            return APR_FROM_OS_ERROR(errno);
+        }
+    }
+    void* addr = mmap(0, windowSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) start);
+    if (addr == MAP_FAILED) {
+        return APR_FROM_OS_ERROR(errno);
+    }
+    window.base = (char*) addr;
+    window.start = start;
+    return APR_SUCCESS;
+#else
+    return APR_ENOTIMPL;
+#endif
+}
+
+void MappedFileOutputStream::unmap(Window& window) {
+#if LOG4CXX_HAS_MMAP
+    if (window.base != 0) {
+        munmap(window.base, windowSize);
+    }
+#endif
+    window.base = 0;
+}
+
+/**
+ *  Replaces the filled current window with the following one,
+ *  waiting for the mapper thread if it has not mapped it yet.
+ */
+void MappedFileOutputStream::nextWindow() {
+#if APR_HAS_THREADS
+    synchronized sync(mutex);
+    while(!nextReady && mapStatus == APR_SUCCESS && !closed) {
+        windowMapped.await(mutex);
+    }
+    if (!nextReady) {
+        //
+        //   let the mapper try again on the next write
+        log4cxx_status_t stat = (mapStatus != APR_SUCCESS) ? mapStatus : -1;
+        mapStatus = APR_SUCCESS;
+        windowWanted.signalAll();
+        throw IOException(stat);
+    }
+    retired = current;
+    current = next;
+    next.base = 0;
+    nextReady = false;
+    windowWanted.signalAll();
+#else
+    Window window;
+    log4cxx_status_t stat = map(window, current.start + windowSize);
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+    unmap(current);
+    current = window;
+#endif
+}
+
+void* LOG4CXX_THREAD_FUNC MappedFileOutputStream::mapper(apr_thread_t* /* thread */, void* data) {
+    MappedFileOutputStream* pThis = (MappedFileOutputStream*) data;
+    try {
+        for(;;) {
+            Window filled;
+            log4cxx_int64_t start = 0;
+            {
+                synchronized sync(pThis->mutex);
+                while(!pThis->closed
+                    && (pThis->nextReady || pThis->mapStatus != APR_SUCCESS)) {
+                    pThis->windowWanted.await(pThis->mutex);
+                }
+                if (pThis->closed) {
+                    break;
+                }
+                filled = pThis->retired;
+                pThis->retired.base = 0;
+                start = pThis->current.start + pThis->windowSize;
+            }
+            pThis->unmap(filled);
+            Window window;
+            window.base = 0;
+            log4cxx_status_t stat = pThis->map(window, start);
+            {
+                synchronized sync(pThis->mutex);
+                if (stat == APR_SUCCESS) {
+                    pThis->next = window;
+                    pThis->nextReady = true;
+                } else {
+                    pThis->mapStatus = stat;
+                }
+                pThis->windowMapped.signalAll();
+            }
+        }
+    } catch(InterruptedException& ex) {
+        Thread::currentThreadInterrupt();
+    } catch(...) {
+    }
+    return 0;
+}
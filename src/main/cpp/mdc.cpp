@@ -18,6 +18,10 @@
 #include <log4cxx/mdc.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/threadspecificdata.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <apr_atomic.h>
 
 #if LOG4CXX_CFSTRING_API
 #include <CoreFoundation/CFString.h>
@@ -27,6 +31,172 @@
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+namespace {
+    /**
+     *  Process wide table of interned MDC keys.  Key names are
+     *  appended to chunks that are never moved, and handles are
+     *  found through an open addressing index, so lookups do not
+     *  lock and adding a key copies no earlier entries except when
+     *  the index doubles.  Nothing is ever freed since readers may
+     *  still use it, and the table is never destroyed so that
+     *  the MDC remains usable while static objects are destroyed.
+     */
+    class KeyTable {
+    public:
+        static KeyTable& getInstance() {
+            static KeyTable* table = new KeyTable();
+            return *table;
+        }
+
+        int getKey(const LogString& key) {
+            int handle;
+            if (findKey(key, handle)) {
+                return handle;
+            }
+            synchronized sync(mutex);
+            if (findKey(key, handle)) {
+                return handle;
+            }
+            handle = (int) count;
+            int offset;
+            int chunk = locate(handle, offset);
+            if (offset == 0) {
+                chunks[chunk] = new const LogString*[FIRST_CHUNK << chunk];
+            }
+            chunks[chunk][offset] = new LogString(key);
+            //
+            //   the name is published before any index slot refers to it
+            apr_atomic_inc32(&count);
+            if (2 * count > index->capacity) {
+                Index* grown = new Index(2 * index->capacity);
+                for(int i = 0; i <= handle; i++) {
+                    insert(grown, i);
+                }
+                apr_atomic_xchgptr((volatile void**) &index, grown);
+            } else {
+                insert(index, handle);
+            }
+            return handle;
+        }
+
+        bool findKey(const LogString& key, int& handle) const {
+            const Index* current = getIndex();
+            apr_uint32_t mask = current->capacity - 1;
+            for(apr_uint32_t i = hash(key) & mask;; i = (i + 1) & mask) {
+                apr_uint32_t slot = apr_atomic_cas32(&current->slots[i], 0, 0);
+                if (slot == 0) {
+                    return false;
+                }
+                if (getKeyName(slot - 1) == key) {
+                    handle = slot - 1;
+                    return true;
+                }
+            }
+        }
+
+        const LogString& getKeyName(int handle) const {
+            if (handle >= 0 && handle < (int) apr_atomic_cas32(&count, 0, 0)) {
+                int offset;
+                int chunk = locate(handle, offset);
+                return *chunks[chunk][offset];
+            }
+            static const LogString empty;
+            return empty;
+        }
+
+    private:
+        /**
+         *  Chunk sizes double, so MAX_CHUNKS chunks
+         *  hold more keys than an int can number.
+         */
+        enum { FIRST_CHUNK = 64, MAX_CHUNKS = 26 };
+
+        /**
+         *  Open addressing index of handles.  A slot holds
+         *  a handle plus one, zero if the slot is empty.
+         */
+        struct Index {
+            Index(apr_uint32_t capacity1) :
+                capacity(capacity1), slots(new volatile apr_uint32_t[capacity1]) {
+                for(apr_uint32_t i = 0; i < capacity; i++) {
+                    slots[i] = 0;
+                }
+            }
+            const apr_uint32_t capacity;
+            volatile apr_uint32_t* const slots;
+        };
+
+        KeyTable() : pool(), mutex(pool), count(0), index(new Index(FIRST_CHUNK)) {
+            for(int i = 0; i < MAX_CHUNKS; i++) {
+                chunks[i] = 0;
+            }
+        }
+
+        KeyTable(const KeyTable&);
+        KeyTable& operator=(const KeyTable&);
+
+        /**
+         *  Finds the chunk holding a handle.
+         *  @param handle key handle.
+         *  @param offset receives the position in the chunk.
+         *  @return chunk number.
+         */
+        static int locate(int handle, int& offset) {
+            int chunk = 0;
+            int first = 0;
+            while(handle - first >= (FIRST_CHUNK << chunk)) {
+                first += FIRST_CHUNK << chunk;
+                chunk++;
+            }
+            offset = handle - first;
+            return chunk;
+        }
+
+        static apr_uint32_t hash(const LogString& key) {
+            apr_uint32_t h = 2166136261U;
+            for(LogString::const_iterator iter = key.begin();
+                iter != key.end();
+                iter++) {
+                h = (h ^ (apr_uint32_t) *iter) * 16777619U;
+            }
+            return h;
+        }
+
+        /**
+         *  Adds a handle to an index, called with the mutex held.
+         */
+        void insert(Index* target, int handle) const {
+            apr_uint32_t mask = target->capacity - 1;
+            apr_uint32_t i = hash(getKeyName(handle)) & mask;
+            while(target->slots[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            apr_atomic_xchg32(&target->slots[i], handle + 1);
+        }
+
+        /**
+         *  Gets the published index.  The index is never null,
+         *  so the compare and swap never stores and only serves as
+         *  a read with a full memory barrier.
+         */
+        const Index* getIndex() const {
+            return (const Index*) apr_atomic_casptr((volatile void**) &index, 0, 0);
+        }
+
+        Pool pool;
+        /**
+         *  Serializes adding keys.
+         */
+        Mutex mutex;
+        /**
+         *  Number of interned keys.
+         */
+        mutable volatile apr_uint32_t count;
+        const LogString** volatile chunks[MAX_CHUNKS];
+        Index* volatile index;
+    };
+}
+
 MDC::MDC(const std::string& key1, const std::string& value) : key()
 {
         Transcoder::decode(key1, key);
@@ -42,7 +212,7 @@ MDC::~MDC()
 
 void MDC::putLS(const LogString& key, const LogString& value)
 {
-        ThreadSpecificData::put(key, value);
+        ThreadSpecificData::put(getKey(key), value);
 }
 
 void MDC::put(const std::string& key, const std::string& value)
@@ -53,14 +223,21 @@ void MDC::put(const std::string& key, const std::string& value)
 }
 
 bool MDC::get(const LogString& key, LogString& value)
+{
+        int handle;
+        if (findKey(key, handle)) {
+            return get(handle, value);
+        }
+        return false;
+}
+
+bool MDC::get(int handle, LogString& value)
 {
         ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
         if (data != 0) {
-            Map& map = data->getMap();
-
-            Map::iterator it = map.find(key);
-            if (it != map.end()) {
-                value.append(it->second);
+            const LogString* current = data->getMDCMap().get(handle);
+            if (current != 0) {
+                value.append(*current);
                 return true;
             }
             data->recycle();
@@ -81,13 +258,11 @@ std::string MDC::get(const std::string& key)
 
 bool MDC::remove(const LogString& key, LogString& value)
 {
+        int handle;
         ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
-        if (data != 0) {
-            Map& map = data->getMap();
-            Map::iterator it;
-            if ((it = map.find(key)) != map.end()) {
-                value = it->second;
-                map.erase(it);
+        if (data != 0 && findKey(key, handle)) {
+            if (data->getMDCMap().get(handle) != 0) {
+                data->getWritableMDCMap().remove(handle, value);
                 data->recycle();
                 return true;
             }
@@ -107,12 +282,28 @@ std::string MDC::remove(const std::string& key)
 }
 
 
+int MDC::getKey(const LogString& key)
+{
+        return KeyTable::getInstance().getKey(key);
+}
+
+bool MDC::findKey(const LogString& key, int& handle)
+{
+        return KeyTable::getInstance().findKey(key, handle);
+}
+
+const LogString& MDC::getKeyName(int handle)
+{
+        return KeyTable::getInstance().getKeyName(handle);
+}
+
 void MDC::clear()
 {
         ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
         if (data != 0) {
-            Map& map = data->getMap();
-            map.erase(map.begin(), map.end());
+            if (!data->getMDCMap().empty()) {
+                data->getWritableMDCMap().clear();
+            }
             data->recycle();
         }
 }
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/mdcmap.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(MDCMap)
+
+namespace {
+    /**
+     *  Number of entries reserved on the first put.
+     */
+    const size_t INITIAL_CAPACITY = 8;
+}
+
+MDCMap::MDCMap() : entries() {
+}
+
+MDCMap::MDCMap(const MDCMap& src) : ObjectImpl(), entries(src.entries) {
+}
+
+MDCMap::~MDCMap() {
+}
+
+MDCMap::EntryList::iterator MDCMap::lowerBound(int key) {
+    EntryList::iterator iter = entries.begin();
+    while(iter != entries.end() && iter->first < key) {
+        iter++;
+    }
+    return iter;
+}
+
+const LogString* MDCMap::get(int key) const {
+    for(EntryList::const_iterator iter = entries.begin();
+        iter != entries.end() && iter->first <= key;
+        iter++) {
+        if (iter->first == key) {
+            return &iter->second;
+        }
+    }
+    return 0;
+}
+
+void MDCMap::put(int key, const LogString& value) {
+    EntryList::iterator iter = lowerBound(key);
+    if (iter != entries.end() && iter->first == key) {
+        iter->second = value;
+    } else {
+        if (entries.capacity() == 0) {
+            size_t offset = iter - entries.begin();
+            entries.reserve(INITIAL_CAPACITY);
+            iter = entries.begin() + offset;
+        }
+        entries.insert(iter, Entry(key, value));
+    }
+}
+
+bool MDCMap::remove(int key, LogString& value) {
+    EntryList::iterator iter = lowerBound(key);
+    if (iter != entries.end() && iter->first == key) {
+        value = iter->second;
+        entries.erase(iter);
+        return true;
+    }
+    return false;
+}
+
+void MDCMap::clear() {
+    entries.clear();
+}
+
+void MDCMap::toMap(MDC::Map& map) const {
+    for(EntryList::const_iterator iter = entries.begin();
+        iter != entries.end();
+        iter++) {
+        map[MDC::getKeyName(iter->first)] = iter->second;
+    }
+}
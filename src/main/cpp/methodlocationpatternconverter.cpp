@@ -47,5 +47,6 @@ void MethodLocationPatternConverter::format(
   const LoggingEventPtr& event,
   LogString& toAppendTo,
   Pool& /* p */ ) const {
-   append(toAppendTo, event->getLocationInformation().getMethodName());
+   LogString buf;
+   toAppendTo.append(event->getLocationInformation().getMethodName(buf));
  }
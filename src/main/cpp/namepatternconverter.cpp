@@ -23,10 +23,13 @@
 #include <log4cxx/pattern/namepatternconverter.h>
 #include <log4cxx/pattern/nameabbreviator.h>
 #include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <apr_atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::pattern;
 using namespace log4cxx::spi;
+using namespace log4cxx::helpers;
 
 IMPLEMENT_LOG4CXX_OBJECT(NamePatternConverter)
 
@@ -35,7 +38,21 @@ NamePatternConverter::NamePatternConverter(
     const LogString& style1,
     const std::vector<LogString>& options) :
     LoggingEventPatternConverter(name1, style1),
-    abbreviator(getAbbreviator(options)) {
+    abbreviator(getAbbreviator(options)),
+    cacheAbbreviations(abbreviator != NameAbbreviator::getDefaultAbbreviator()),
+    abbreviations(new AbbreviationMap()),
+    retired(),
+    pool(),
+    mutex(pool) {
+}
+
+NamePatternConverter::~NamePatternConverter() {
+    delete abbreviations;
+    for(std::vector<const AbbreviationMap*>::iterator iter = retired.begin();
+        iter != retired.end();
+        iter++) {
+        delete *iter;
+    }
 }
 
 NameAbbreviatorPtr NamePatternConverter::getAbbreviator(
@@ -54,3 +71,40 @@ NameAbbreviatorPtr NamePatternConverter::getAbbreviator(
 void NamePatternConverter::abbreviate(int nameStart, LogString& buf) const {
     abbreviator->abbreviate(nameStart, buf);
 }
+
+void NamePatternConverter::appendAbbreviated(const LogString& name, LogString& toAppendTo) const {
+    if (!cacheAbbreviations) {
+        toAppendTo.append(name);
+        return;
+    }
+
+    //
+    //   the map is never null, so the compare and swap never stores
+    //      and only serves as a read with a full memory barrier
+    //      that pairs with the exchange that published the map
+    const AbbreviationMap* current = (const AbbreviationMap*)
+        apr_atomic_casptr((volatile void**) &abbreviations, 0, 0);
+    AbbreviationMap::const_iterator iter = current->find(name);
+    if (iter != current->end()) {
+        toAppendTo.append(iter->second);
+        return;
+    }
+
+    LogString abbreviated(name);
+    abbreviator->abbreviate(0, abbreviated);
+    toAppendTo.append(abbreviated);
+
+    //
+    //   once the map is full, misses do not take the lock
+    if (current->size() >= MAX_ABBREVIATIONS) {
+        return;
+    }
+    synchronized sync(mutex);
+    current = abbreviations;
+    if (current->size() < MAX_ABBREVIATIONS && current->find(name) == current->end()) {
+        AbbreviationMap* extended = new AbbreviationMap(*current);
+        extended->insert(AbbreviationMap::value_type(name, abbreviated));
+        retired.push_back(current);
+        apr_atomic_xchgptr((volatile void**) &abbreviations, extended);
+    }
+}
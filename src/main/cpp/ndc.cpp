@@ -23,6 +23,7 @@
 #include <log4cxx/ndc.h>
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/threadspecificdata.h>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -38,11 +39,11 @@ NDC::~NDC()
 }
 
 
-LogString& NDC::getMessage(NDC::DiagnosticContext& ctx) {
+const LogString& NDC::getMessage(const NDC::DiagnosticContext& ctx) {
     return ctx.first;
 }
 
-LogString& NDC::getFullMessage(NDC::DiagnosticContext& ctx) {
+const LogString& NDC::getFullMessage(const NDC::DiagnosticContext& ctx) {
     return ctx.second;
 }
 
@@ -50,10 +51,7 @@ void NDC::clear()
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        while(!stack.empty()) {
-          stack.pop();
-        }
+        data->setNDC(0);
         data->recycle();
     }
 }
@@ -62,10 +60,17 @@ NDC::Stack* NDC::cloneStack()
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if (!stack.empty()) {
-            return new Stack(stack);
+        std::vector<const NDCNode*> frames;
+        for(const NDCNode* node = data->getNDC(); node != 0; node = node->getParent()) {
+            frames.push_back(node);
+        }
+        Stack* stack = new Stack();
+        for(std::vector<const NDCNode*>::reverse_iterator iter = frames.rbegin();
+            iter != frames.rend();
+            iter++) {
+            stack->push(DiagnosticContext((*iter)->getMessage(), (*iter)->getFullMessage()));
         }
+        return stack;
     }
     return new Stack();
 }
@@ -82,9 +87,9 @@ bool NDC::get(LogString& dest)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty()) {
-                dest.append(getFullMessage(stack.top()));
+        const NDCNode* top = data->getNDC();
+        if(top != 0) {
+                dest.append(top->getFullMessage());
                 return true;
         }
         data->recycle();
@@ -96,7 +101,10 @@ int NDC::getDepth() {
     int size = 0;
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        size = data->getStack().size();
+        const NDCNode* top = data->getNDC();
+        if (top != 0) {
+            size = top->getDepth();
+        }
         if (size == 0) {
             data->recycle();
         }
@@ -108,11 +116,11 @@ LogString NDC::pop()
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                LogString value(getMessage(stack.top()));
-                stack.pop();
+                LogString value(top->getMessage());
+                data->popNDC();
                 data->recycle();
                 return value;
         }
@@ -126,11 +134,11 @@ bool NDC::pop(std::string& dst)
     bool retval = false;
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(getMessage(stack.top()), dst);
-                stack.pop();
+                Transcoder::encode(top->getMessage(), dst);
+                data->popNDC();
                 retval = true;
         }
         data->recycle();
@@ -142,10 +150,10 @@ LogString NDC::peek()
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                return getMessage(stack.top());
+                return top->getMessage();
         }
         data->recycle();
     }
@@ -156,10 +164,10 @@ bool NDC::peek(std::string& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(getMessage(stack.top()), dst);
+                Transcoder::encode(top->getMessage(), dst);
                 return true;
         }
         data->recycle();
@@ -187,8 +195,7 @@ bool NDC::empty() {
     bool empty = true;
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        empty = stack.empty();
+        empty = (data->getNDC() == 0);
         if (empty) {
             data->recycle();
         }
@@ -212,11 +219,11 @@ bool NDC::pop(std::wstring& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(getMessage(stack.top()), dst);
-                stack.pop();
+                Transcoder::encode(top->getMessage(), dst);
+                data->popNDC();
                 data->recycle();
                 return true;
         }
@@ -229,10 +236,10 @@ bool NDC::peek(std::wstring& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(getMessage(stack.top()), dst);
+                Transcoder::encode(top->getMessage(), dst);
                 return true;
         }
         data->recycle();
@@ -259,11 +266,11 @@ bool NDC::pop(std::basic_string<UniChar>& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(stack.top().message, dst);
-                stack.pop();
+                Transcoder::encode(top->getMessage(), dst);
+                data->popNDC();
                 data->recycle();
                 return true;
         }
@@ -276,10 +283,10 @@ bool NDC::peek(std::basic_string<UniChar>& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                Transcoder::encode(stack.top().message, dst);
+                Transcoder::encode(top->getMessage(), dst);
                 return true;
         }
         data->recycle();
@@ -306,11 +313,11 @@ bool NDC::pop(CFStringRef& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                dst = Transcoder::encode(stack.top().message);
-                stack.pop();
+                dst = Transcoder::encode(top->getMessage());
+                data->popNDC();
                 data->recycle();
                 return true;
         }
@@ -323,10 +330,10 @@ bool NDC::peek(CFStringRef& dst)
 {
     ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
     if (data != 0) {
-        Stack& stack = data->getStack();
-        if(!stack.empty())
+        const NDCNode* top = data->getNDC();
+        if(top != 0)
         {
-                dst = Transcoder::encode(stack.top().message);
+                dst = Transcoder::encode(top->getMessage());
                 return true;
         }
         data->recycle();
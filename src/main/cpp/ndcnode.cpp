@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/ndcnode.h>
+#include <apr_atomic.h>
+#include <vector>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(NDCNode)
+
+NDCNode::NDCNode(const NDCNode* parent1, const LogString& message1)
+    : parent(parent1), message(message1),
+      depth(parent1 == 0 ? 1 : parent1->depth + 1), fullMessage(0) {
+    if (parent != 0) {
+        parent->addRef();
+    }
+}
+
+NDCNode::NDCNode(const NDCNode* parent1, const LogString& message1,
+                 const LogString& fullMessage1)
+    : parent(parent1), message(message1),
+      depth(parent1 == 0 ? 1 : parent1->depth + 1), fullMessage(0) {
+    if (parent != 0) {
+        parent->addRef();
+        if (fullMessage1 != message) {
+            fullMessage = new LogString(fullMessage1);
+        }
+    }
+}
+
+NDCNode::~NDCNode() {
+    delete (LogString*) fullMessage;
+    if (parent != 0) {
+        parent->releaseRef();
+    }
+}
+
+const LogString* NDCNode::getRenderedMessage() const {
+    if (parent == 0) {
+        return &message;
+    }
+    return (const LogString*) fullMessage;
+}
+
+const LogString& NDCNode::getFullMessage() const {
+    const LogString* rendered = getRenderedMessage();
+    if (rendered != 0) {
+        return *rendered;
+    }
+    //
+    //   collect the frames back to the nearest one
+    //      that is already rendered, the bottom frame always is
+    std::vector<const NDCNode*> frames;
+    size_t length = 0;
+    const NDCNode* node = this;
+    for(; (rendered = node->getRenderedMessage()) == 0; node = node->parent) {
+        frames.push_back(node);
+        length += node->message.length() + 1;
+    }
+    LogString* full = new LogString();
+    full->reserve(length + rendered->length());
+    full->append(*rendered);
+    for(std::vector<const NDCNode*>::reverse_iterator iter = frames.rbegin();
+        iter != frames.rend();
+        iter++) {
+        full->append(1, (logchar) 0x20);
+        full->append((*iter)->message);
+    }
+    //
+    //   another thread may have rendered the same node
+    void* prior = apr_atomic_casptr((volatile void**) &fullMessage, full, 0);
+    if (prior != 0) {
+        delete full;
+        return *(const LogString*) prior;
+    }
+    return *full;
+}
@@ -24,6 +24,7 @@
 #include <log4cxx/helpers/outputstream.h>
 #include <log4cxx/helpers/charsetencoder.h>
 #include "apr_pools.h"
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -78,6 +79,22 @@ void ObjectOutputStream::writeObject(const LogString& val, Pool& p) {
 
 
 void ObjectOutputStream::writeObject(const MDC::Map& val, Pool& p) {
+    static const spi::FieldList noFields;
+    writeObject(val, noFields, p);
+}
+
+bool ObjectOutputStream::isShadowed(const LogString& key,
+    spi::FieldList::const_iterator from, const spi::FieldList& fields) {
+    for(; from != fields.end(); from++) {
+        if (from->getKey() == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ObjectOutputStream::writeObject(const MDC::Map& val,
+    const spi::FieldList& fields, Pool& p) {
     //
     //  TC_OBJECT and the classDesc for java.util.Hashtable
     //
@@ -97,8 +114,25 @@ void ObjectOutputStream::writeObject(const MDC::Map& val, Pool& p) {
         TC_BLOCKDATA, 0x08, 0x00, 0x00, 0x00, 0x07 };
     ByteBuffer dataBuf(data, sizeof(data));
     os->write(dataBuf, p);
+    //
+    //   Hashtable rejects duplicate keys when read, so a field
+    //      hides an MDC entry or earlier field with the same key
     char size[4];
-    size_t sz = val.size();
+    size_t sz = 0;
+    for(MDC::Map::const_iterator iter = val.begin();
+        iter != val.end();
+        iter++) {
+        if (!isShadowed(iter->first, fields.begin(), fields)) {
+            sz++;
+        }
+    }
+    for(spi::FieldList::const_iterator field = fields.begin();
+        field != fields.end();
+        field++) {
+        if (!isShadowed(field->getKey(), field + 1, fields)) {
+            sz++;
+        }
+    }
     size[3] = (char) (sz & 0xFF);
     size[2] = (char) ((sz >> 8) & 0xFF);
     size[1] = (char) ((sz >> 16) & 0xFF);
@@ -108,12 +142,130 @@ void ObjectOutputStream::writeObject(const MDC::Map& val, Pool& p) {
     for(MDC::Map::const_iterator iter = val.begin();
         iter != val.end();
         iter++) {
-        writeObject(iter->first, p);
-        writeObject(iter->second, p);
+        if (!isShadowed(iter->first, fields.begin(), fields)) {
+            writeObject(iter->first, p);
+            writeObject(iter->second, p);
+        }
+    }
+    for(spi::FieldList::const_iterator field = fields.begin();
+        field != fields.end();
+        field++) {
+        if (!isShadowed(field->getKey(), field + 1, fields)) {
+            writeObject(field->getKey(), p);
+            writeObject(*field, p);
+        }
     }
     writeByte(TC_ENDBLOCKDATA, p);
 }
 
+void ObjectOutputStream::writeObject(const spi::Field& field, Pool& p) {
+    switch(field.getType()) {
+        case spi::Field::INT64:
+        {
+            //
+            //   TC_OBJECT and the classDesc for java.lang.Long
+            //      and its superclass java.lang.Number
+            //
+            char prolog[] = {
+                0x72, 0x00, 0x0E, 0x6A, 0x61, 0x76, 0x61, 0x2E,
+                0x6C, 0x61, 0x6E, 0x67, 0x2E, 0x4C, 0x6F, 0x6E,
+                0x67, 0x3B, 0x8B, 0xE4, 0x90, 0xCC, 0x8F, 0x23,
+                0xDF, 0x02, 0x00, 0x01, 0x4A, 0x00, 0x05, 0x76,
+                0x61, 0x6C, 0x75, 0x65, 0x78, 0x72, 0x00, 0x10,
+                0x6A, 0x61, 0x76, 0x61, 0x2E, 0x6C, 0x61, 0x6E,
+                0x67, 0x2E, 0x4E, 0x75, 0x6D, 0x62, 0x65, 0x72,
+                0x86, 0xAC, 0x95, 0x1D, 0x0B, 0x94, 0xE0, 0x8B,
+                0x02, 0x00, 0x00, 0x78, 0x70 };
+            writeProlog("java.lang.Long", 2, prolog, sizeof(prolog), p);
+            writeLong(field.getInt64(), p);
+        }
+        break;
+
+        case spi::Field::DOUBLE:
+        {
+            //
+            //   TC_OBJECT and the classDesc for java.lang.Double
+            //      and its superclass java.lang.Number
+            //
+            char prolog[] = {
+                0x72, 0x00, 0x10, 0x6A, 0x61, 0x76, 0x61, 0x2E,
+                0x6C, 0x61, 0x6E, 0x67, 0x2E, 0x44, 0x6F, 0x75,
+                0x62, 0x6C, 0x65, 0x80, 0xB3, 0xC2, 0x4A, 0x29,
+                0x6B, 0xFB, 0x04, 0x02, 0x00, 0x01, 0x44, 0x00,
+                0x05, 0x76, 0x61, 0x6C, 0x75, 0x65, 0x78, 0x72,
+                0x00, 0x10, 0x6A, 0x61, 0x76, 0x61, 0x2E, 0x6C,
+                0x61, 0x6E, 0x67, 0x2E, 0x4E, 0x75, 0x6D, 0x62,
+                0x65, 0x72, 0x86, 0xAC, 0x95, 0x1D, 0x0B, 0x94,
+                0xE0, 0x8B, 0x02, 0x00, 0x00, 0x78, 0x70 };
+            writeProlog("java.lang.Double", 2, prolog, sizeof(prolog), p);
+            //
+            //   IEEE 754 bits, written like a long
+            //
+            double val = field.getDouble();
+            log4cxx_int64_t bits;
+            memcpy(&bits, &val, sizeof(bits));
+            writeLong(bits, p);
+        }
+        break;
+
+        case spi::Field::BOOLEAN:
+        {
+            //
+            //   TC_OBJECT and the classDesc for java.lang.Boolean
+            //
+            char prolog[] = {
+                0x72, 0x00, 0x11, 0x6A, 0x61, 0x76, 0x61, 0x2E,
+                0x6C, 0x61, 0x6E, 0x67, 0x2E, 0x42, 0x6F, 0x6F,
+                0x6C, 0x65, 0x61, 0x6E, 0xCD, 0x20, 0x72, 0x80,
+                0xD5, 0x9C, 0xFA, 0xEE, 0x02, 0x00, 0x01, 0x5A,
+                0x00, 0x05, 0x76, 0x61, 0x6C, 0x75, 0x65, 0x78,
+                0x70 };
+            writeProlog("java.lang.Boolean", 1, prolog, sizeof(prolog), p);
+            writeByte(field.getBoolean() ? 1 : 0, p);
+        }
+        break;
+
+        case spi::Field::BYTES:
+        {
+            const char* className = "[B";
+            ClassDescriptionMap::const_iterator match = classDescriptions->find(className);
+            if (match != classDescriptions->end()) {
+                char bytes[6];
+                bytes[0] = TC_ARRAY;
+                bytes[1] = TC_REFERENCE;
+                bytes[2] = (char) ((match->second >> 24) & 0xFF);
+                bytes[3] = (char) ((match->second >> 16) & 0xFF);
+                bytes[4] = (char) ((match->second >> 8) & 0xFF);
+                bytes[5] = (char) (match->second & 0xFF);
+                ByteBuffer buf(bytes, sizeof(bytes));
+                os->write(buf, p);
+                objectHandle++;
+            } else {
+                //
+                //   TC_ARRAY and the classDesc for byte[]
+                //
+                char prolog[] = {
+                    TC_ARRAY,
+                    0x72, 0x00, 0x02, 0x5B, 0x42, 0xAC, 0xF3, 0x17,
+                    0xF8, 0x06, 0x08, 0x54, 0xE0, 0x02, 0x00, 0x00,
+                    0x78, 0x70 };
+                classDescriptions->insert(ClassDescriptionMap::value_type(className, objectHandle));
+                ByteBuffer buf(prolog, sizeof(prolog));
+                os->write(buf, p);
+                objectHandle += 2;
+            }
+            const std::string& data = field.getBytes();
+            writeInt((int) data.length(), p);
+            writeBytes(data.data(), data.length(), p);
+        }
+        break;
+
+        default:
+        writeObject(field.getString(), p);
+        break;
+    }
+}
+
 void ObjectOutputStream::writeUTFString(const std::string& val, Pool& p) {
     char bytes[3];
     size_t len = val.size();
@@ -17,6 +17,7 @@
 
 #include <log4cxx/logstring.h>
 #include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -28,3 +29,7 @@ OutputStream::OutputStream() {
 
 OutputStream::~OutputStream() {
 }
+
+void OutputStream::sync(Pool& p) {
+    flush(p);
+}
@@ -21,6 +21,7 @@
 #include <log4cxx/helpers/charsetencoder.h>
 #include <log4cxx/helpers/bytebuffer.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/formatbuffer.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -28,21 +29,23 @@ using namespace log4cxx::helpers;
 IMPLEMENT_LOG4CXX_OBJECT(OutputStreamWriter)
 
 OutputStreamWriter::OutputStreamWriter(OutputStreamPtr& out1)
-   : out(out1), enc(CharsetEncoder::getDefaultEncoder()) {
+   : out(out1), enc(CharsetEncoder::getDefaultEncoder()), identity(false) {
    if (out1 == 0) {
       throw NullPointerException(LOG4CXX_STR("out parameter may not be null."));
    }
+   identity = enc->isIdentity();
 }
 
 OutputStreamWriter::OutputStreamWriter(OutputStreamPtr& out1,
      CharsetEncoderPtr &enc1)
-    : out(out1), enc(enc1) {
+    : out(out1), enc(enc1), identity(false) {
     if (out1 == 0) {
        throw NullPointerException(LOG4CXX_STR("out parameter may not be null."));
     }
     if (enc1 == 0) {
        throw NullPointerException(LOG4CXX_STR("enc parameter may not be null."));
     }
+    identity = enc->isIdentity();
 }
 
 OutputStreamWriter::~OutputStreamWriter() {
@@ -57,22 +60,54 @@ void OutputStreamWriter::flush(Pool& p) {
 }
 
 void OutputStreamWriter::write(const LogString& str, Pool& p) {
-  if (str.length() > 0) {
+  if (identity) {
+    if (str.length() > 0) {
+      //
+      //   the stream only reads from the buffer
+      ByteBuffer buf((char*) str.data(), str.length() * sizeof(logchar));
+      out->write(buf, p);
+    }
+  } else if (str.length() > 0) {
     enum { BUFSIZE = 1024 };
-    char rawbuf[BUFSIZE];
-    ByteBuffer buf(rawbuf, (size_t) BUFSIZE);
+    //
+    //   encode the whole message into the thread's buffer
+    //      so it reaches the stream in a single write,
+    //      messages beyond the high water mark are written in pieces
+    EncodeBuffer storage;
+    std::vector<char>& bytes = storage.get();
+    size_t size = str.length() + BUFSIZE;
+    if (size > EncodeBuffer::HIGH_WATER) {
+        size = EncodeBuffer::HIGH_WATER;
+    }
+    if (bytes.size() < size) {
+        bytes.resize(size);
+    }
+    size_t used = 0;
     enc->reset();
     LogString::const_iterator iter = str.begin();
-    while(iter != str.end()) {
+    bool flushed = false;
+    while(!flushed) {
+      if (bytes.size() - used < BUFSIZE) {
+          if (bytes.size() < EncodeBuffer::HIGH_WATER) {
+              bytes.resize(bytes.size() * 2);
+          } else {
+              ByteBuffer buf(&bytes[0], used);
+              out->write(buf, p);
+              used = 0;
+          }
+      }
+      ByteBuffer buf(&bytes[0] + used, bytes.size() - used);
+      //
+      //   one final call once the input is consumed
+      //      lets stateful encoders return to the initial state
+      flushed = (iter == str.end());
       CharsetEncoder::encode(enc, str, iter, buf);
-      buf.flip();
-      out->write(buf, p);
-      buf.clear();
+      if (flushed) {
+          enc->flush(buf);
+      }
+      used += buf.position();
     }
-    CharsetEncoder::encode(enc, str, iter, buf);
-    enc->flush(buf);
-    buf.flip();
+    ByteBuffer buf(&bytes[0], used);
     out->write(buf, p);
   }
 }
-
@@ -45,7 +45,9 @@
 #include <log4cxx/pattern/threadpatternconverter.h>
 #include <log4cxx/pattern/ndcpatternconverter.h>
 #include <log4cxx/pattern/propertiespatternconverter.h>
+#include <log4cxx/pattern/fieldspatternconverter.h>
 #include <log4cxx/pattern/throwableinformationpatternconverter.h>
+#include <typeinfo>
 
 
 using namespace log4cxx;
@@ -93,6 +95,19 @@ void PatternLayout::format(LogString& output,
 
 }
 
+bool PatternLayout::isEquivalent(const Layout& other) const
+{
+  //
+  //   subclasses that do not declare their own class
+  //      share the class of PatternLayout, compare the dynamic type
+  if (typeid(other) != typeid(*this)) {
+      return false;
+  }
+  const PatternLayout* layout =
+      (const PatternLayout*) other.cast(PatternLayout::getStaticClass());
+  return layout->conversionPattern == conversionPattern;
+}
+
 void PatternLayout::setOption(const LogString& option, const LogString& value)
 {
         if (StringHelper::equalsIgnoreCase(option,
@@ -177,6 +192,9 @@ log4cxx::pattern::PatternMap PatternLayout::getFormatSpecifiers() {
   RULES_PUT("X", PropertiesPatternConverter);
   RULES_PUT("properties", PropertiesPatternConverter);
 
+  RULES_PUT("K", FieldsPatternConverter);
+  RULES_PUT("fields", FieldsPatternConverter);
+
   RULES_PUT("throwable", ThrowableInformationPatternConverter);
    return specs;
 }
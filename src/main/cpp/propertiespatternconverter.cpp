@@ -34,7 +34,8 @@ IMPLEMENT_LOG4CXX_OBJECT(PropertiesPatternConverter)
 PropertiesPatternConverter::PropertiesPatternConverter(const LogString& name1,
       const LogString& propertyName) :
    LoggingEventPatternConverter(name1,LOG4CXX_STR("property")),
-   option(propertyName) {
+   option(propertyName),
+   key(propertyName.empty() ? -1 : MDC::getKey(propertyName)) {
 }
 
 PatternConverterPtr PropertiesPatternConverter::newInstance(
@@ -74,7 +75,7 @@ void PropertiesPatternConverter::format(
       toAppendTo.append(1, (logchar) 0x7D /* '}' */);
 
     } else {
-      event->getMDC(option, toAppendTo);
+      event->getMDC(key, toAppendTo);
     }
  }
 
@@ -165,6 +165,18 @@ void PropertyConfigurator::doConfigure(helpers::Properties& properties,
                     + LOG4CXX_STR("]."));
         }
 
+        static const LogString CLOCK_PREFIX(LOG4CXX_STR("log4j.clock"));
+        LogString clockStr =
+                OptionConverter::findAndSubst(CLOCK_PREFIX, properties);
+
+        if (!clockStr.empty())
+        {
+                hierarchy->setClock(Clock::getClock(clockStr, hierarchy->getClock()));
+                LogLog::debug(((LogString) LOG4CXX_STR("Hierarchy clock set to ["))
+                    + clockStr
+                    + LOG4CXX_STR("]."));
+        }
+
         configureRootLogger(properties, hierarchy);
         configureLoggerFactory(properties);
         parseCatsAndRenderers(properties, hierarchy);
@@ -34,11 +34,28 @@ IMPLEMENT_LOG4CXX_OBJECT(RelativeTimePatternConverter)
 
 RelativeTimePatternConverter::RelativeTimePatternConverter() :
    LoggingEventPatternConverter(LOG4CXX_STR("Time"),
-      LOG4CXX_STR("time")) {
+      LOG4CXX_STR("time")), nanosPerUnit(1000000) {
+}
+
+RelativeTimePatternConverter::RelativeTimePatternConverter(int nanosPerUnit1) :
+   LoggingEventPatternConverter(LOG4CXX_STR("Time"),
+      LOG4CXX_STR("time")), nanosPerUnit(nanosPerUnit1) {
 }
 
 PatternConverterPtr RelativeTimePatternConverter::newInstance(
-   const std::vector<LogString>& /* options */) {
+   const std::vector<LogString>& options) {
+   if (options.size() > 0) {
+      if (StringHelper::equalsIgnoreCase(options[0],
+            LOG4CXX_STR("NS"), LOG4CXX_STR("ns"))) {
+         static PatternConverterPtr nanos(new RelativeTimePatternConverter(1));
+         return nanos;
+      }
+      if (StringHelper::equalsIgnoreCase(options[0],
+            LOG4CXX_STR("US"), LOG4CXX_STR("us"))) {
+         static PatternConverterPtr micros(new RelativeTimePatternConverter(1000));
+         return micros;
+      }
+   }
    static PatternConverterPtr def(new RelativeTimePatternConverter());
    return def;
 }
@@ -47,7 +64,8 @@ void RelativeTimePatternConverter::format(
   const LoggingEventPtr& event,
   LogString& toAppendTo,
   Pool& p) const {
-    log4cxx_time_t delta = (event->getTimeStamp() - LoggingEvent::getStartTime())/1000;
+    log4cxx_int64_t delta = (event->getTimeStampNanos()
+        - ((log4cxx_int64_t) LoggingEvent::getStartTime()) * 1000) / nanosPerUnit;
     StringHelper::toString(delta, p, toAppendTo);
  }
 
@@ -141,6 +141,7 @@ bool RollingFileAppenderSkeleton::rollover(Pool& p) {
 
 {
     synchronized sync(mutex);
+    AppendBarrier barrier(*this);
       try {
         RolloverDescriptionPtr rollover1(rollingPolicy->rollover(getFile(), p));
 
@@ -183,7 +184,14 @@ bool RollingFileAppenderSkeleton::rollover(Pool& p) {
                 rollover1->getActiveFileName(), true, bufferedIO, bufferSize, p);
             }
           } else {
-            OutputStreamPtr os(new FileOutputStream(
+            //
+            //   measured before opening, since a memory mapped
+            //      file is extended beyond its content while open
+            size_t activeLength = 0;
+            if (rollover1->getAppend()) {
+              activeLength = File().setPath(rollover1->getActiveFileName()).length(p);
+            }
+            OutputStreamPtr os(createFileOutputStream(
                   rollover1->getActiveFileName(), rollover1->getAppend()));
             WriterPtr newWriter(createWriter(os));
             closeWriter();
@@ -203,11 +211,7 @@ bool RollingFileAppenderSkeleton::rollover(Pool& p) {
             }
 
             if (success) {
-              if (rollover1->getAppend()) {
-                fileLength = File().setPath(rollover1->getActiveFileName()).length(p);
-              } else {
-                fileLength = 0;
-              }
+              fileLength = activeLength;
 
               //
               //   async action not yet implemented
@@ -256,6 +260,14 @@ void RollingFileAppenderSkeleton::subAppend(const LoggingEventPtr& event, Pool&
   FileAppender::subAppend(event, p);
 }
 
+/**
+ * {@inheritDoc}
+*/
+bool RollingFileAppenderSkeleton::canAppendConcurrently(const LoggingEventPtr& event) {
+  return !triggeringPolicy->isTriggeringEvent(
+        this, event, getFile(), getFileLength());
+}
+
 /**
  * Get rolling policy.
  * @return rolling policy.
@@ -363,8 +375,12 @@ class CountingOutputStream : public OutputStream {
  @return new writer.
  */
 WriterPtr RollingFileAppenderSkeleton::createWriter(OutputStreamPtr& os) {
-  OutputStreamPtr cos(new CountingOutputStream(os, this));
-  return FileAppender::createWriter(cos);
+  //
+  //   count outside any double buffer so the file length
+  //      includes bytes not yet written by the flusher thread
+  OutputStreamPtr buffered(createBufferedOutputStream(os));
+  OutputStreamPtr cos(new CountingOutputStream(buffered, this));
+  return WriterAppender::createWriter(cos);
 }
 
 /**
@@ -380,5 +396,11 @@ size_t RollingFileAppenderSkeleton::getFileLength() const {
  * @param increment additional bytes written to log file.
  */
 void RollingFileAppenderSkeleton::incrementFileLength(size_t increment) {
+#if defined(__GNUC__)
+  //
+  //   streams may be written concurrently, see FileAppender::setConcurrentWrites
+  __sync_fetch_and_add(&fileLength, increment);
+#else
   fileLength += increment;
+#endif
 }
@@ -28,6 +28,9 @@
 #endif
 #include <log4cxx/private/log4cxx_private.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/synchronized.h>
+#include <apr_atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -61,6 +64,405 @@ namespace log4cxx
     {
     typedef void (*incrementFunction)(tm& time, apr_time_exp_t& apr_time);
 
+    /**
+     * Two digit representations of 0 to 99.
+     */
+    class DigitPairs {
+    public:
+        DigitPairs() {
+            for(int i = 0; i < 100; i++) {
+                digits[2 * i] = (logchar) (0x30 + i / 10);
+                digits[2 * i + 1] = (logchar) (0x30 + i % 10);
+            }
+        }
+
+        static const logchar* getDigits() {
+            static const DigitPairs pairs;
+            return pairs.digits;
+        }
+
+    private:
+        logchar digits[200];
+    };
+
+    /**
+     * Pattern reduced to a flat list of fields that are computed with
+     * integer arithmetic from a cached description of the current day,
+     * so that the time zone only needs to be consulted when the day
+     * (or the UTC offset) changes.
+     */
+    class CompiledPattern {
+    public:
+        enum FieldType {
+            LITERAL,
+            YEAR,
+            MONTH,
+            WEEK_IN_YEAR,
+            WEEK_IN_MONTH,
+            DAY_IN_YEAR,
+            DAY_IN_MONTH,
+            HOUR_OF_DAY,
+            MINUTE,
+            SECOND,
+            MILLISECOND,
+            MICROSECOND,
+            NANOSECOND,
+            MONTH_NAME,
+            DAY_NAME,
+            AMPM,
+            RFC822_TIME_ZONE
+        };
+
+        /**
+         * Widest zero padded numeric field that can be compiled.
+         */
+        enum { MAX_WIDTH = 12 };
+
+        CompiledPattern() : fields(), pool(), mutex(pool), sequence(0) {
+            invalidate(base);
+        }
+
+        void addLiteral(logchar ch, int count) {
+            fields.push_back(Field(LITERAL, 0, 0, 0));
+            fields.back().text.append(count, ch);
+        }
+
+        void addLiteral(const LogString& text) {
+            fields.push_back(Field(LITERAL, 0, 0, 0));
+            fields.back().text = text;
+        }
+
+        bool addNumber(FieldType type, int width, int offset = 0) {
+            if (width > MAX_WIDTH) {
+                return false;
+            }
+            fields.push_back(Field(type, width, offset, 0));
+            return true;
+        }
+
+        void addNames(FieldType type, const std::vector<LogString>& names) {
+            fields.push_back(Field(type, 0, 0, &names));
+        }
+
+        /**
+         * Discards the cached day, called when the time zone changes.
+         */
+        void setTimeZone() {
+            DayBase invalid;
+            invalidate(invalid);
+            publishBase(invalid);
+        }
+
+        /**
+         * Appends the formatted time.
+         * @param s string to which the time is appended.
+         * @param time time in microseconds.
+         * @param nanos nanoseconds within the microsecond.
+         * @param zone time zone.
+         * @return false if the time could not be formatted by the
+         * compiled pattern, nothing is appended in that case.
+         */
+        bool format(LogString& s, log4cxx_time_t time, int nanos, const TimeZone& zone) const {
+            DayBase current;
+            if (!readBase(current)
+                || time < current.validFrom || time >= current.validUntil) {
+                if (!computeBase(current, time, zone)) {
+                    return false;
+                }
+                publishBase(current);
+            }
+
+            log4cxx_time_t timeOfDay = time - current.dayStart;
+            int seconds = (int) (timeOfDay / APR_USEC_PER_SEC);
+            int micros = (int) (timeOfDay - ((log4cxx_time_t) seconds) * APR_USEC_PER_SEC);
+            int hour = seconds / 3600;
+            int minute = (seconds / 60) - hour * 60;
+            int second = seconds - (hour * 3600 + minute * 60);
+
+            for(std::vector<Field>::const_iterator iter = fields.begin();
+                iter != fields.end();
+                iter++) {
+                switch(iter->type) {
+                    case LITERAL:
+                    s.append(iter->text);
+                    break;
+
+                    case YEAR:
+                    appendNumber(s, current.year, iter->width);
+                    break;
+
+                    case MONTH:
+                    appendNumber(s, current.month + 1, iter->width);
+                    break;
+
+                    case WEEK_IN_YEAR:
+                    appendNumber(s, current.dayOfYear / 7, iter->width);
+                    break;
+
+                    case WEEK_IN_MONTH:
+                    appendNumber(s, current.dayOfMonth / 7, iter->width);
+                    break;
+
+                    case DAY_IN_YEAR:
+                    appendNumber(s, current.dayOfYear, iter->width);
+                    break;
+
+                    case DAY_IN_MONTH:
+                    appendNumber(s, current.dayOfMonth, iter->width);
+                    break;
+
+                    case HOUR_OF_DAY:
+                    appendNumber(s, hour + iter->offset, iter->width);
+                    break;
+
+                    case MINUTE:
+                    appendNumber(s, minute, iter->width);
+                    break;
+
+                    case SECOND:
+                    appendNumber(s, second, iter->width);
+                    break;
+
+                    case MILLISECOND:
+                    appendNumber(s, micros / 1000, iter->width);
+                    break;
+
+                    case MICROSECOND:
+                    appendNumber(s, micros, iter->width);
+                    break;
+
+                    case NANOSECOND:
+                    appendNumber(s, micros * 1000 + nanos, iter->width);
+                    break;
+
+                    case MONTH_NAME:
+                    s.append((*iter->names)[current.month]);
+                    break;
+
+                    case DAY_NAME:
+                    s.append((*iter->names)[current.dayOfWeek]);
+                    break;
+
+                    case AMPM:
+                    s.append((*iter->names)[hour / 12]);
+                    break;
+
+                    case RFC822_TIME_ZONE:
+                    appendOffset(s, current.gmtoff);
+                    break;
+                }
+            }
+            return true;
+        }
+
+    private:
+        CompiledPattern(const CompiledPattern&);
+        CompiledPattern& operator=(const CompiledPattern&);
+
+        struct Field {
+            Field(FieldType type1, int width1, int offset1,
+                const std::vector<LogString>* names1) :
+                type(type1), width(width1), offset(offset1), text(), names(names1) {
+            }
+            FieldType type;
+            int width;
+            int offset;
+            LogString text;
+            const std::vector<LogString>* names;
+        };
+
+        /**
+         * Calendar fields of a local day and the interval
+         * in which they and the UTC offset apply.
+         */
+        struct DayBase {
+            log4cxx_time_t validFrom;
+            log4cxx_time_t validUntil;
+            log4cxx_time_t dayStart;
+            int year;
+            int month;
+            int dayOfMonth;
+            int dayOfYear;
+            int dayOfWeek;
+            int gmtoff;
+        };
+
+        static void invalidate(DayBase& base) {
+            base.validFrom = 0;
+            base.validUntil = 0;
+        }
+
+        /**
+         * Copies the published day.  The day is stored in place and
+         * guarded by a sequence count that is odd while publishBase
+         * updates it, so formatting threads never lock.
+         * @return false if the day was being updated.
+         */
+        bool readBase(DayBase& day) const {
+            //
+            //   the compare and swap only stores when the count is zero,
+            //      and then stores zero, so it serves as a read
+            //      with a full memory barrier
+            apr_uint32_t before = apr_atomic_cas32(&sequence, 0, 0);
+            if (before & 1) {
+                return false;
+            }
+            day = base;
+            return apr_atomic_cas32(&sequence, 0, 0) == before;
+        }
+
+        void publishBase(const DayBase& day) const {
+            synchronized sync(mutex);
+            apr_atomic_inc32(&sequence);
+            base = day;
+            apr_atomic_inc32(&sequence);
+        }
+
+        static bool sameOffset(const TimeZone& zone, log4cxx_time_t time, int gmtoff) {
+            apr_time_exp_t exploded;
+            return zone.explode(&exploded, time) == APR_SUCCESS
+                && exploded.tm_gmtoff == gmtoff;
+        }
+
+        /**
+         * Days since 1970-01-01 of a proleptic Gregorian date.
+         */
+        static log4cxx_int64_t daysFromCivil(log4cxx_int64_t y, int m, int d) {
+            y -= (m <= 2);
+            const log4cxx_int64_t era = (y >= 0 ? y : y - 399) / 400;
+            const int yoe = (int) (y - era * 400);
+            const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+            const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + doe - 719468;
+        }
+
+        /**
+         * Proleptic Gregorian date of a count of days since 1970-01-01.
+         */
+        static void civilFromDays(log4cxx_int64_t z, int& y, int& m, int& d) {
+            z += 719468;
+            const log4cxx_int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+            const int doe = (int) (z - era * 146097);
+            const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const int mp = (5 * doy + 2) / 153;
+            d = doy - (153 * mp + 2) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = (int) (yoe + era * 400) + (m <= 2);
+        }
+
+        static bool computeBase(DayBase& base, log4cxx_time_t time, const TimeZone& zone) {
+            apr_time_exp_t exploded;
+            if (zone.explode(&exploded, time) != APR_SUCCESS) {
+                return false;
+            }
+            const log4cxx_time_t usecPerDay = APR_INT64_C(86400000000);
+            const log4cxx_time_t usecPerHour = APR_INT64_C(3600000000);
+            log4cxx_time_t offset = ((log4cxx_time_t) exploded.tm_gmtoff) * APR_USEC_PER_SEC;
+            log4cxx_time_t local = time + offset;
+            log4cxx_int64_t days = local / usecPerDay;
+            if (local - days * usecPerDay < 0) {
+                days--;
+            }
+
+            int y, m, d;
+            civilFromDays(days, y, m, d);
+            if (y < 1) {
+                return false;
+            }
+            base.year = y;
+            base.month = m - 1;
+            base.dayOfMonth = d;
+            base.dayOfYear = (int) (days - daysFromCivil(y, 1, 1));
+            base.dayOfWeek = (int) (((days % 7) + 11) % 7);
+            base.gmtoff = exploded.tm_gmtoff;
+            base.dayStart = days * usecPerDay - offset;
+
+            //
+            //   If the offset changes during the day, for example at a
+            //     daylight saving transition, only trust the current hour.
+            //
+            base.validFrom = base.dayStart;
+            base.validUntil = base.dayStart + usecPerDay;
+            if (!sameOffset(zone, base.validFrom, base.gmtoff)
+                || !sameOffset(zone, base.validUntil - 1, base.gmtoff)) {
+                log4cxx_time_t hourStart = (time / usecPerHour) * usecPerHour;
+                if (hourStart > time) {
+                    hourStart -= usecPerHour;
+                }
+                if (hourStart > base.validFrom) {
+                    base.validFrom = hourStart;
+                }
+                if (hourStart + usecPerHour < base.validUntil) {
+                    base.validUntil = hourStart + usecPerHour;
+                }
+                if (!sameOffset(zone, base.validFrom, base.gmtoff)
+                    || !sameOffset(zone, base.validUntil - 1, base.gmtoff)) {
+                    base.validFrom = time;
+                    base.validUntil = time + 1;
+                }
+            }
+            return true;
+        }
+
+        static void appendNumber(LogString& s, int value, int width) {
+            const logchar* pairs = DigitPairs::getDigits();
+            logchar buf[16];
+            int pos = sizeof(buf)/sizeof(buf[0]);
+            unsigned int n = (unsigned int) value;
+            while (n >= 100) {
+                unsigned int q = n / 100;
+                unsigned int r = n - q * 100;
+                pos -= 2;
+                buf[pos] = pairs[2 * r];
+                buf[pos + 1] = pairs[2 * r + 1];
+                n = q;
+            }
+            if (n >= 10) {
+                pos -= 2;
+                buf[pos] = pairs[2 * n];
+                buf[pos + 1] = pairs[2 * n + 1];
+            } else {
+                buf[--pos] = pairs[2 * n + 1];
+            }
+            int len = sizeof(buf)/sizeof(buf[0]) - pos;
+            if (len < width) {
+                s.append(width - len, (logchar) 0x30 /* '0' */);
+            }
+            s.append(buf + pos, len);
+        }
+
+        static void appendOffset(LogString& s, int off) {
+            if (off == 0) {
+                s.append(1, (logchar) 0x5A /* 'Z' */);
+                return;
+            }
+            if (off < 0) {
+                s.append(1, (logchar) 0x2D /* '-' */);
+                off = -off;
+            } else {
+                s.append(1, (logchar) 0x2B /* '+' */);
+            }
+            const logchar* pairs = DigitPairs::getDigits();
+            int hours = (off / 3600) % 100;
+            int minutes = (off % 3600) / 60;
+            s.append(pairs + 2 * hours, 2);
+            s.append(pairs + 2 * minutes, 2);
+        }
+
+        std::vector<Field> fields;
+        Pool pool;
+        /**
+         * Serializes updates of base.
+         */
+        Mutex mutex;
+        /**
+         * Guarded by sequence.
+         */
+        mutable DayBase base;
+        mutable volatile apr_uint32_t sequence;
+    };
+
     /**
      * Abstract inner class representing one format token
      * (one or more instances of a character).
@@ -89,6 +491,29 @@ namespace log4cxx
           virtual void format(LogString& s,
                               const apr_time_exp_t& date,
                               log4cxx::helpers::Pool& p) const = 0;
+
+          /**
+           * Adds the equivalent of this token to a compiled pattern.
+           * @param compiled compiled pattern.
+           * @return false if the token can not be compiled.
+           */
+          virtual bool compile(CompiledPattern& /* compiled */) const {
+              return false;
+          }
+
+          /**
+           * Appends the formatted token for a time with nanosecond resolution.
+           * @param s string to which formatted token is appended.
+           * @param date exploded date.
+           * @param nanos nanoseconds within the microsecond.
+           * @param p memory pool.
+           */
+          virtual void formatNanos(LogString& s,
+                              const apr_time_exp_t& date,
+                              int /* nanos */,
+                              log4cxx::helpers::Pool& p) const {
+              format(s, date, p);
+          }
                               
     protected:
            
@@ -186,6 +611,12 @@ public:
     s.append( count, ch );
   }
 
+  bool compile(CompiledPattern& compiled) const
+  {
+    compiled.addLiteral( ch, count );
+    return true;
+  }
+
 private:
   logchar ch;
   int count;
@@ -205,6 +636,12 @@ public:
     s.append(1, (logchar) 0x41 /* 'A' */);
     s.append(1, (logchar) 0x44 /* 'D' */);
   }
+
+  bool compile(CompiledPattern& compiled) const
+  {
+    compiled.addLiteral( LOG4CXX_STR("AD") );
+    return true;
+  }
 };
 
 
@@ -219,10 +656,16 @@ public:
   virtual int getField( const apr_time_exp_t & tm ) const = 0;
 
   void format( LogString& s, const apr_time_exp_t & tm, Pool & p ) const
+  {
+    appendField( s, getField( tm ), p );
+  }
+
+protected:
+  void appendField( LogString& s, int field, Pool & p ) const
   {
     size_t initialLength = s.length();
     
-    StringHelper::toString( getField( tm ), p, s );
+    StringHelper::toString( field, p, s );
     size_t finalLength = s.length();
     if ( initialLength + width > finalLength )
     {
@@ -230,6 +673,11 @@ public:
     }
   }
 
+  bool compileField( CompiledPattern& compiled, CompiledPattern::FieldType type, int offset = 0 ) const
+  {
+    return compiled.addNumber( type, (int) width, offset );
+  }
+
 private:
   size_t width;
   char zeroDigit;
@@ -248,6 +696,11 @@ public:
   {
     return 1900 + tm.tm_year;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::YEAR );
+  }
 };
 
 
@@ -263,6 +716,11 @@ public:
   {
     return tm.tm_mon + 1;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::MONTH );
+  }
 };
 
 
@@ -279,6 +737,12 @@ public:
     s.append( names[tm.tm_mon] );
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    compiled.addNames( CompiledPattern::MONTH_NAME, names );
+    return true;
+  }
+
 private:
   std::vector < LogString > names;
 };
@@ -298,6 +762,12 @@ public:
     s.append( names[tm.tm_mon] );
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    compiled.addNames( CompiledPattern::MONTH_NAME, names );
+    return true;
+  }
+
 private:
   std::vector < LogString > names;
 };
@@ -315,6 +785,11 @@ public:
   {
     return tm.tm_yday / 7;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::WEEK_IN_YEAR );
+  }
 };
 
 
@@ -330,6 +805,11 @@ public:
   {
     return tm.tm_mday / 7;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::WEEK_IN_MONTH );
+  }
 };
 
 
@@ -345,6 +825,11 @@ public:
   {
     return tm.tm_mday;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::DAY_IN_MONTH );
+  }
 };
 
 
@@ -360,6 +845,11 @@ public:
   {
     return tm.tm_yday;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::DAY_IN_YEAR );
+  }
 };
 
 
@@ -391,6 +881,12 @@ public:
     s.append( names[tm.tm_wday] );
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    compiled.addNames( CompiledPattern::DAY_NAME, names );
+    return true;
+  }
+
 private:
   std::vector < LogString > names;
 
@@ -410,6 +906,12 @@ public:
     s.append( names[tm.tm_wday] );
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    compiled.addNames( CompiledPattern::DAY_NAME, names );
+    return true;
+  }
+
 private:
   std::vector < LogString > names;
 
@@ -429,6 +931,11 @@ public:
     return tm.tm_hour + offset;
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::HOUR_OF_DAY, offset );
+  }
+
 private:
   int offset;
 };
@@ -464,6 +971,11 @@ public:
   {
     return tm.tm_min;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::MINUTE );
+  }
 };
 
 
@@ -479,6 +991,11 @@ public:
   {
     return tm.tm_sec;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::SECOND );
+  }
 };
 
 
@@ -494,6 +1011,11 @@ public:
   {
     return tm.tm_usec / 1000;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::MILLISECOND );
+  }
 };
 
 
@@ -509,6 +1031,36 @@ public:
   {
     return tm.tm_usec;
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::MICROSECOND );
+  }
+};
+
+
+
+class NanosecondToken : public NumericToken
+{
+public:
+  NanosecondToken( int width1 ) : NumericToken( width1 )
+  {
+  }
+
+  int getField( const apr_time_exp_t & tm ) const
+  {
+    return tm.tm_usec * 1000;
+  }
+
+  void formatNanos( LogString& s, const apr_time_exp_t & tm, int nanos, Pool & p ) const
+  {
+    appendField( s, tm.tm_usec * 1000 + nanos, p );
+  }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compileField( compiled, CompiledPattern::NANOSECOND );
+  }
 };
 
 
@@ -525,6 +1077,12 @@ public:
     s.append( names[tm.tm_hour / 12] );
   }
 
+  bool compile( CompiledPattern& compiled ) const
+  {
+    compiled.addNames( CompiledPattern::AMPM, names );
+    return true;
+  }
+
 private:
   std::vector < LogString > names;
 };
@@ -598,6 +1156,11 @@ public:
       }
     }
   }
+
+  bool compile( CompiledPattern& compiled ) const
+  {
+    return compiled.addNumber( CompiledPattern::RFC822_TIME_ZONE, 0 );
+  }
 };
 
 
@@ -707,6 +1270,10 @@ void SimpleDateFormat::addToken(const logchar spec, const int repeat, const std:
                  {
                    token = ( new MicrosecondToken( repeat ) );
                  }
+                 else if ( repeat == 9 )
+                 {
+                   token = ( new NanosecondToken( repeat ) );
+                 }
                  else
                  {
                    // It would be nice to support patterns with arbitrary
@@ -758,7 +1325,7 @@ void SimpleDateFormat::parsePattern( const LogString & fmt, const std::locale *
 }
 
 
-SimpleDateFormat::SimpleDateFormat( const LogString & fmt ) : timeZone( TimeZone::getDefault() )
+SimpleDateFormat::SimpleDateFormat( const LogString & fmt ) : timeZone( TimeZone::getDefault() ), compiled( NULL )
 {
 #if LOG4CXX_HAS_STD_LOCALE
   std::locale defaultLocale;
@@ -770,20 +1337,23 @@ SimpleDateFormat::SimpleDateFormat( const LogString & fmt ) : timeZone( TimeZone
   {
     ( * iter )->setTimeZone( timeZone );
   }
+  compilePattern();
 }
 
-SimpleDateFormat::SimpleDateFormat( const LogString & fmt, const std::locale * locale ) : timeZone( TimeZone::getDefault() )
+SimpleDateFormat::SimpleDateFormat( const LogString & fmt, const std::locale * locale ) : timeZone( TimeZone::getDefault() ), compiled( NULL )
 {
   parsePattern( fmt, locale, pattern );
   for ( PatternTokenList::iterator iter = pattern.begin(); iter != pattern.end(); iter++ )
   {
     ( * iter )->setTimeZone( timeZone );
   }
+  compilePattern();
 }
 
 
 SimpleDateFormat::~SimpleDateFormat()
 {
+  delete compiled;
   for ( PatternTokenList::iterator iter = pattern.begin(); iter != pattern.end(); iter++ )
   {
     delete * iter;
@@ -791,15 +1361,49 @@ SimpleDateFormat::~SimpleDateFormat()
 }
 
 
+void SimpleDateFormat::compilePattern()
+{
+  compiled = new CompiledPattern();
+  for ( PatternTokenList::const_iterator iter = pattern.begin(); iter != pattern.end(); iter++ )
+  {
+    if ( !( * iter )->compile( * compiled ) )
+    {
+      delete compiled;
+      compiled = NULL;
+      return;
+    }
+  }
+}
+
+
 void SimpleDateFormat::format( LogString & s, log4cxx_time_t time, Pool & p ) const
 {
+  formatTime( s, time, 0, p );
+}
+
+void SimpleDateFormat::formatNanos( LogString & s, log4cxx_int64_t nanos, Pool & p ) const
+{
+  log4cxx_time_t time = nanos / 1000;
+  if ( time * 1000 > nanos )
+  {
+    time--;
+  }
+  formatTime( s, time, (int) ( nanos - time * 1000 ), p );
+}
+
+void SimpleDateFormat::formatTime( LogString & s, log4cxx_time_t time, int nanos, Pool & p ) const
+{
+  if ( compiled != NULL && compiled->format( s, time, nanos, * timeZone ) )
+  {
+    return;
+  }
   apr_time_exp_t exploded;
   apr_status_t stat = timeZone->explode( & exploded, time );
   if ( stat == APR_SUCCESS )
   {
     for ( PatternTokenList::const_iterator iter = pattern.begin(); iter != pattern.end(); iter++ )
     {
-      ( * iter )->format( s, exploded, p );
+      ( * iter )->formatNanos( s, exploded, nanos, p );
     }
   }
 }
@@ -807,4 +1411,8 @@ void SimpleDateFormat::format( LogString & s, log4cxx_time_t time, Pool & p ) co
 void SimpleDateFormat::setTimeZone( const TimeZonePtr & zone )
 {
   timeZone = zone;
+  if ( compiled != NULL )
+  {
+    compiled->setTimeZone();
+  }
 }
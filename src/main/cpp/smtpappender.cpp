@@ -516,11 +516,12 @@ void SMTPAppender::append(const spi::LoggingEventPtr& event, Pool& p)
       return;
    }
 
-   LogString ndc;
-   event->getNDC(ndc);
+   event->getNDCCopy();
    event->getThreadName();
    // Get a copy of this thread's MDC.
    event->getMDCCopy();
+   // Produce a lazily supplied message on the calling thread.
+   event->getMessage();
 
    cb.add(event);
 
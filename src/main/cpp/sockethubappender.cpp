@@ -128,8 +128,7 @@ void SocketHubAppender::append(const spi::LoggingEventPtr& event, Pool& p)
                 return;
         }
         
-        LogString ndcVal;
-        event->getNDC(ndcVal);
+        event->getNDCCopy();
         event->getThreadName();
         // Get a copy of this thread's MDC.
         event->getMDCCopy();
@@ -18,38 +18,132 @@
 #include <log4cxx/logstring.h>
 #include <log4cxx/helpers/threadspecificdata.h>
 #include <log4cxx/helpers/exception.h>
+#include <log4cxx/layout.h>
+#include <log4cxx/spi/loggingevent.h>
 #if !defined(LOG4CXX)
 #define LOG4CXX 1
 #endif
 #include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <vector>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+#if APR_HAS_THREADS && LOG4CXX_HAS_NATIVE_TLS
+namespace {
+    /**
+     *  Data of the current thread, the APR thread key
+     *  is still set so the data is deleted when the thread ends.
+     */
+    __thread ThreadSpecificData* currentData = 0;
+}
+#endif
+
 
 ThreadSpecificData::ThreadSpecificData()
-    : ndcStack(), mdcMap() {
+    : ndcTop(0), mdcMap(new MDCMap()),
+      formatBuffer(), formatBufferInUse(false),
+      formattedEvent(0), formattedLayout(0),
+      encodeBuffer(), encodeBufferInUse(false) {
+    mdcMap->addRef();
 }
 
 ThreadSpecificData::~ThreadSpecificData() {
+#if APR_HAS_THREADS && LOG4CXX_HAS_NATIVE_TLS
+    if (currentData == this) {
+        currentData = 0;
+    }
+#endif
+    setFormatted(0, 0);
+    mdcMap->releaseRef();
+    if (ndcTop != 0) {
+        ndcTop->releaseRef();
+    }
+}
+
+void ThreadSpecificData::setFormatted(const spi::LoggingEvent* event,
+                                      const Layout* layout) {
+  if (event != 0) {
+      event->addRef();
+      layout->addRef();
+  }
+  if (formattedEvent != 0) {
+      formattedEvent->releaseRef();
+      formattedLayout->releaseRef();
+  }
+  formattedEvent = event;
+  formattedLayout = layout;
+}
+
+
+void ThreadSpecificData::setNDC(const NDCNode* node) {
+  if (node != 0) {
+      node->addRef();
+  }
+  if (ndcTop != 0) {
+      ndcTop->releaseRef();
+  }
+  ndcTop = node;
+}
+
+void ThreadSpecificData::popNDC() {
+  if (ndcTop != 0) {
+      setNDC(ndcTop->getParent());
+  }
+}
+
+void ThreadSpecificData::setMDCMap(const MDCMap* map) {
+  if (map == 0) {
+      if (mdcMap->empty()) {
+          return;
+      }
+      map = new MDCMap();
+  }
+  //
+  //   the map is only modified through getWritableMDCMap
+  //      which copies it while it is shared
+  MDCMap* next = const_cast<MDCMap*>(map);
+  next->addRef();
+  mdcMap->releaseRef();
+  mdcMap = next;
 }
 
+const MDCMap& ThreadSpecificData::getMDCMap() const {
+  return *mdcMap;
+}
 
-log4cxx::NDC::Stack& ThreadSpecificData::getStack() {
-  return ndcStack;
+MDCMap& ThreadSpecificData::getWritableMDCMap() {
+  if (mdcMap->isShared()) {
+      MDCMap* copy = new MDCMap(*mdcMap);
+      copy->addRef();
+      mdcMap->releaseRef();
+      mdcMap = copy;
+  }
+  return *mdcMap;
 }
 
-log4cxx::MDC::Map& ThreadSpecificData::getMap() {
+const MDCMap* ThreadSpecificData::getMDCSnapshot() {
+  mdcMap->addRef();
   return mdcMap;
 }
 
+const NDCNode* ThreadSpecificData::getNDCSnapshot() {
+  if (ndcTop != 0) {
+      ndcTop->addRef();
+  }
+  return ndcTop;
+}
+
 ThreadSpecificData& ThreadSpecificData::getDataNoThreads() {
     static ThreadSpecificData noThreadData;
     return noThreadData;
 }
 
 ThreadSpecificData* ThreadSpecificData::getCurrentData() {
-#if APR_HAS_THREADS
+#if APR_HAS_THREADS && LOG4CXX_HAS_NATIVE_TLS
+  return currentData;
+#elif APR_HAS_THREADS
   void* pData = NULL;
   apr_threadkey_private_get(&pData, APRInitializer::getTlsKey());
   return (ThreadSpecificData*) pData;
@@ -59,8 +153,13 @@ ThreadSpecificData* ThreadSpecificData::getCurrentData() {
 }
 
 void ThreadSpecificData::recycle() {
-#if APR_HAS_THREADS
-    if(ndcStack.empty() && mdcMap.empty()) {
+//
+//   with native thread local storage the data is kept
+//      until the thread ends so lookups stay cheap and
+//      repeated push and pop do not allocate
+#if APR_HAS_THREADS && !LOG4CXX_HAS_NATIVE_TLS
+    if(ndcTop == 0 && mdcMap->empty() &&
+       !formatBufferInUse && !encodeBufferInUse) {
         void* pData = NULL;
         apr_status_t stat = apr_threadkey_private_get(&pData, APRInitializer::getTlsKey());
         if (stat == APR_SUCCESS && pData == this) {
@@ -74,12 +173,19 @@ void ThreadSpecificData::recycle() {
 }
 
 void ThreadSpecificData::put(const LogString& key, const LogString& val) {
+    put(MDC::getKey(key), val);
+}
+
+void ThreadSpecificData::put(int key, const LogString& val) {
     ThreadSpecificData* data = getCurrentData();
     if (data == 0) {
         data = createCurrentData();
     }
     if (data != 0) {
-        data->getMap()[key] = val;
+        const LogString* current = data->getMDCMap().get(key);
+        if (current == 0 || *current != val) {
+            data->getWritableMDCMap().put(key, val);
+        }
     }
 }
 
@@ -92,15 +198,7 @@ void ThreadSpecificData::push(const LogString& val) {
         data = createCurrentData();
     }
     if (data != 0) {
-        NDC::Stack& stack = data->getStack();
-        if(stack.empty()) {
-            stack.push(NDC::DiagnosticContext(val, val));
-        } else {
-            LogString fullMessage(stack.top().second);
-            fullMessage.append(1, (logchar) 0x20);
-            fullMessage.append(val);
-            stack.push(NDC::DiagnosticContext(val, fullMessage));
-        }
+        data->setNDC(new NDCNode(data->getNDC(), val));
     }
 }
 
@@ -110,12 +208,51 @@ void ThreadSpecificData::inherit(const NDC::Stack& src) {
         data = createCurrentData();
     }
     if (data != 0) {
-        data->getStack() = src;
+        //
+        //   std::stack can only be read from the top,
+        //       rebuild the frames from the bottom up
+        NDC::Stack copy(src);
+        std::vector<NDC::DiagnosticContext> frames;
+        while(!copy.empty()) {
+            frames.push_back(copy.top());
+            copy.pop();
+        }
+        const NDCNode* top = 0;
+        for(std::vector<NDC::DiagnosticContext>::reverse_iterator iter = frames.rbegin();
+            iter != frames.rend();
+            iter++) {
+            NDCNode* node = new NDCNode(top, iter->first, iter->second);
+            node->addRef();
+            if (top != 0) {
+                top->releaseRef();
+            }
+            top = node;
+        }
+        data->setNDC(top);
+        if (top != 0) {
+            top->releaseRef();
+        }
     }
 }
 
 
 
+void ThreadSpecificData::install(const MDCMap* mdc, const NDCNode* ndc) {
+    ThreadSpecificData* data = getCurrentData();
+    if (data == 0) {
+        if ((mdc == 0 || mdc->empty()) && ndc == 0) {
+            return;
+        }
+        data = createCurrentData();
+    }
+    if (data != 0) {
+        data->setMDCMap(mdc);
+        data->setNDC(ndc);
+        data->recycle();
+    }
+}
+
+
 ThreadSpecificData* ThreadSpecificData::createCurrentData() {
 #if APR_HAS_THREADS
     ThreadSpecificData* newData = new ThreadSpecificData();
@@ -124,6 +261,9 @@ ThreadSpecificData* ThreadSpecificData::createCurrentData() {
       delete newData;
       newData = NULL;
     }
+#if LOG4CXX_HAS_NATIVE_TLS
+    currentData = newData;
+#endif
     return newData;
 #else
     return 0;
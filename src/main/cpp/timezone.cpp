@@ -30,7 +30,10 @@
 #include <log4cxx/helpers/transcoder.h>
 #include <log4cxx/helpers/stringhelper.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/synchronized.h>
 #include <log4cxx/logger.h>
+#include <apr_atomic.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -78,7 +81,7 @@ namespace log4cxx
 
 
 
-      /** Time zone object that represents GMT. */
+      /** Time zone object that represents the local time zone. */
       class LocalTimeZone : public TimeZone
       {
       public:
@@ -89,8 +92,52 @@ namespace log4cxx
           return tz;
         }
 
-        /** Explode time to human readable form. */
+        /**
+         * Explode time to human readable form.  Times within the
+         * cached range of constant UTC offset are exploded arithmetically,
+         * the C library is only consulted when the range is left.
+         */
         log4cxx_status_t explode( apr_time_exp_t * result, log4cxx_time_t input ) const
+        {
+          OffsetRange range;
+          if (!readRange(range) || input < range.validFrom || input >= range.validUntil) {
+              if (!findRange(input, range)) {
+                  return explodeLocal(result, input);
+              }
+          }
+          apr_status_t stat = explodeOffset(result, input, range.gmtoff);
+          result->tm_isdst = range.isdst;
+          return stat;
+        }
+
+
+      private:
+        /**
+         * Interval of time with a constant UTC offset and
+         * daylight saving flag.
+         */
+        struct OffsetRange {
+          log4cxx_time_t validFrom;
+          log4cxx_time_t validUntil;
+          apr_int32_t gmtoff;
+          apr_int32_t isdst;
+        };
+
+        /**
+         * Largest distance in days that the range is extended
+         * either side of the time that caused it to be computed.
+         */
+        enum { MAX_RANGE_DAYS = 7 };
+
+        LocalTimeZone() : TimeZone( getTimeZoneName() ), pool(), mutex(pool), sequence(0)
+        {
+          current.validFrom = 0;
+          current.validUntil = 0;
+          current.gmtoff = 0;
+          current.isdst = 0;
+        }
+
+        static apr_status_t explodeLocal( apr_time_exp_t * result, log4cxx_time_t input )
         {
           apr_status_t stat;
           //  APR 1.1 and early mishandles microseconds on dates
@@ -105,10 +152,121 @@ namespace log4cxx
           return stat;
         }
 
+        static apr_status_t explodeOffset( apr_time_exp_t * result, log4cxx_time_t input, apr_int32_t offset )
+        {
+          apr_status_t stat;
+          if (LOG4CXX_UNLIKELY(input < 0 && apr_time_usec(input) < 0)) {
+             apr_time_t floorTime = (apr_time_sec(input) -1) * APR_USEC_PER_SEC;
+             stat = apr_time_exp_tz(result, floorTime, offset);
+             result->tm_usec = (int) (input - floorTime);
+          } else {
+             stat = apr_time_exp_tz( result, input, offset );
+          }
+          return stat;
+        }
 
-      private:
-        LocalTimeZone() : TimeZone( getTimeZoneName() )
+        /**
+         * Determines whether the offset at the start of a second
+         * matches the specified offset.
+         */
+        static bool sameOffset( apr_time_t seconds, apr_int32_t gmtoff, apr_int32_t isdst )
+        {
+          apr_time_exp_t exploded;
+          return apr_time_exp_lt(&exploded, apr_time_from_sec(seconds)) == APR_SUCCESS
+             && exploded.tm_gmtoff == gmtoff
+             && exploded.tm_isdst == isdst;
+        }
+
+        /**
+         * Finds the first second at which the offset differs,
+         * the offset at "same" must match and the offset at "different"
+         * must differ.
+         */
+        static apr_time_t findTransition( apr_time_t same, apr_time_t different,
+              apr_int32_t gmtoff, apr_int32_t isdst )
+        {
+          while (different - same > 1 || same - different > 1) {
+            apr_time_t mid = same + (different - same) / 2;
+            if (sameOffset(mid, gmtoff, isdst)) {
+              same = mid;
+            } else {
+              different = mid;
+            }
+          }
+          return different;
+        }
+
+        /**
+         * Copies the published range.  The range is stored in place and
+         * guarded by a sequence count that is odd while findRange
+         * updates it, so readers never lock and no range is ever freed.
+         * @return false if the range was being updated.
+         */
+        bool readRange( OffsetRange& range ) const
+        {
+          //
+          //   the compare and swap only stores when the count is zero,
+          //      and then stores zero, so it serves as a read
+          //      with a full memory barrier
+          apr_uint32_t before = apr_atomic_cas32(&sequence, 0, 0);
+          if (before & 1) {
+            return false;
+          }
+          range = current;
+          return apr_atomic_cas32(&sequence, 0, 0) == before;
+        }
+
+        /**
+         * Computes and publishes the range containing the specified time.
+         * @param range receives the range.
+         * @return false if the time could not be exploded.
+         */
+        bool findRange( log4cxx_time_t input, OffsetRange& range ) const
         {
+          apr_time_exp_t exploded;
+          if (explodeLocal(&exploded, input) != APR_SUCCESS) {
+            return false;
+          }
+          const apr_time_t secondsPerDay = 86400;
+          apr_time_t seconds = apr_time_sec(input);
+          if (seconds * APR_USEC_PER_SEC > input) {
+            seconds--;
+          }
+          range.gmtoff = exploded.tm_gmtoff;
+          range.isdst = exploded.tm_isdst;
+
+          apr_time_t until = seconds + MAX_RANGE_DAYS * secondsPerDay;
+          for(apr_time_t probe = seconds + secondsPerDay; probe <= until; probe += secondsPerDay) {
+            if (!sameOffset(probe, range.gmtoff, range.isdst)) {
+              until = findTransition(probe - secondsPerDay, probe, range.gmtoff, range.isdst);
+              break;
+            }
+          }
+          apr_time_t from = seconds - MAX_RANGE_DAYS * secondsPerDay;
+          for(apr_time_t probe = seconds - secondsPerDay; probe >= from; probe -= secondsPerDay) {
+            if (!sameOffset(probe, range.gmtoff, range.isdst)) {
+              //
+              //   scanning backwards the transition found is the
+              //      last second of the earlier offset
+              from = findTransition(probe + secondsPerDay, probe, range.gmtoff, range.isdst) + 1;
+              break;
+            }
+          }
+          if (from > seconds) {
+            from = seconds;
+          }
+          range.validFrom = apr_time_from_sec(from);
+          range.validUntil = apr_time_from_sec(until);
+          if (input < range.validFrom || input >= range.validUntil) {
+            range.validFrom = input;
+            range.validUntil = input + 1;
+          }
+
+          synchronized sync(mutex);
+          apr_atomic_inc32(&sequence);
+          current = range;
+          apr_atomic_inc32(&sequence);
+          return true;
         }
 
         static const LogString getTimeZoneName()
@@ -128,6 +286,13 @@ namespace log4cxx
           return retval;
         }
 
+        Pool pool;
+        Mutex mutex;
+        /**
+         * Guarded by sequence.
+         */
+        mutable OffsetRange current;
+        mutable volatile apr_uint32_t sequence;
       };
 
 
@@ -35,13 +35,160 @@
 #include <CoreFoundation/CFString.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOG4CXX_TRANSCODER_SSE2 1
+#else
+#define LOG4CXX_TRANSCODER_SSE2 0
+#endif
+#include <string.h>
+
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
 
+#if LOG4CXX_TRANSCODER_SSE2
+/**
+ *   Returns the index of the lowest set bit of a non-zero mask.
+ */
+static inline size_t lowestBit(int mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    size_t n = 0;
+    for(; (mask & 1) == 0; mask >>= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+#endif
+
+size_t Transcoder::asciiLength(const char* src, size_t length) {
+    size_t i = 0;
+#if LOG4CXX_TRANSCODER_SSE2
+    //
+    //   the sign bits of 16 bytes at a time
+    for(; i + 16 <= length; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) (src + i)));
+        if (mask != 0) {
+            return i + lowestBit(mask);
+        }
+    }
+#else
+    //
+    //   the high bits of a word at a time
+    const unsigned long highBits = ((unsigned long) -1 / 0xFF) * 0x80;
+    for(; i + sizeof(unsigned long) <= length; i += sizeof(unsigned long)) {
+        unsigned long word;
+        memcpy(&word, src + i, sizeof(word));
+        if ((word & highBits) != 0) {
+            break;
+        }
+    }
+#endif
+    while(i < length && ((unsigned char) src[i]) < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+size_t Transcoder::asciiLength(const logchar* src, size_t length) {
+    size_t i = 0;
+#if LOG4CXX_TRANSCODER_SSE2
+    const size_t perVector = 16 / sizeof(logchar);
+    const __m128i high = (sizeof(logchar) == 4) ?
+        _mm_set1_epi32(~0x7F) : _mm_set1_epi16((short) 0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + perVector <= length; i += perVector) {
+        __m128i bits = _mm_and_si128(_mm_loadu_si128((const __m128i*) (src + i)), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bits, zero)) != 0xFFFF) {
+            break;
+        }
+    }
+#endif
+    while(i < length && ((unsigned int) src[i]) < 0x80) {
+        i++;
+    }
+    return i;
+}
+#endif
+
+void Transcoder::widen(const char* src, size_t length, LogString& dst) {
+#if LOG4CXX_LOGCHAR_IS_UTF8
+    dst.append(src, length);
+#else
+    size_t start = dst.length();
+    dst.resize(start + length);
+    logchar* out = &dst[start];
+    size_t i = 0;
+#if LOG4CXX_TRANSCODER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (src + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        if (sizeof(logchar) == 2) {
+            _mm_storeu_si128((__m128i*) (out + i), lo);
+            _mm_storeu_si128((__m128i*) (out + i + 8), hi);
+        } else {
+            _mm_storeu_si128((__m128i*) (out + i), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*) (out + i + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*) (out + i + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i*) (out + i + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#endif
+    for(; i < length; i++) {
+        out[i] = (logchar) (unsigned char) src[i];
+    }
+#endif
+}
+
+void Transcoder::narrow(const logchar* src, size_t length, char* dst) {
+#if LOG4CXX_LOGCHAR_IS_UTF8
+    memcpy(dst, src, length);
+#else
+    size_t i = 0;
+#if LOG4CXX_TRANSCODER_SSE2
+    for(; i + 16 <= length; i += 16) {
+        __m128i bytes;
+        if (sizeof(logchar) == 2) {
+            bytes = _mm_packus_epi16(
+                _mm_loadu_si128((const __m128i*) (src + i)),
+                _mm_loadu_si128((const __m128i*) (src + i + 8)));
+        } else {
+            //
+            //   values below 0x100 survive both saturating packs
+            __m128i lo = _mm_packs_epi32(
+                _mm_loadu_si128((const __m128i*) (src + i)),
+                _mm_loadu_si128((const __m128i*) (src + i + 4)));
+            __m128i hi = _mm_packs_epi32(
+                _mm_loadu_si128((const __m128i*) (src + i + 8)),
+                _mm_loadu_si128((const __m128i*) (src + i + 12)));
+            bytes = _mm_packus_epi16(lo, hi);
+        }
+        _mm_storeu_si128((__m128i*) (dst + i), bytes);
+    }
+#endif
+    for(; i < length; i++) {
+        dst[i] = (char) src[i];
+    }
+#endif
+}
+
+
 void Transcoder::decodeUTF8(const std::string& src, LogString& dst) {
      std::string::const_iterator iter = src.begin();
      while(iter != src.end()) {
+         size_t offset = iter - src.begin();
+         size_t ascii = asciiLength(src.data() + offset, src.length() - offset);
+         if (ascii > 0) {
+            widen(src.data() + offset, ascii, dst);
+            iter += ascii;
+            continue;
+         }
          unsigned int sv = decode(src, iter);
          if(sv != 0xFFFF) {
             encode(sv, dst);
@@ -58,6 +205,15 @@ void Transcoder::encodeUTF8(const LogString& src, std::string& dst) {
 #else
      LogString::const_iterator iter = src.begin();
      while(iter != src.end()) {
+         size_t offset = iter - src.begin();
+         size_t ascii = asciiLength(src.data() + offset, src.length() - offset);
+         if (ascii > 0) {
+            size_t start = dst.length();
+            dst.resize(start + ascii);
+            narrow(src.data() + offset, ascii, &dst[start]);
+            iter += ascii;
+            continue;
+         }
          unsigned int sv = decode(src, iter);
          if(sv != 0xFFFF) {
             encode(sv, dst);
@@ -248,11 +404,9 @@ void Transcoder::decode(const std::string& src, LogString& dst) {
    dst.reserve(dst.size() + src.size());
    std::string::const_iterator iter = src.begin();
 #if !LOG4CXX_CHARSET_EBCDIC
-   for(;
-       iter != src.end() && ((unsigned char) *iter) < 0x80;
-       iter++) {
-       dst.append(1, *iter);
-   }
+   size_t ascii = asciiLength(src.data(), src.length());
+   widen(src.data(), ascii, dst);
+   iter += ascii;
 #endif
   if (iter != src.end()) {   
     size_t offset = iter - src.begin();
@@ -289,11 +443,11 @@ void Transcoder::encode(const LogString& src, std::string& dst) {
    dst.reserve(dst.size() + src.size());
    LogString::const_iterator iter = src.begin();
 #if !LOG4CXX_CHARSET_EBCDIC
-   for(;
-       iter != src.end() && ((unsigned int) *iter) < 0x80;
-       iter++) {
-       dst.append(1, *iter);
-   }
+   size_t ascii = asciiLength(src.data(), src.length());
+   size_t start = dst.length();
+   dst.resize(start + ascii);
+   narrow(src.data(), ascii, &dst[start]);
+   iter += ascii;
 #endif
   if (iter != src.end()) {
     char buf[BUFSIZE];
@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/uringfileoutputstream.h>
+#include <log4cxx/helpers/exception.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <apr_file_io.h>
+#include <apr_portable.h>
+#if !defined(LOG4CXX)
+#define LOG4CXX 1
+#endif
+#include <log4cxx/helpers/aprinitializer.h>
+#include <log4cxx/private/log4cxx_private.h>
+#include <string.h>
+#if LOG4CXX_HAVE_LIBURING
+#include <liburing.h>
+#include <errno.h>
+#endif
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+IMPLEMENT_LOG4CXX_OBJECT(UringFileOutputStream)
+
+UringFileOutputStream::UringFileOutputStream(const LogString& filename,
+    bool append, size_t bufferSize1)
+    : pool(), fileptr(0), fd(-1), ring(0), registered(false),
+      bufferSize(bufferSize1 > 0 ? bufferSize1 : 8 * 1024), buffers(),
+      current(0), filled(0), submitted(0), offset(0),
+      freeRequests(), error(APR_SUCCESS) {
+#if LOG4CXX_HAVE_LIBURING
+    for(int i = 0; i < BUFFER_COUNT; i++) {
+        writes[i] = 0;
+    }
+    for(int i = QUEUE_DEPTH - 1; i >= 0; i--) {
+        freeRequests.push_back(&requests[i]);
+    }
+    buffers.resize(BUFFER_COUNT * bufferSize);
+
+    struct io_uring* r = new struct io_uring;
+    int rc = io_uring_queue_init(QUEUE_DEPTH, r, 0);
+    if (rc < 0) {
+        delete r;
+        throw IOException(APR_FROM_OS_ERROR(-rc));
+    }
+    //
+    //   registration may fail when locked memory is limited,
+    //      plain writes from the same buffers still work
+    struct iovec iov[BUFFER_COUNT];
+    for(int i = 0; i < BUFFER_COUNT; i++) {
+        iov[i].iov_base = &buffers[i * bufferSize];
+        iov[i].iov_len = bufferSize;
+    }
+    registered = io_uring_register_buffers(r, iov, BUFFER_COUNT) == 0;
+
+    //
+    //   not opened with APR_APPEND since
+    //      every write gives its own offset
+    apr_int32_t flags = APR_WRITE | APR_CREATE;
+    if (!append) {
+        flags |= APR_TRUNCATE;
+    }
+    File fn;
+    fn.setPath(filename);
+    apr_status_t stat = fn.open(&fileptr, flags, APR_OS_DEFAULT, pool);
+    if (stat == APR_SUCCESS) {
+        apr_os_file_t osfile;
+        stat = apr_os_file_get(&osfile, fileptr);
+        apr_off_t end = 0;
+        if (stat == APR_SUCCESS && append) {
+            stat = apr_file_seek(fileptr, APR_END, &end);
+        }
+        if (stat != APR_SUCCESS) {
+            apr_file_close(fileptr);
+            fileptr = NULL;
+        }
+        fd = osfile;
+        offset = end;
+    }
+    if (stat != APR_SUCCESS) {
+        io_uring_queue_exit(r);
+        delete r;
+        throw IOException(stat);
+    }
+    ring = r;
+#else
+    throw IOException(APR_ENOTIMPL);
+#endif
+}
+
+UringFileOutputStream::~UringFileOutputStream() {
+    if (fileptr != NULL && !APRInitializer::isDestructed) {
+        try {
+            Pool p;
+            close(p);
+        } catch(std::exception&) {
+        }
+    }
+}
+
+bool UringFileOutputStream::isSupported() {
+#if LOG4CXX_HAVE_LIBURING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UringFileOutputStream::close(Pool& /* p */) {
+    if (fileptr == NULL) {
+        return;
+    }
+    log4cxx_status_t stat = APR_SUCCESS;
+#if LOG4CXX_HAVE_LIBURING
+    try {
+        submit();
+        while(freeRequests.size() < QUEUE_DEPTH) {
+            reap(true);
+        }
+    } catch(IOException&) {
+        stat = APR_EGENERAL;
+    }
+    struct io_uring* r = (struct io_uring*) ring;
+    io_uring_queue_exit(r);
+    delete r;
+    ring = 0;
+#endif
+    apr_status_t closeStat = apr_file_close(fileptr);
+    fileptr = NULL;
+    if (error != APR_SUCCESS) {
+        stat = error;
+        error = APR_SUCCESS;
+    }
+    if (stat == APR_SUCCESS) {
+        stat = closeStat;
+    }
+    if (stat != APR_SUCCESS) {
+        throw IOException(stat);
+    }
+}
+
+/**
+ *  Submits the buffered bytes without waiting for them to be written.
+ */
+void UringFileOutputStream::flush(Pool& /* p */) {
+    if (fileptr == NULL) {
+        throw IOException(-1);
+    }
+    submit();
+    reap(false);
+    checkError();
+}
+
+void UringFileOutputStream::write(ByteBuffer& buf, Pool& /* p */ ) {
+    if (fileptr == NULL) {
+        throw IOException(-1);
+    }
+    reap(false);
+    checkError();
+    const char* data = buf.current();
+    size_t nbytes = buf.remaining();
+    while(nbytes > 0) {
+        if (filled == bufferSize) {
+            submit();
+            current = (current + 1) % BUFFER_COUNT;
+            filled = 0;
+            submitted = 0;
+            //
+            //   only blocks when every buffer is being written
+            while(writes[current] > 0) {
+                reap(true);
+            }
+            checkError();
+        }
+        size_t count = bufferSize - filled;
+        if (count > nbytes) {
+            count = nbytes;
+        }
+        memcpy(&buffers[current * bufferSize + filled], data, count);
+        filled += count;
+        data += count;
+        nbytes -= count;
+    }
+    buf.position(buf.limit());
+}
+
+/**
+ *  Submits the bytes of the current buffer that have not been submitted.
+ */
+void UringFileOutputStream::submit() {
+    if (filled == submitted) {
+        return;
+    }
+    while(freeRequests.empty()) {
+        reap(true);
+    }
+    Request* request = freeRequests.back();
+    freeRequests.pop_back();
+    request->buffer = current;
+    request->position = current * bufferSize + submitted;
+    request->length = filled - submitted;
+    request->offset = offset;
+    offset += request->length;
+    submitted = filled;
+    writes[current]++;
+    submit(*request);
+}
+
+void UringFileOutputStream::submit(Request& request) {
+#if LOG4CXX_HAVE_LIBURING
+    struct io_uring* r = (struct io_uring*) ring;
+    //
+    //   no more than QUEUE_DEPTH requests are in flight
+    //      and each is submitted at once, so an entry is free
+    struct io_uring_sqe* sqe = io_uring_get_sqe(r);
+    if (sqe == 0) {
+        throw IOException(APR_EGENERAL);
+    }
+    char* data = &buffers[request.position];
+    if (registered) {
+        io_uring_prep_write_fixed(sqe, fd, data, request.length, request.offset, request.buffer);
+    } else {
+        io_uring_prep_write(sqe, fd, data, request.length, request.offset);
+    }
+    io_uring_sqe_set_data(sqe, &request);
+    int rc;
+    do {
+        rc = io_uring_submit(r);
+    } while(rc == -EINTR);
+    if (rc < 0) {
+        throw IOException(APR_FROM_OS_ERROR(-rc));
+    }
+#endif
+}
+
+/**
+ *  Handles completed writes, waiting for at least one if wait is true.
+ */
+void UringFileOutputStream::reap(bool wait) {
+#if LOG4CXX_HAVE_LIBURING
+    struct io_uring* r = (struct io_uring*) ring;
+    struct io_uring_cqe* cqe = 0;
+    if (wait) {
+        int rc;
+        do {
+            rc = io_uring_wait_cqe(r, &cqe);
+        } while(rc == -EINTR);
+        if (rc < 0) {
+            throw IOException(APR_FROM_OS_ERROR(-rc));
+        }
+    }
+    while(io_uring_peek_cqe(r, &cqe) == 0) {
+        Request* request = (Request*) io_uring_cqe_get_data(cqe);
+        int result = cqe->res;
+        io_uring_cqe_seen(r, cqe);
+        complete(*request, result);
+    }
+#endif
+}
+
+void UringFileOutputStream::complete(Request& request, int result) {
+#if LOG4CXX_HAVE_LIBURING
+    if (result == -EINTR || result == -EAGAIN) {
+        submit(request);
+        return;
+    }
+    if (result > 0 && (size_t) result < request.length) {
+        //
+        //   short write, submit the rest
+        request.position += result;
+        request.length -= result;
+        request.offset += result;
+        submit(request);
+        return;
+    }
+    if (result < 0 && error == APR_SUCCESS) {
+        error = APR_FROM_OS_ERROR(-result);
+    } else if (result == 0 && error == APR_SUCCESS) {
+        error = APR_EGENERAL;
+    }
+#endif
+    writes[request.buffer]--;
+    freeRequests.push_back(&request);
+}
+
+/**
+ *  Reports the first write error since the last call.
+ */
+void UringFileOutputStream::checkError() {
+    if (error != APR_SUCCESS) {
+        log4cxx_status_t stat = error;
+        error = APR_SUCCESS;
+        throw IOException(stat);
+    }
+}
@@ -20,6 +20,11 @@
 #include <log4cxx/helpers/synchronized.h>
 #include <log4cxx/layout.h>
 #include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/formatbuffer.h>
+#include <log4cxx/helpers/charsetencoder.h>
+#include <log4cxx/helpers/pool.h>
+#include <apr_portable.h>
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -184,6 +189,18 @@ WriterPtr WriterAppender::createWriter(OutputStreamPtr& os) {
   CharsetEncoderPtr encoder;
   if (enc.empty()) {
     encoder = CharsetEncoder::getDefaultEncoder();
+#if LOG4CXX_LOGCHAR_IS_UTF8
+    //
+    //   a UTF-8 locale needs no encoding, so resolve it now
+    //      rather than on every write
+    if (!encoder->isIdentity()) {
+      Pool p;
+      const char* localeEncoding = apr_os_locale_encoding(p.getAPRPool());
+      if (localeEncoding != NULL && strcmp(localeEncoding, "UTF-8") == 0) {
+        encoder = CharsetEncoder::getUTF8Encoder();
+      }
+    }
+#endif
   } else {
     if(StringHelper::equalsIgnoreCase(enc,
         LOG4CXX_STR("utf-16"), LOG4CXX_STR("UTF-16"))) {
@@ -211,12 +228,15 @@ void WriterAppender::setEncoding(const LogString& enc) {
 
 void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 {
-        LogString msg;
-        layout->format(msg, event, p);
+        FormatBuffer msg(event, layout);
+        if (!msg.isFormatted()) {
+            layout->format(msg.get(), event, p);
+            msg.setFormatted();
+        }
         {
            synchronized sync(mutex);
          if (writer != NULL) {
-           writer->write(msg, p);
+           writer->write(msg.get(), p);
               if (immediateFlush) {
                writer->flush(p);
               }
@@ -228,20 +248,20 @@ void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 void WriterAppender::writeFooter(Pool& p)
 {
         if (layout != NULL) {
-          LogString foot;
-          layout->appendFooter(foot, p);
+          FormatBuffer foot;
+          layout->appendFooter(foot.get(), p);
           synchronized sync(mutex);
-          writer->write(foot, p);
+          writer->write(foot.get(), p);
         }
 }
 
 void WriterAppender::writeHeader(Pool& p)
 {
         if(layout != NULL) {
-          LogString header;
-          layout->appendHeader(header, p);
+          FormatBuffer header;
+          layout->appendHeader(header.get(), p);
           synchronized sync(mutex);
-          writer->write(header, p);
+          writer->write(header.get(), p);
         }
 }
 
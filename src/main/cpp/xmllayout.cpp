@@ -86,20 +86,42 @@ void XMLLayout::format(LogString& output,
         {
                 output.append(LOG4CXX_STR("<log4j:locationInfo class=\""));
                 const LocationInfo& locInfo = event->getLocationInformation();
-                LOG4CXX_DECODE_CHAR(className, locInfo.getClassName());
-                Transform::appendEscapingTags(output, className);
+                LogString className;
+                Transform::appendEscapingTags(output, locInfo.getClassName(className));
                 output.append(LOG4CXX_STR("\" method=\""));
-                LOG4CXX_DECODE_CHAR(method, locInfo.getMethodName());
-                Transform::appendEscapingTags(output, method);
+                LogString method;
+                Transform::appendEscapingTags(output, locInfo.getMethodName(method));
                 output.append(LOG4CXX_STR("\" file=\""));
-                LOG4CXX_DECODE_CHAR(fileName, locInfo.getFileName());
-                Transform::appendEscapingTags(output, fileName);
+                LogString fileName;
+                Transform::appendEscapingTags(output, locInfo.getFileName(fileName));
                 output.append(LOG4CXX_STR("\" line=\""));
                 StringHelper::toString(locInfo.getLineNumber(), p, output);
                 output.append(LOG4CXX_STR("\"/>"));
                 output.append(LOG4CXX_EOL);
         }
         
+        const FieldList& fields = event->getFields();
+        if (!fields.empty()) {
+            output.append(LOG4CXX_STR("<log4j:fields>"));
+            output.append(LOG4CXX_EOL);
+            for (FieldList::const_iterator field = fields.begin();
+                    field != fields.end();
+                    field++) {
+                output.append(LOG4CXX_STR("<log4j:field name=\""));
+                Transform::appendEscapingTags(output, field->getKey());
+                output.append(LOG4CXX_STR("\" type=\""));
+                output.append(field->getTypeName());
+                output.append(LOG4CXX_STR("\" value=\""));
+                LogString value;
+                field->format(value);
+                Transform::appendEscapingTags(output, value);
+                output.append(LOG4CXX_STR("\"/>"));
+                output.append(LOG4CXX_EOL);
+            }
+            output.append(LOG4CXX_STR("</log4j:fields>"));
+            output.append(LOG4CXX_EOL);
+        }
+
         if (properties) {
             LoggingEvent::KeySet propertySet(event->getPropertyKeySet());
             LoggingEvent::KeySet keySet(event->getMDCKeySet());
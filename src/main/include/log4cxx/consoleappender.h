@@ -19,6 +19,7 @@
 #define _LOG4CXX_CONSOLE_APPENDER_H
 
 #include <log4cxx/writerappender.h>
+#include <log4cxx/helpers/consoleoutputstream.h>
 
 namespace log4cxx
 {
@@ -33,6 +34,24 @@ namespace log4cxx
         private:
                 LogString target;
 
+                /**
+                Is output written to the file descriptor rather than
+                through stdio? */
+                bool directWrite;
+
+                /**
+                Is output written by a background thread, dropping
+                output that does not fit in the buffer? */
+                bool nonBlocking;
+
+                /**
+                Largest number of bytes held for the background thread. */
+                int bufferSize;
+
+                /**
+                Stream in use for DirectWrite or NonBlocking, null otherwise. */
+                log4cxx::helpers::ConsoleOutputStreamPtr stream;
+
         public:
                 DECLARE_LOG4CXX_OBJECT(ConsoleAppender)
                 BEGIN_LOG4CXX_CAST_MAP()
@@ -61,6 +80,58 @@ namespace log4cxx
                 * */
                 LogString getTarget() const;
 
+                /**
+                Get the value of the <b>DirectWrite</b> option.
+                */
+                inline bool getDirectWrite() const { return directWrite; }
+
+                /**
+                The <b>DirectWrite</b> option takes a boolean value, <code>false</code>
+                by default.  If true, encoded output is written to the file
+                descriptor with write rather than through stdio,
+                so appending does not take the stdio lock.  Output that the
+                program writes through stdio is not ordered with it.
+
+                <p>Note: Takes effect in #activateOptions.
+                */
+                void setDirectWrite(bool value);
+
+                /**
+                Get the value of the <b>NonBlocking</b> option.
+                */
+                inline bool getNonBlocking() const { return nonBlocking; }
+
+                /**
+                The <b>NonBlocking</b> option takes a boolean value, <code>false</code>
+                by default.  If true, output is written as with <code>DirectWrite</code>
+                but by a background thread, from a buffer of at most
+                <code>BufferSize</code> bytes.  Events that do not fit because
+                the reader of the console has stalled are dropped and counted
+                by #getDroppedCount, so appending never waits for the console.
+                No warning is written for drops, since stderr may be the
+                stalled console.
+
+                <p>Note: Takes effect in #activateOptions.
+                */
+                void setNonBlocking(bool value);
+
+                /**
+                Get the size of the <b>NonBlocking</b> buffer.
+                */
+                inline int getBufferSize() const { return bufferSize; }
+
+                /**
+                Set the size of the <b>NonBlocking</b> buffer,
+                256 KB by default.
+                */
+                void setBufferSize(int bufferSize);
+
+                /**
+                Returns the number of events dropped by the <b>NonBlocking</b>
+                option since the appender was activated.
+                */
+                unsigned int getDroppedCount() const;
+
                 void activateOptions(log4cxx::helpers::Pool& p);
                 void setOption(const LogString& option, const LogString& value);
                 static const LogString& getSystemOut();
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_CONTEXT_H
+#define _LOG4CXX_CONTEXT_H
+
+#include <log4cxx/log4cxx.h>
+
+namespace log4cxx
+{
+        namespace helpers {
+                class MDCMap;
+                class NDCNode;
+        }
+
+        /**
+        A context is a handle to the mapped and nested diagnostic
+        contexts (MDC and NDC) of a thread at the time it was created.
+
+        <p>Creating a context does not copy the MDC or NDC, it only
+        takes a reference to the current values which are never modified
+        in place, so a context is cheap to create and to copy.  It can be
+        handed to a task running on another thread which installs it for
+        the duration of the task with a Context::Scope:
+
+        <pre>
+        // on the submitting thread
+        log4cxx::Context context;
+        ...
+        // on the worker thread
+        {
+            log4cxx::Context::Scope scope(context);
+            LOG4CXX_INFO(logger, "carries the MDC and NDC of the submitter");
+        }
+        </pre>
+
+        <p>Changes made to the MDC or NDC while a context is installed
+        do not affect the context or the thread that created it.
+        */
+        class LOG4CXX_EXPORT Context
+        {
+        public:
+                /**
+                 *  Captures the MDC and NDC of the current thread.
+                 */
+                Context();
+                Context(const Context& src);
+                Context& operator=(const Context& src);
+                ~Context();
+
+                /**
+                 *  Replaces the MDC and NDC of the current thread
+                 *  with the ones held by this context.
+                 */
+                void install() const;
+
+                class Scope;
+
+        private:
+                const helpers::MDCMap* mdc;
+                const helpers::NDCNode* ndc;
+        };
+
+        /**
+         *  Installs a context on the current thread
+         *  and restores the previous MDC and NDC on destruction.
+         */
+        class LOG4CXX_EXPORT Context::Scope
+        {
+        public:
+                Scope(const Context& context);
+                ~Scope();
+
+        private:
+                Scope(const Scope&);
+                Scope& operator=(const Scope&);
+                const Context previous;
+        };
+}  // namespace log4cxx
+
+#endif
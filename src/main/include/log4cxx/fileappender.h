@@ -23,6 +23,7 @@
 #include <log4cxx/writerappender.h>
 #include <log4cxx/file.h>
 #include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/groupcommitoutputstream.h>
 
 namespace log4cxx
 {
@@ -61,6 +62,52 @@ namespace log4cxx
                 How big should the IO buffer be? Default is 8K. */
                 int bufferSize;
 
+                /**
+                Longest time in milliseconds that output may be held
+                before being written, 0 if output is not written
+                on a background thread. */
+                int flushIntervalMillis;
+
+                /**
+                Do threads append to the file without holding
+                the appender lock? */
+                bool concurrentWrites;
+
+                /**
+                Bytes of the file mapped into memory at a time,
+                0 if the file is not memory mapped. */
+                int mapWindowSize;
+
+                /**
+                Are writes submitted to the file without waiting
+                for them to complete? */
+                bool asyncIO;
+
+                /**
+                Longest time in milliseconds that written output waits
+                to be synced to the storage device, 0 if output is not synced. */
+                int commitIntervalMillis;
+
+                /**
+                Bytes of output that start a sync before
+                the commit interval has passed, 0 if none. */
+                int commitSize;
+
+                /**
+                Events at or above this level wait for their
+                output to be synced, null if none wait. */
+                LevelPtr commitLevel;
+
+                /**
+                Bytes allocated on disk ahead of the end
+                of the file, 0 if none. */
+                int preallocationSize;
+
+                /**
+                Bytes written between drops of the written
+                output from the page cache, 0 if none. */
+                int dropCacheSize;
+
         public:
                 DECLARE_LOG4CXX_OBJECT(FileAppender)
                 BEGIN_LOG4CXX_CAST_MAP()
@@ -203,6 +250,174 @@ namespace log4cxx
                 */
                 void setBufferSize(int bufferSize1) { this->bufferSize = bufferSize1; }
 
+                /**
+                Get the value of the <b>FlushIntervalMillis</b> option.
+                */
+                inline int getFlushIntervalMillis() const { return flushIntervalMillis; }
+
+                /**
+                The <b>FlushIntervalMillis</b> option takes a number of milliseconds,
+                0 by default.  If positive, formatted output is collected in a
+                memory buffer and written to the file by a background thread
+                when <code>BufferSize</code> bytes are waiting or the interval
+                has passed, so output is never held longer than the interval.
+                Immediate flush and <code>BufferedIO</code> are not used
+                with this option.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setFlushIntervalMillis(int millis);
+
+                /**
+                Get the value of the <b>ConcurrentWrites</b> option.
+                */
+                inline bool getConcurrentWrites() const { return concurrentWrites; }
+
+                /**
+                The <b>ConcurrentWrites</b> option takes a boolean value, <code>false</code>
+                by default.  If true, threads format events and write them to the
+                file without holding the appender lock.  Each write reserves its
+                byte range at the end of the file and fills it with a positional
+                write, so records never interleave.  Filters, layout and threshold
+                must not be changed while logging.  The option is ignored if
+                positional writes are not available, or if <code>BufferedIO</code>
+                or <code>FlushIntervalMillis</code> is set.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setConcurrentWrites(bool value);
+
+                /**
+                Get the value of the <b>MapWindowSize</b> option.
+                */
+                inline int getMapWindowSize() const { return mapWindowSize; }
+
+                /**
+                The <b>MapWindowSize</b> option takes a size such as "64MB", 0 by
+                default.  If positive, the file is written through a memory mapping
+                of that many bytes, which is allocated on disk in advance and
+                replaced by a background thread as it fills, so appending an
+                event needs no system call.  The file is truncated to its content
+                when closed or rolled over, but may end with zero bytes if the
+                process stops without closing it.  The option is ignored if memory
+                mapped files are not available or <code>ConcurrentWrites</code>
+                is in effect.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setMapWindowSize(int bytes);
+
+                /**
+                Get the value of the <b>AsyncIO</b> option.
+                */
+                inline bool getAsyncIO() const { return asyncIO; }
+
+                /**
+                The <b>AsyncIO</b> option takes a boolean value, <code>false</code>
+                by default.  If true, output is copied into buffers of
+                <code>BufferSize</code> bytes that are written through io_uring,
+                with several writes in flight, so a slow disk does not hold up
+                the thread appending an event.  The option is ignored if log4cxx
+                was built without io_uring or the kernel does not provide it, or
+                if <code>ConcurrentWrites</code> or <code>MapWindowSize</code>
+                is in effect.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setAsyncIO(bool value);
+
+                /**
+                Get the value of the <b>CommitIntervalMillis</b> option.
+                */
+                inline int getCommitIntervalMillis() const { return commitIntervalMillis; }
+
+                /**
+                The <b>CommitIntervalMillis</b> option takes a number of milliseconds,
+                0 by default.  If positive, a background thread syncs the file
+                to the storage device with fdatasync at least that often, so
+                written output is durable within the interval without a sync
+                for every event.  Output held by <code>BufferedIO</code> or
+                <code>FlushIntervalMillis</code> is only covered once written
+                to the file.  <code>AsyncIO</code> is ignored with this option.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setCommitIntervalMillis(int millis);
+
+                /**
+                Get the value of the <b>CommitSize</b> option.
+                */
+                inline int getCommitSize() const { return commitSize; }
+
+                /**
+                The <b>CommitSize</b> option takes a size such as "1MB", 0 by default.
+                If positive, the file is also synced as soon as that many bytes
+                have been written since the last sync.  Used only with
+                <code>CommitIntervalMillis</code>.
+                */
+                void setCommitSize(int bytes);
+
+                /**
+                Get the value of the <b>CommitLevel</b> option.
+                */
+                inline const LevelPtr& getCommitLevel() const { return commitLevel; }
+
+                /**
+                The <b>CommitLevel</b> option takes a level, none by default.
+                A thread appending an event at or above the level waits until
+                the event has been synced, after writing any output held by
+                <code>BufferedIO</code> or <code>FlushIntervalMillis</code> to
+                the file.  Threads waiting at the same time share one sync.  Used only with <code>CommitIntervalMillis</code>.
+                */
+                void setCommitLevel(const LevelPtr& level);
+
+                /**
+                Get the value of the <b>PreallocationSize</b> option.
+                */
+                inline int getPreallocationSize() const { return preallocationSize; }
+
+                /**
+                The <b>PreallocationSize</b> option takes a size such as "64MB", 0 by
+                default.  If positive, disk blocks are allocated in chunks of that
+                size beyond the end of the file with fallocate, without changing the
+                file size, so a growing file is not fragmented and does not update
+                the file system metadata for every block.  Blocks still unused are
+                released when the file is closed.  Ignored where fallocate is not
+                available.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setPreallocationSize(int bytes);
+
+                /**
+                Get the value of the <b>DropCacheSize</b> option.
+                */
+                inline int getDropCacheSize() const { return dropCacheSize; }
+
+                /**
+                The <b>DropCacheSize</b> option takes a size such as "8MB", 0 by
+                default.  If positive, each time that many bytes have been written
+                their write-back is started with sync_file_range and the bytes
+                written before them are dropped from the page cache with
+                posix_fadvise, so the log file does not evict other data from the
+                cache.  Ignored where these calls are not available.
+
+                <p>Note: Takes effect when the file is opened by #activateOptions.
+                */
+                void setDropCacheSize(int bytes);
+
+                /**
+                Appends the event without holding the appender lock when
+                <b>ConcurrentWrites</b> is in effect.
+                */
+                virtual void doAppend(const spi::LoggingEventPtr& event,
+                        log4cxx::helpers::Pool& pool);
+
+                /**
+                Closes the file after waiting for concurrent appends.
+                */
+                virtual void close();
+
                 /**
                  *   Replaces double backslashes with single backslashes
                  *   for compatibility with paths from earlier XML configurations files.
@@ -211,7 +426,90 @@ namespace log4cxx
                  */
                 static LogString stripDuplicateBackslashes(const LogString& name);
 
+                protected:
+                /**
+                Returns an OutputStreamWriter for the stream, which is
+                first wrapped in a DoubleBufferedOutputStream when
+                <b>FlushIntervalMillis</b> is positive.
+                */
+                virtual log4cxx::helpers::WriterPtr createWriter(
+                    log4cxx::helpers::OutputStreamPtr& os);
+
+                /**
+                Returns the stream wrapped in a DoubleBufferedOutputStream
+                when <b>FlushIntervalMillis</b> is positive, otherwise the
+                stream itself.
+                */
+                log4cxx::helpers::OutputStreamPtr createBufferedOutputStream(
+                    log4cxx::helpers::OutputStreamPtr& os);
+
+                /**
+                Opens the file with a FileOutputStream using <b>PreallocationSize</b>
+                and <b>DropCacheSize</b>, or a ConcurrentFileOutputStream when
+                <b>ConcurrentWrites</b> is in effect, a MappedFileOutputStream
+                when <b>MapWindowSize</b> is positive or an UringFileOutputStream
+                when <b>AsyncIO</b> is set, wrapped in a GroupCommitOutputStream
+                when <b>CommitIntervalMillis</b> is positive.  The stream must be
+                passed to setWriter while an AppendBarrier is held.
+                @param filename file name.
+                @param append true to append to an existing file.
+                @return new stream.
+                @throws IOException if the file could not be opened.
+                */
+                log4cxx::helpers::OutputStreamPtr createFileOutputStream(
+                        const LogString& filename, bool append);
+
+                /**
+                Returns the stream wrapped in a GroupCommitOutputStream
+                when <b>CommitIntervalMillis</b> is positive, otherwise the
+                stream itself.
+                */
+                virtual log4cxx::helpers::OutputStreamPtr createCommitStream(
+                    log4cxx::helpers::OutputStreamPtr& os);
+
+                /**
+                Called when appending concurrently to check if the event
+                must take the locked path instead.  The base class
+                returns <code>true</code>.
+                */
+                virtual bool canAppendConcurrently(const spi::LoggingEventPtr& event);
+
+                /**
+                Waits for concurrent appends in progress and holds back new
+                ones until destroyed, used when the file is replaced or closed.
+                The caller must hold the appender mutex.
+                */
+                class LOG4CXX_EXPORT AppendBarrier {
+                public:
+                    AppendBarrier(FileAppender& appender);
+                    ~AppendBarrier();
                 private:
+                    AppendBarrier(const AppendBarrier&);
+                    AppendBarrier& operator=(const AppendBarrier&);
+                    FileAppender& appender;
+                };
+
+                private:
+                /**
+                Number of appends in progress without the appender lock.
+                */
+                unsigned int volatile concurrentAppends;
+                /**
+                Number of AppendBarrier instances in effect.
+                */
+                unsigned int volatile appendBarriers;
+                /**
+                Is the current writer safe for concurrent appends?
+                */
+                bool volatile concurrentFile;
+                /**
+                Stream syncing the current file, null if none.
+                */
+                log4cxx::helpers::GroupCommitOutputStreamPtr commitStream;
+
+                void awaitCommit(const spi::LoggingEventPtr& event,
+                        log4cxx::helpers::Pool& p);
+
                 FileAppender(const FileAppender&);
                 FileAppender& operator=(const FileAppender&);
 
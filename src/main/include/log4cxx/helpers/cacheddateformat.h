@@ -82,34 +82,67 @@ namespace log4cxx
             log4cxx::helpers::DateFormatPtr formatter;
 
             /**
-             *  Index of initial digit of millisecond pattern or
-             *   UNRECOGNIZED_MILLISECONDS or NO_MILLISECONDS.
+             *  Maximum validity period for the cache.
+             *  Typically 1, use cache for duplicate requests only, or
+             *  1000000, use cache for requests within the same integral second.
              */
-            mutable int millisecondStart;
+            const int expiration;
 
             /**
-             *  Integral second preceding the previous convered Date.
+             *  Cache state of a single thread.  Each formatting thread
+             *  owns one so that concurrent calls to format neither
+             *  race nor contend.
              */
-            mutable log4cxx_time_t slotBegin;
+            class ThreadCache {
+            public:
+                ThreadCache();
+
+                /**
+                 *  Value of owner's generation when the cache was filled.
+                 */
+                unsigned int generation;
+
+                /**
+                 *  Index of initial digit of millisecond pattern or
+                 *   UNRECOGNIZED_MILLISECONDS or NO_MILLISECONDS.
+                 */
+                int millisecondStart;
+
+                /**
+                 *  Integral second preceding the previous convered Date.
+                 */
+                log4cxx_time_t slotBegin;
+
+                /**
+                 *  Cache of previous conversion.
+                 */
+                LogString cache;
 
+                /**
+                 *  Date requested in previous conversion.
+                 */
+                log4cxx_time_t previousTime;
+
+            private:
+                ThreadCache(const ThreadCache&);
+                ThreadCache& operator=(const ThreadCache&);
+            };
 
             /**
-             *  Cache of previous conversion.
+             *  Incremented by setTimeZone to invalidate every thread's cache.
              */
-            mutable LogString cache;
-
+            mutable volatile unsigned int generation;
 
             /**
-             *  Maximum validity period for the cache.
-             *  Typically 1, use cache for duplicate requests only, or
-             *  1000000, use cache for requests within the same integral second.
+             *  Process-wide identifier of this format, keys its
+             *  cache in each thread's cache map.
              */
-            const int expiration;
+            unsigned int id;
 
             /**
-             *  Date requested in previous conversion.
+             *  Maps formats to the caches of each thread.
              */
-            mutable log4cxx_time_t previousTime;
+            class ThreadCacheTable;
 
        public:
           /**
@@ -122,6 +155,8 @@ namespace log4cxx
            */
             CachedDateFormat(const log4cxx::helpers::DateFormatPtr& dateFormat, int expiration);
 
+            ~CachedDateFormat();
+
             /**
              * Finds start of millisecond field in formatted time.
              * @param time long time, must be integral number of seconds
@@ -186,7 +221,8 @@ namespace log4cxx
                *    conversion pattern.
                *  @param pattern conversion pattern, may not be null.
                *  @returns Duration in microseconds from an integral second
-               *      that the cache will return consistent results.
+               *      that the cache will return consistent results, 0 if
+               *      the pattern shows nanoseconds and should not be cached.
                */
                static int getMaximumCacheValidity(const LogString& pattern);
 
@@ -194,6 +230,11 @@ namespace log4cxx
                CachedDateFormat(const CachedDateFormat&);
                CachedDateFormat& operator=(const CachedDateFormat&);
 
+               /**
+                *  Gets the calling thread's cache, allocating it on first use.
+                */
+               ThreadCache& getThreadCache() const;
+
                /**
                * Tests if two string regions are equal.
                * @param target target string.
@@ -61,8 +61,10 @@ namespace log4cxx
                *  Get encoder for specified character set.
                *  @param charset the following values should be recognized:
                *     "US-ASCII", "ISO-8859-1", "UTF-8",
-               *     "UTF-16BE", "UTF-16LE".
-               *  @return encoder.
+               *     "UTF-16BE", "UTF-16LE" and the single byte character
+               *     sets of SingleByteCharset, others use apr_xlate.
+               *  @return encoder, shared with other callers requesting
+               *     the same character set unless it uses apr_xlate.
                *  @throws IllegalArgumentException if encoding is not recognized.
                */
                 static CharsetEncoderPtr getEncoder(const LogString& charset);
@@ -106,6 +108,14 @@ namespace log4cxx
                */
                   virtual void flush(ByteBuffer& out);
 
+              /**
+               *   Determines if the encoded bytes are the same as
+               *   the bytes of the LogString, so the string can be
+               *   written without encoding.
+               *   @return true if encoding is a copy.
+               */
+                  virtual bool isIdentity() const;
+
               /**
                *   Determines if the return value from encode indicates
                *     an unconvertable character.
@@ -126,6 +136,11 @@ namespace log4cxx
                   CharsetEncoder& operator=(const CharsetEncoder&);
 
               static CharsetEncoder* createDefaultEncoder();
+              /**
+               *   Creates a new stateless encoder for getEncoder to cache.
+               *   @return encoder or null if the charset needs apr_xlate.
+               */
+              static CharsetEncoder* createEncoder(const LogString& charset);
         };
 
         } // namespace helpers
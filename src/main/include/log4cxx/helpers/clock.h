@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_CLOCK_H
+#define _LOG4CXX_HELPERS_CLOCK_H
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/objectptr.h>
+
+
+namespace log4cxx {
+   namespace helpers {
+     class Clock;
+     LOG4CXX_PTR_DEF(Clock);
+
+     /**
+     *    Source of the time stamps of logging events.
+     *
+     *    A clock may trade precision for speed (see getCoarse)
+     *    or speed and resolution for a small drift between
+     *    resynchronizations (see getTSC). Each logger repository
+     *    has its own clock, set with the "log4j.clock" property or
+     *    the "clock" attribute of the XML configuration.
+     */
+      class LOG4CXX_EXPORT Clock : public ObjectImpl {
+      public:
+      DECLARE_ABSTRACT_LOG4CXX_OBJECT(Clock)
+      BEGIN_LOG4CXX_CAST_MAP()
+              LOG4CXX_CAST_ENTRY(Clock)
+      END_LOG4CXX_CAST_MAP()
+
+      virtual ~Clock();
+
+      /**
+       *   Current time.
+       *   @return nanoseconds elapsed since 1970-01-01 00:00:00 UTC.
+       */
+      virtual log4cxx_int64_t currentTimeNanos() const = 0;
+
+      /**
+       *   Clock based on apr_time_now, microsecond resolution.
+       */
+      static const ClockPtr& getDefault();
+
+      /**
+       *   Clock based on CLOCK_REALTIME_COARSE where available,
+       *   typically with a resolution of a few milliseconds.
+       *   Same as getDefault on other platforms.
+       */
+      static const ClockPtr& getCoarse();
+
+      /**
+       *   Clock extrapolated from the processor time stamp counter,
+       *   calibrated against the system clock and resynchronized
+       *   at least once a second.  Same as getDefault if the
+       *   processor does not have an invariant time stamp counter.
+       */
+      static const ClockPtr& getTSC();
+
+      /**
+       *   Gets a clock by name.
+       *   @param name "default", "coarse" or "tsc", case insensitive.
+       *   @param defaultClock clock returned for unrecognized names.
+       *   @return clock.
+       */
+      static ClockPtr getClock(const LogString& name, const ClockPtr& defaultClock);
+
+      protected:
+      Clock();
+
+      private:
+      Clock(const Clock&);
+      Clock& operator=(const Clock&);
+      };
+
+   }
+}
+
+
+#endif
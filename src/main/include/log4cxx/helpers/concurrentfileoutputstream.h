@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_CONCURRENT_FILE_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_CONCURRENT_FILE_OUTPUT_STREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/file.h>
+
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that may be written by several threads at once.
+          *
+          *   <p>Each write reserves a byte range at the end of the file by
+          *   advancing the file offset atomically, then writes its bytes into
+          *   that range with a positional write.  Writes from different
+          *   threads proceed in parallel and never interleave.  close waits
+          *   for writes in progress.  The file must not be written by other
+          *   streams or processes at the same time.
+          */
+          class LOG4CXX_EXPORT ConcurrentFileOutputStream : public OutputStream
+          {
+          public:
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(ConcurrentFileOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(ConcurrentFileOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  ConcurrentFileOutputStream(const LogString& filename, bool append = false);
+                  virtual ~ConcurrentFileOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+                  virtual void sync(Pool& p);
+
+                  /**
+                   *  Determines if positional writes are available
+                   *  on this platform.
+                   */
+                  static bool isSupported();
+
+          private:
+                  ConcurrentFileOutputStream(const ConcurrentFileOutputStream&);
+                  ConcurrentFileOutputStream& operator=(const ConcurrentFileOutputStream&);
+                  log4cxx_int64_t reserve(size_t length);
+
+                  Pool pool;
+                  Mutex mutex;
+                  apr_file_t* fileptr;
+                  int fd;
+                  /**
+                   *  Offset of the next reserved byte range.
+                   */
+                  log4cxx_int64_t volatile offset;
+                  unsigned int volatile activeWrites;
+                  unsigned int volatile closing;
+          };
+
+          LOG4CXX_PTR_DEF(ConcurrentFileOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_CONCURRENT_FILE_OUTPUT_STREAM_H
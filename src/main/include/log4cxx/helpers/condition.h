@@ -61,6 +61,16 @@ namespace log4cxx
                          *  @throws InterruptedException if thread is interrupted.
                          */
                         void await(Mutex& lock);
+                        /**
+                         *  Await signaling of condition for a limited time.
+                         *  @param lock lock associated with condition, calling thread must
+                         *  own lock.  Lock will be released while waiting and reacquired
+                         *  before returning from wait.
+                         *  @param millis maximum time to wait in milliseconds.
+                         *  @return false if the time elapsed.
+                         *  @throws InterruptedException if thread is interrupted.
+                         */
+                        bool await(Mutex& lock, int millis);
 
                 private:
                         apr_thread_cond_t* condition;
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_CONSOLE_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_CONSOLE_OUTPUT_STREAM_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/condition.h>
+#include <log4cxx/helpers/thread.h>
+#include <vector>
+
+extern "C" {
+typedef struct apr_file_t apr_file_t;
+}
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that writes to the standard output or standard
+          *   error file descriptor with write, bypassing stdio
+          *   and its lock.
+          *
+          *   <p>With a buffer size of 0 each write is made by the calling
+          *   thread.  Otherwise writers copy into a buffer of at most
+          *   bufferSize bytes and return, and a background thread writes
+          *   everything collected since its last write in a single call.
+          *   If the buffer is full because the reader of the console is
+          *   not keeping up, the output is dropped and counted rather than
+          *   blocking the writer.  The bytes written between beginEvent
+          *   and endEvent are kept or dropped together.  close waits at
+          *   most about a second for a stalled console.
+          */
+          class LOG4CXX_EXPORT ConsoleOutputStream : public OutputStream
+          {
+          public:
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(ConsoleOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(ConsoleOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  /**
+                   *  Creates a new instance.
+                   *  @param err true for standard error, false for standard output.
+                   *  @param bufferSize largest number of bytes held for the
+                   *  background thread, 0 to write from the calling thread.
+                   */
+                  ConsoleOutputStream(bool err, size_t bufferSize);
+                  virtual ~ConsoleOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+
+                  /**
+                   *  Starts an event.  With a buffer, the bytes written until
+                   *  endEvent are held back and buffered or dropped together.
+                   *  Only the thread writing to the stream may call this.
+                   */
+                  void beginEvent();
+
+                  /**
+                   *  Ends the event started by beginEvent.
+                   */
+                  void endEvent();
+
+                  /**
+                   *  Gets the number of events dropped because the buffer was
+                   *  full, counting each write made outside an event as one.
+                   *  @return number of dropped events.
+                   */
+                  unsigned int getDropped() const;
+
+          private:
+                  ConsoleOutputStream(const ConsoleOutputStream&);
+                  ConsoleOutputStream& operator=(const ConsoleOutputStream&);
+                  void enqueue(const char* data, size_t length);
+                  void writeFully(const char* data, size_t length);
+                  bool writeBounded(const char* data, size_t length);
+                  enum { POLL_MILLIS = 100, CLOSE_MILLIS = 1000 };
+                  static void* LOG4CXX_THREAD_FUNC writer(apr_thread_t* thread, void* data);
+
+                  Pool pool;
+                  apr_file_t* file;
+                  int fd;
+                  size_t bufferSize;
+                  /**
+                   *  Guards the front buffer and closed.
+                   */
+                  Mutex mutex;
+                  Condition bufferNotEmpty;
+                  std::vector<char> front;
+                  std::vector<char> back;
+                  /**
+                   *  Bytes of the current event, used only by the writing thread.
+                   */
+                  std::vector<char> pending;
+                  bool inEvent;
+                  bool eventDropped;
+                  volatile unsigned int dropped;
+                  bool closed;
+                  Thread thread;
+          };
+
+          LOG4CXX_PTR_DEF(ConsoleOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXX_HELPERS_CONSOLE_OUTPUT_STREAM_H
@@ -50,6 +50,15 @@ namespace log4cxx
                    */
                    virtual void format(LogString &s, log4cxx_time_t tm, log4cxx::helpers::Pool& p) const = 0;
 
+                   /**
+                   * Formats a time with nanosecond resolution.  The default
+                   * implementation truncates the time to microseconds.
+                   * @param s string to which the date/time string is appended.
+                   * @param nanos nanoseconds elapsed since 1970-01-01.
+                   * @param p memory pool used during formatting.
+                   */
+                   virtual void formatNanos(LogString &s, log4cxx_int64_t nanos, log4cxx::helpers::Pool& p) const;
+
                    /**
                    * Sets the time zone.
                    * @param zone the given new time zone.
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_DOUBLE_BUFFERED_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_DOUBLE_BUFFERED_OUTPUT_STREAM_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/condition.h>
+#include <log4cxx/helpers/thread.h>
+#include <vector>
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that collects bytes in memory and writes
+          *   them to another stream on a background thread.
+          *
+          *   <p>Writers append to a front buffer while holding a lock
+          *   only for the copy.  The flusher thread swaps the front buffer
+          *   with an empty back buffer and writes the back buffer when
+          *   the front buffer holds bufferSize bytes or when
+          *   flushIntervalMillis have passed, so no output waits longer
+          *   than the interval.  Writers block only if the front buffer
+          *   reaches MAX_BUFFERS times bufferSize while the flusher thread
+          *   is still writing.  flush and close write all collected bytes
+          *   before returning.
+          */
+          class LOG4CXX_EXPORT DoubleBufferedOutputStream : public OutputStream
+          {
+          public:
+                  enum { MAX_BUFFERS = 4 };
+
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(DoubleBufferedOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(DoubleBufferedOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  /**
+                   *  Creates a new instance and starts the flusher thread.
+                   *  @param out destination stream, may not be null.
+                   *  @param bufferSize bytes collected before the flusher
+                   *  thread is woken.
+                   *  @param flushIntervalMillis longest time in milliseconds that
+                   *  collected bytes wait to be written, 0 to only write a full
+                   *  buffer.
+                   */
+                  DoubleBufferedOutputStream(OutputStreamPtr& out,
+                      size_t bufferSize, int flushIntervalMillis);
+                  virtual ~DoubleBufferedOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+
+          private:
+                  DoubleBufferedOutputStream(const DoubleBufferedOutputStream&);
+                  DoubleBufferedOutputStream& operator=(const DoubleBufferedOutputStream&);
+                  void writeBuffer(Pool& p);
+                  static void* LOG4CXX_THREAD_FUNC flusher(apr_thread_t* thread, void* data);
+
+                  Pool pool;
+                  OutputStreamPtr out;
+                  size_t bufferSize;
+                  int flushIntervalMillis;
+                  /**
+                   *  Guards the front buffer and closed.
+                   */
+                  Mutex mutex;
+                  /**
+                   *  Held while the back buffer is written.
+                   */
+                  Mutex writeMutex;
+                  Condition bufferFull;
+                  Condition bufferSwapped;
+                  std::vector<char> front;
+                  std::vector<char> back;
+                  bool closed;
+                  Thread thread;
+          };
+
+          LOG4CXX_PTR_DEF(DoubleBufferedOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXX_HELPERS_DOUBLE_BUFFERED_OUTPUT_STREAM_H
@@ -36,6 +36,30 @@ namespace log4cxx
           private:
                   Pool pool;
                   apr_file_t* fileptr;
+                  /**
+                   *  Bytes allocated ahead of the end of the file, 0 if none.
+                   */
+                  size_t preallocationSize;
+                  /**
+                   *  Bytes written between page cache drops, 0 if none.
+                   */
+                  size_t dropCacheSize;
+                  /**
+                   *  Offset of the end of the file.
+                   */
+                  log4cxx_int64_t position;
+                  /**
+                   *  End of the allocated blocks.
+                   */
+                  log4cxx_int64_t allocated;
+                  /**
+                   *  End of the range whose write-back has been started.
+                   */
+                  log4cxx_int64_t flushed;
+                  /**
+                   *  End of the range dropped from the page cache.
+                   */
+                  log4cxx_int64_t dropped;
 
           public:
                   DECLARE_ABSTRACT_LOG4CXX_OBJECT(FileOutputStream)
@@ -46,13 +70,37 @@ namespace log4cxx
 
                   FileOutputStream(const LogString& filename, bool append = false);
                   FileOutputStream(const logchar* filename, bool append = false);
+                  /**
+                   *  Opens the file and limits its effect on the file system.
+                   *  @param filename file name.
+                   *  @param append true to append to an existing file.
+                   *  @param preallocationSize if positive, disk blocks are
+                   *  allocated in chunks of this many bytes beyond the end of the
+                   *  file, without changing its size, to limit fragmentation
+                   *  and block allocation as the file grows.
+                   *  @param dropCacheSize if positive, each time this many bytes
+                   *  have been written their write-back is started and the bytes
+                   *  written before them are dropped from the page cache.
+                   */
+                  FileOutputStream(const LogString& filename, bool append,
+                      size_t preallocationSize, size_t dropCacheSize);
                   virtual ~FileOutputStream();
 
                   virtual void close(Pool& p);
                   virtual void flush(Pool& p);
                   virtual void write(ByteBuffer& buf, Pool& p);
+                  virtual void sync(Pool& p);
+
+                  /**
+                   *  Writes the data of an open file to the storage device.
+                   *  @param file open file.
+                   *  @throws IOException if the data could not be written.
+                   */
+                  static void datasync(apr_file_t* file);
 
           private:
+                  void allocate(log4cxx_int64_t end);
+                  void dropCache();
                   FileOutputStream(const FileOutputStream&);
                   FileOutputStream& operator=(const FileOutputStream&);
                   static apr_file_t* open(const LogString& fn, bool append, 
@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_FORMAT_BUFFER_H
+#define _LOG4CXX_HELPERS_FORMAT_BUFFER_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/layout.h>
+#include <vector>
+
+
+namespace log4cxx
+{
+        namespace helpers
+        {
+                class ThreadSpecificData;
+
+                /**
+                 *   Borrows the formatting buffer of the current thread.
+                 *
+                 *   <p>The buffer keeps its capacity between uses, so
+                 *   formatting an event of a familiar size does not
+                 *   allocate.  The buffer is emptied when the
+                 *   FormatBuffer goes out of scope, and released if it has
+                 *   grown beyond HIGH_WATER characters.  A nested FormatBuffer
+                 *   on the same thread, for example one used by a layout
+                 *   that itself logs, gets a private buffer.
+                 *
+                 *   <p>A FormatBuffer borrowed for an event keeps the formatted
+                 *   output on the thread, so the next appender writing the same
+                 *   event with an equivalent layout reuses it instead of
+                 *   formatting the event again, see Layout::isEquivalent.
+                 */
+                class LOG4CXX_EXPORT FormatBuffer
+                {
+                public:
+                        enum { HIGH_WATER = 32768 };
+
+                        FormatBuffer();
+
+                        /**
+                         *  Borrows the buffer to format an event.
+                         *  @param event event to be formatted.
+                         *  @param layout layout used to format the event.
+                         */
+                        FormatBuffer(const spi::LoggingEventPtr& event,
+                                     const LayoutPtr& layout);
+                        ~FormatBuffer();
+
+                        /**
+                         *  Gets the buffer, initially empty unless
+                         *  isFormatted returns true.
+                         */
+                        inline LogString& get() {
+                            return *buf;
+                        }
+
+                        /**
+                         *  Determines if the buffer already holds the event
+                         *  formatted by an equivalent layout.
+                         */
+                        inline bool isFormatted() const {
+                            return formatted;
+                        }
+
+                        /**
+                         *  Marks the buffer as holding the complete output
+                         *  of the layout for the event so later appenders
+                         *  may reuse it.
+                         */
+                        void setFormatted();
+
+                        /**
+                         *  Discards the formatted output kept by the current
+                         *  thread, called when an event has been passed
+                         *  to all appenders.
+                         */
+                        static void clearFormatted();
+
+                private:
+                        FormatBuffer(const FormatBuffer&);
+                        FormatBuffer& operator=(const FormatBuffer&);
+                        void acquire();
+                        ThreadSpecificData* data;
+                        LogString* buf;
+                        LogString local;
+                        const spi::LoggingEvent* event;
+                        const Layout* layout;
+                        bool formatted;
+                };
+
+                /**
+                 *   Borrows the encoded byte buffer of the current thread.
+                 *
+                 *   <p>Used like FormatBuffer for the bytes produced
+                 *   by a CharsetEncoder.  The buffer is released
+                 *   if it has grown beyond HIGH_WATER bytes.
+                 */
+                class LOG4CXX_EXPORT EncodeBuffer
+                {
+                public:
+                        enum { HIGH_WATER = 65536 };
+
+                        EncodeBuffer();
+                        ~EncodeBuffer();
+
+                        /**
+                         *  Gets the buffer, the contents are unspecified
+                         *  and its size is the largest size requested
+                         *  on this thread since the buffer was last released.
+                         */
+                        inline std::vector<char>& get() {
+                            return *buf;
+                        }
+
+                private:
+                        EncodeBuffer(const EncodeBuffer&);
+                        EncodeBuffer& operator=(const EncodeBuffer&);
+                        ThreadSpecificData* data;
+                        std::vector<char>* buf;
+                        std::vector<char> local;
+                };
+
+        }  // namespace helpers
+} // namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_GROUP_COMMIT_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_GROUP_COMMIT_OUTPUT_STREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/condition.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/exception.h>
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that makes the bytes written to another stream
+          *   durable in batches.
+          *
+          *   <p>A committer thread syncs the destination stream every
+          *   commitIntervalMillis, as soon as commitSize bytes have been
+          *   written since the last commit, or when a thread waits in
+          *   awaitCommit.  All bytes written before a commit starts are
+          *   durable when it ends, so threads that wait while a commit is
+          *   in progress share the next one.  When a commit fails, the
+          *   threads waiting for the bytes it covered receive the failure.
+          *   close commits the remaining bytes before closing the
+          *   destination.
+          */
+          class LOG4CXX_EXPORT GroupCommitOutputStream : public OutputStream
+          {
+          public:
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(GroupCommitOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(GroupCommitOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  /**
+                   *  Creates a new instance and starts the committer thread.
+                   *  @param out destination stream, may not be null.
+                   *  @param commitIntervalMillis longest time in milliseconds
+                   *  that written bytes wait to be committed.
+                   *  @param commitSize bytes written that start a commit
+                   *  before the interval has passed, 0 to only commit
+                   *  on the interval.
+                   */
+                  GroupCommitOutputStream(OutputStreamPtr& out,
+                      int commitIntervalMillis, size_t commitSize);
+                  virtual ~GroupCommitOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+                  /**
+                   *  Same as awaitCommit.
+                   */
+                  virtual void sync(Pool& p);
+
+                  /**
+                   *  Waits until the bytes written so far have been committed.
+                   *  @param p memory pool for operation.
+                   *  @throws IOException if the commit covering those bytes failed.
+                   */
+                  void awaitCommit(Pool& p);
+
+          private:
+                  GroupCommitOutputStream(const GroupCommitOutputStream&);
+                  GroupCommitOutputStream& operator=(const GroupCommitOutputStream&);
+                  void commit(Pool& p);
+                  void fail(log4cxx_int64_t target, const IOException& e);
+                  bool stopCommitter();
+                  static void* LOG4CXX_THREAD_FUNC committer(apr_thread_t* thread, void* data);
+
+                  Pool pool;
+                  OutputStreamPtr out;
+                  int commitIntervalMillis;
+                  size_t commitSize;
+                  /**
+                   *  Guards the counters below and closed.
+                   */
+                  Mutex mutex;
+                  Condition commitWanted;
+                  Condition committed;
+                  /**
+                   *  Bytes written since the stream was opened.
+                   */
+                  log4cxx_int64_t written;
+                  /**
+                   *  Bytes known to be durable.
+                   */
+                  log4cxx_int64_t durable;
+                  /**
+                   *  Bytes covered by the last failed commit.
+                   */
+                  log4cxx_int64_t failed;
+                  IOException failure;
+                  /**
+                   *  Threads in awaitCommit.
+                   */
+                  int waiters;
+                  bool closed;
+                  Thread thread;
+          };
+
+          LOG4CXX_PTR_DEF(GroupCommitOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_GROUP_COMMIT_OUTPUT_STREAM_H
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_MAPPED_FILE_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_MAPPED_FILE_OUTPUT_STREAM_H
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
+#include <log4cxx/helpers/condition.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/file.h>
+
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that copies bytes into a memory mapping of the file.
+          *
+          *   <p>The file is mapped in windows of windowSize bytes that are
+          *   allocated on disk before being mapped, so a write is a memory
+          *   copy with no system call.  A mapper thread allocates and maps
+          *   the window following the current one ahead of time and unmaps
+          *   windows that have been filled.  close truncates the file to
+          *   the bytes written.  If the process ends without close, the file
+          *   may be followed by up to windowSize zero bytes, which are
+          *   removed when the file is next opened for appending, so a file
+          *   whose content ends with zero bytes loses them.  Writes must be
+          *   serialized by the caller.
+          */
+          class LOG4CXX_EXPORT MappedFileOutputStream : public OutputStream
+          {
+          public:
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(MappedFileOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(MappedFileOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  /**
+                   *  Opens the file and maps the window holding its end.
+                   *  @param filename file name.
+                   *  @param append true to append to an existing file.
+                   *  @param windowSize bytes mapped at a time, rounded up
+                   *  to a multiple of the page size.
+                   *  @throws IOException if the file could not be opened or mapped.
+                   */
+                  MappedFileOutputStream(const LogString& filename, bool append,
+                      size_t windowSize);
+                  virtual ~MappedFileOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+                  virtual void sync(Pool& p);
+
+                  /**
+                   *  Determines if files can be memory mapped
+                   *  on this platform.
+                   */
+                  static bool isSupported();
+
+          private:
+                  MappedFileOutputStream(const MappedFileOutputStream&);
+                  MappedFileOutputStream& operator=(const MappedFileOutputStream&);
+
+                  /**
+                   *  Mapped range of the file.
+                   */
+                  struct Window {
+                      char* base;
+                      log4cxx_int64_t start;
+                  };
+
+                  log4cxx_status_t map(Window& window, log4cxx_int64_t start);
+                  void unmap(Window& window);
+                  log4cxx_status_t trimZeroTail(log4cxx_int64_t& end);
+                  void nextWindow();
+                  static void* LOG4CXX_THREAD_FUNC mapper(apr_thread_t* thread, void* data);
+
+                  Pool pool;
+                  apr_file_t* fileptr;
+                  int fd;
+                  size_t windowSize;
+                  /**
+                   *  Bytes written to the file.
+                   */
+                  log4cxx_int64_t length;
+                  Window current;
+                  /**
+                   *  Guards next, retired, nextReady, mapStatus and closed.
+                   */
+                  Mutex mutex;
+                  Condition windowMapped;
+                  Condition windowWanted;
+                  /**
+                   *  Window following current, mapped by the mapper thread.
+                   */
+                  Window next;
+                  /**
+                   *  Filled window waiting to be unmapped.
+                   */
+                  Window retired;
+                  bool nextReady;
+                  log4cxx_status_t mapStatus;
+                  bool closed;
+                  Thread thread;
+          };
+
+          LOG4CXX_PTR_DEF(MappedFileOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_MAPPED_FILE_OUTPUT_STREAM_H
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_MDC_MAP_H
+#define _LOG4CXX_HELPERS_MDC_MAP_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/objectptr.h>
+#include <vector>
+
+
+namespace log4cxx
+{
+        namespace helpers
+        {
+                /**
+                 *   Mapped diagnostic context of a thread, a small vector
+                 *   of values ordered by the interned key handles
+                 *   returned by MDC::getKey.
+                 *
+                 *   <p>A map that has been handed out as a snapshot, see
+                 *   ThreadSpecificData::getMDCSnapshot, is shared and must
+                 *   not be modified, the thread works on a copy instead.
+                 */
+                class LOG4CXX_EXPORT MDCMap : public ObjectImpl
+                {
+                public:
+                        DECLARE_LOG4CXX_OBJECT(MDCMap)
+                        BEGIN_LOG4CXX_CAST_MAP()
+                                LOG4CXX_CAST_ENTRY(MDCMap)
+                        END_LOG4CXX_CAST_MAP()
+
+                        typedef std::pair<int, LogString> Entry;
+                        LOG4CXX_LIST_DEF(EntryList, Entry);
+                        typedef EntryList::const_iterator const_iterator;
+
+                        MDCMap();
+                        MDCMap(const MDCMap& src);
+                        ~MDCMap();
+
+                        /**
+                         *  Determines if more than one reference to this
+                         *  map is held.
+                         */
+                        inline bool isShared() const {
+                            return ref > 1;
+                        }
+
+                        /**
+                         *  Gets the value of a key.
+                         *  @param key key handle.
+                         *  @return value or null if the key is not present.
+                         */
+                        const LogString* get(int key) const;
+
+                        /**
+                         *  Sets the value of a key.
+                         *  @param key key handle.
+                         *  @param value value.
+                         */
+                        void put(int key, const LogString& value);
+
+                        /**
+                         *  Removes a key.
+                         *  @param key key handle.
+                         *  @param value receives the previous value.
+                         *  @return true if the key was present.
+                         */
+                        bool remove(int key, LogString& value);
+
+                        void clear();
+
+                        inline bool empty() const {
+                            return entries.empty();
+                        }
+
+                        inline size_t size() const {
+                            return entries.size();
+                        }
+
+                        inline const_iterator begin() const {
+                            return entries.begin();
+                        }
+
+                        inline const_iterator end() const {
+                            return entries.end();
+                        }
+
+                        /**
+                         *  Copies the content to a map keyed by key name.
+                         *  @param map destination.
+                         */
+                        void toMap(MDC::Map& map) const;
+
+                private:
+                        MDCMap& operator=(const MDCMap&);
+                        EntryList::iterator lowerBound(int key);
+                        EntryList entries;
+                };
+                LOG4CXX_PTR_DEF(MDCMap);
+        }  // namespace helpers
+} // namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _LOG4CXX_HELPERS_NDC_NODE_H
+#define _LOG4CXX_HELPERS_NDC_NODE_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/objectptr.h>
+
+
+namespace log4cxx
+{
+        namespace helpers
+        {
+                /**
+                 *   Immutable frame of a nested diagnostic context.
+                 *
+                 *   <p>Each node holds a reference to the frame below it,
+                 *   so pushing a message does not copy the messages
+                 *   of the enclosing frames and a node can be shared by the
+                 *   thread and any number of logging events.  The full
+                 *   message, the space separated messages from the bottom
+                 *   frame up, is only rendered when first requested and is
+                 *   then kept with the node.
+                 */
+                class LOG4CXX_EXPORT NDCNode : public ObjectImpl
+                {
+                public:
+                        DECLARE_ABSTRACT_LOG4CXX_OBJECT(NDCNode)
+                        BEGIN_LOG4CXX_CAST_MAP()
+                                LOG4CXX_CAST_ENTRY(NDCNode)
+                        END_LOG4CXX_CAST_MAP()
+
+                        /**
+                         *  Creates a frame.
+                         *  @param parent enclosing frame, may be null.
+                         *  @param message message of this frame.
+                         */
+                        NDCNode(const NDCNode* parent, const LogString& message);
+
+                        /**
+                         *  Creates a frame whose full message is already known.
+                         *  @param parent enclosing frame, may be null.
+                         *  @param message message of this frame.
+                         *  @param fullMessage full message of this frame.
+                         */
+                        NDCNode(const NDCNode* parent, const LogString& message,
+                                const LogString& fullMessage);
+                        ~NDCNode();
+
+                        inline const NDCNode* getParent() const {
+                            return parent;
+                        }
+
+                        inline const LogString& getMessage() const {
+                            return message;
+                        }
+
+                        /**
+                         *  Gets the number of frames up to and including this one.
+                         */
+                        inline int getDepth() const {
+                            return depth;
+                        }
+
+                        /**
+                         *  Gets the full message, rendering it on first use.
+                         */
+                        const LogString& getFullMessage() const;
+
+                private:
+                        NDCNode(const NDCNode&);
+                        NDCNode& operator=(const NDCNode&);
+                        const LogString* getRenderedMessage() const;
+
+                        const NDCNode* const parent;
+                        const LogString message;
+                        const int depth;
+                        /**
+                         *  Rendered full message, LogString* set at most once.
+                         */
+                        mutable void* volatile fullMessage;
+                };
+        }  // namespace helpers
+} // namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif
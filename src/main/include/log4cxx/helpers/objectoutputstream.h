@@ -22,6 +22,7 @@
 #include <log4cxx/mdc.h>
 #include <log4cxx/helpers/outputstream.h>
 #include <log4cxx/helpers/charsetencoder.h>
+#include <log4cxx/spi/field.h>
 
 namespace log4cxx
 {
@@ -47,6 +48,16 @@ namespace log4cxx
                   void writeObject(const LogString&, Pool& p);
                   void writeUTFString(const std::string&, Pool& p);
                   void writeObject(const MDC::Map& mdc, Pool& p);
+                  /**
+                   *  Writes a java.util.Hashtable containing the MDC
+                   *  and the typed fields of an event, fields are written as
+                   *  java.lang.Long, java.lang.Double, java.lang.Boolean,
+                   *  java.lang.String or byte[].  A field replaces an MDC
+                   *  entry or an earlier field with the same key.
+                   */
+                  void writeObject(const MDC::Map& mdc,
+                        const spi::FieldList& fields, Pool& p);
+                  void writeObject(const spi::Field& field, Pool& p);
                   void writeInt(int val, Pool& p);
                   void writeLong(log4cxx_time_t val, Pool& p);
                   void writeProlog(const char* className,
@@ -77,6 +88,13 @@ namespace log4cxx
           private:
                   ObjectOutputStream(const ObjectOutputStream&);
                   ObjectOutputStream& operator=(const ObjectOutputStream&);
+                  /**
+                   *  Determines whether a field from the specified position
+                   *  on has the specified key.
+                   */
+                  static bool isShadowed(const LogString& key,
+                        spi::FieldList::const_iterator from,
+                        const spi::FieldList& fields);
                      
                   OutputStreamPtr os;
                   log4cxx::helpers::CharsetEncoderPtr utf8Encoder;
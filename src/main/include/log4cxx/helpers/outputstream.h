@@ -45,6 +45,12 @@ namespace log4cxx
                   virtual void close(Pool& p) = 0;
                   virtual void flush(Pool& p) = 0;
                   virtual void write(ByteBuffer& buf, Pool& p) = 0;
+                  /**
+                   *  Writes the bytes written so far to the storage device.
+                   *  The default implementation only calls flush.
+                   *  @param p memory pool for operation.
+                   */
+                  virtual void sync(Pool& p);
 
           private:
                   OutputStream(const OutputStream&);
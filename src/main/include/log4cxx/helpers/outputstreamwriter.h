@@ -35,6 +35,11 @@ namespace log4cxx
           private:
                   OutputStreamPtr out;
                   CharsetEncoderPtr enc;
+                  /**
+                   *  true if enc copies the LogString's bytes, so strings
+                   *  are written to out without encoding.
+                   */
+                  bool identity;
 
           public:
                   DECLARE_ABSTRACT_LOG4CXX_OBJECT(OutputStreamWriter)
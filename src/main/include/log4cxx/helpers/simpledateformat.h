@@ -37,6 +37,7 @@ namespace log4cxx
         {
           namespace SimpleDateFormatImpl {
             class PatternToken;
+            class CompiledPattern;
         }
 
           /**
@@ -60,6 +61,14 @@ namespace log4cxx
                                       log4cxx_time_t tm,
                                       log4cxx::helpers::Pool& p) const;
 
+                  /**
+                   * Formats a time with nanosecond resolution, the
+                   * nanoseconds are shown by a pattern of nine 'S'.
+                   */
+                  virtual void formatNanos(LogString& s,
+                                      log4cxx_int64_t nanos,
+                                      log4cxx::helpers::Pool& p) const;
+
                   /**
                    * Set time zone.
                    * @param zone new time zone.
@@ -78,7 +87,16 @@ namespace log4cxx
                   LOG4CXX_LIST_DEF(PatternTokenList, log4cxx::helpers::SimpleDateFormatImpl::PatternToken*);
 
                   PatternTokenList pattern;
-                  
+
+                  /**
+                   * Integer arithmetic equivalent of the pattern,
+                   * null if some token can not be compiled.
+                   */
+                  log4cxx::helpers::SimpleDateFormatImpl::CompiledPattern* compiled;
+
+                  void compilePattern();
+                  void formatTime(LogString& s, log4cxx_time_t tm,
+                                  int nanos, log4cxx::helpers::Pool& p) const;
                   static void addToken(const logchar spec, const int repeat, const std::locale* locale, PatternTokenList& pattern);
                   static void parsePattern(const LogString& spec, const std::locale* locale, PatternTokenList& pattern);
           };
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_SINGLEBYTECHARSET_H
+#define _LOG4CXX_HELPERS_SINGLEBYTECHARSET_H
+
+#include <log4cxx/logstring.h>
+
+namespace log4cxx
+{
+        namespace helpers {
+
+          /**
+          *   Mapping table for a single byte character set whose lower
+          *   half is US-ASCII, used by the table-driven charset encoders
+          *   and decoders in place of apr_xlate.
+          */
+          class LOG4CXX_EXPORT SingleByteCharset
+          {
+          public:
+                  enum { UNDEFINED = 0xFFFF };
+
+                  /**
+                   *  Canonical name of the character set.
+                   */
+                  const char* name;
+                  /**
+                   *  Lower case names recognized for the character set,
+                   *  terminated by a null pointer.
+                   */
+                  const char* const* aliases;
+                  /**
+                   *  Unicode code points of bytes 0x80 to 0xFF,
+                   *  UNDEFINED if the byte is not assigned.
+                   */
+                  unsigned short upper[128];
+
+                  /**
+                   *  Finds the table for a character set.
+                   *  @param charset character set name, case is ignored.
+                   *  @return table or null if the character set is not
+                   *  a supported single byte character set.
+                   */
+                  static const SingleByteCharset* forName(const LogString& charset);
+          };
+
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#endif //_LOG4CXX_HELPERS_SINGLEBYTECHARSET_H
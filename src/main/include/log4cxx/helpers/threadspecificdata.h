@@ -20,10 +20,18 @@
 
 #include <log4cxx/ndc.h>
 #include <log4cxx/mdc.h>
+#include <log4cxx/helpers/mdcmap.h>
+#include <log4cxx/helpers/ndcnode.h>
+#include <vector>
 
 
 namespace log4cxx
 {
+        class Layout;
+        namespace spi {
+            class LoggingEvent;
+        }
+
         namespace helpers
         {
                 /**
@@ -47,18 +55,86 @@ namespace log4cxx
                         void recycle();
                         
                         static void put(const LogString& key, const LogString& val);
+                        static void put(int key, const LogString& val);
                         static void push(const LogString& val);
                         static void inherit(const log4cxx::NDC::Stack& stack);
+
+                        /**
+                         *  Replaces the MDC and NDC of the current thread.
+                         *  @param mdc shared MDC, copied before modification,
+                         *  null for an empty MDC.
+                         *  @param ndc innermost NDC frame, may be null.
+                         */
+                        static void install(const MDCMap* mdc, const NDCNode* ndc);
                         
-                        log4cxx::NDC::Stack& getStack();
-                        log4cxx::MDC::Map& getMap();
-                        
+                        /**
+                         *  Gets the innermost NDC frame.
+                         *  @return frame or null if the NDC is empty,
+                         *  no reference is added.
+                         */
+                        inline const NDCNode* getNDC() const {
+                            return ndcTop;
+                        }
+
+                        /**
+                         *  Replaces the innermost NDC frame.
+                         *  @param node new frame, may be null.
+                         */
+                        void setNDC(const NDCNode* node);
+
+                        /**
+                         *  Removes the innermost NDC frame.
+                         */
+                        void popNDC();
+
+                        /**
+                         *  Replaces the MDC.
+                         *  @param map shared MDC, copied before modification,
+                         *  null for an empty MDC.
+                         */
+                        void setMDCMap(const MDCMap* map);
+
+                        /**
+                         *  Gets the MDC for reading.
+                         */
+                        const MDCMap& getMDCMap() const;
+
+                        /**
+                         *  Gets the MDC for modification, the map is copied
+                         *  first if it is shared with a snapshot.
+                         */
+                        MDCMap& getWritableMDCMap();
+
+                        /**
+                         *  Gets the current MDC as an immutable snapshot.
+                         *  @return snapshot, the caller must call releaseRef.
+                         */
+                        const MDCMap* getMDCSnapshot();
+
+                        /**
+                         *  Gets the innermost NDC frame for a logging event.
+                         *  @return frame or null if the NDC is empty,
+                         *  the caller must call releaseRef.
+                         */
+                        const NDCNode* getNDCSnapshot();
 
                 private:
+                        friend class FormatBuffer;
+                        friend class EncodeBuffer;
+                        ThreadSpecificData(const ThreadSpecificData&);
+                        ThreadSpecificData& operator=(const ThreadSpecificData&);
                         static ThreadSpecificData& getDataNoThreads();
                         static ThreadSpecificData* createCurrentData();
-                        log4cxx::NDC::Stack ndcStack;
-                        log4cxx::MDC::Map mdcMap;
+                        void setFormatted(const spi::LoggingEvent* event,
+                                          const Layout* layout);
+                        const NDCNode* ndcTop;
+                        MDCMap* mdcMap;
+                        LogString formatBuffer;
+                        bool formatBufferInUse;
+                        const spi::LoggingEvent* formattedEvent;
+                        const Layout* formattedLayout;
+                        std::vector<char> encodeBuffer;
+                        bool encodeBufferInUse;
                 };
 
         }  // namespace helpers
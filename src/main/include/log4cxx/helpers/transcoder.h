@@ -104,6 +104,43 @@ namespace log4cxx {
         */
       static char* encode(const LogString& src, log4cxx::helpers::Pool& p);
 
+      /**
+       *    Counts the ASCII characters (below 0x80)
+       *       at the start of an array of bytes.
+       *    @param src bytes.
+       *    @param length number of bytes.
+       *    @return number of leading bytes below 0x80.
+       */
+      static size_t asciiLength(const char* src, size_t length);
+#if !LOG4CXX_LOGCHAR_IS_UTF8
+      /**
+       *    Counts the ASCII characters (below 0x80)
+       *       at the start of an array of logchar.
+       *    @param src characters.
+       *    @param length number of characters.
+       *    @return number of leading characters below 0x80.
+       */
+      static size_t asciiLength(const logchar* src, size_t length);
+#endif
+      /**
+       *    Appends bytes to a LogString as the characters with
+       *       the same values, which is correct for ASCII and,
+       *       when logchar is wider than char, for ISO-8859-1.
+       *    @param src bytes.
+       *    @param length number of bytes.
+       *    @param dst destination.
+       */
+      static void widen(const char* src, size_t length, LogString& dst);
+      /**
+       *    Stores each character as a byte with the same value,
+       *       all characters must be below 0x80, or below 0x100
+       *       when logchar is wider than char.
+       *    @param src characters.
+       *    @param length number of characters.
+       *    @param dst destination of length bytes.
+       */
+      static void narrow(const logchar* src, size_t length, char* dst);
+
 
 
 #if LOG4CXX_WCHAR_T_API || LOG4CXX_LOGCHAR_IS_WCHAR_T || defined(WIN32) || defined(_WIN32)
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_HELPERS_URING_FILE_OUTPUT_STREAM_H
+#define _LOG4CXX_HELPERS_URING_FILE_OUTPUT_STREAM_H
+
+#if defined(_MSC_VER)
+#pragma warning ( push )
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/file.h>
+#include <vector>
+
+
+namespace log4cxx
+{
+
+        namespace helpers {
+
+          /**
+          *   OutputStream that writes a file asynchronously through io_uring.
+          *
+          *   <p>Bytes are copied into one of BUFFER_COUNT buffers registered
+          *   with the kernel.  A buffer is submitted as a write at its file
+          *   offset when it is full or when the stream is flushed, and the
+          *   caller continues without waiting for the write to complete.
+          *   Completions are reaped on later calls; a write only blocks when
+          *   the next buffer is still being written.  A write error is
+          *   reported by the call following its completion.  close waits
+          *   for all writes.  Calls must be serialized by the caller.
+          */
+          class LOG4CXX_EXPORT UringFileOutputStream : public OutputStream
+          {
+          public:
+                  enum { BUFFER_COUNT = 8, QUEUE_DEPTH = 32 };
+
+                  DECLARE_ABSTRACT_LOG4CXX_OBJECT(UringFileOutputStream)
+                  BEGIN_LOG4CXX_CAST_MAP()
+                          LOG4CXX_CAST_ENTRY(UringFileOutputStream)
+                          LOG4CXX_CAST_ENTRY_CHAIN(OutputStream)
+                  END_LOG4CXX_CAST_MAP()
+
+                  /**
+                   *  Sets up the ring and opens the file.
+                   *  @param filename file name.
+                   *  @param append true to append to an existing file.
+                   *  @param bufferSize size of each registered buffer.
+                   *  @throws IOException if io_uring is not available
+                   *  or the file could not be opened.
+                   */
+                  UringFileOutputStream(const LogString& filename, bool append,
+                      size_t bufferSize);
+                  virtual ~UringFileOutputStream();
+
+                  virtual void close(Pool& p);
+                  virtual void flush(Pool& p);
+                  virtual void write(ByteBuffer& buf, Pool& p);
+
+                  /**
+                   *  Determines if log4cxx was built with io_uring support,
+                   *  the running kernel may still not provide it.
+                   */
+                  static bool isSupported();
+
+          private:
+                  UringFileOutputStream(const UringFileOutputStream&);
+                  UringFileOutputStream& operator=(const UringFileOutputStream&);
+
+                  /**
+                   *  Write in flight.
+                   */
+                  struct Request {
+                      int buffer;
+                      size_t position;
+                      size_t length;
+                      log4cxx_int64_t offset;
+                  };
+
+                  void submit();
+                  void submit(Request& request);
+                  void reap(bool wait);
+                  void complete(Request& request, int result);
+                  void checkError();
+
+                  Pool pool;
+                  apr_file_t* fileptr;
+                  int fd;
+                  /**
+                   *  struct io_uring, kept opaque so the header
+                   *  does not depend on liburing.
+                   */
+                  void* ring;
+                  /**
+                   *  Were the buffers registered with the kernel?
+                   */
+                  bool registered;
+                  size_t bufferSize;
+                  std::vector<char> buffers;
+                  /**
+                   *  Requests in flight for each buffer.
+                   */
+                  int writes[BUFFER_COUNT];
+                  /**
+                   *  Buffer being filled.
+                   */
+                  int current;
+                  size_t filled;
+                  size_t submitted;
+                  /**
+                   *  File offset of the next submitted byte.
+                   */
+                  log4cxx_int64_t offset;
+                  Request requests[QUEUE_DEPTH];
+                  std::vector<Request*> freeRequests;
+                  log4cxx_status_t error;
+          };
+
+          LOG4CXX_PTR_DEF(UringFileOutputStream);
+        } // namespace helpers
+
+}  //namespace log4cxx
+
+#if defined(_MSC_VER)
+#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXX_HELPERS_URING_FILE_OUTPUT_STREAM_H
@@ -75,6 +75,8 @@ namespace log4cxx
             int thresholdInt;
             LevelPtr threshold;
 
+            helpers::ClockPtr clock;
+
             bool emittedNoAppenderWarning;
             bool emittedNoResourceBundleWarning;
 
@@ -141,6 +143,16 @@ namespace log4cxx
             */
             const LevelPtr& getThreshold() const;
 
+            /**
+            Set the clock used to time stamp logging events.
+            */
+            void setClock(const helpers::ClockPtr& clock);
+
+            /**
+            Get the clock used to time stamp logging events.
+            */
+            const helpers::ClockPtr& getClock() const;
+
             /**
             Return a new logger instance named as the first parameter using
             the default factory.
@@ -86,6 +86,15 @@ namespace log4cxx
                 xml::XMLLayout XMLLayout} returns <code>false</code>.
                 */
                 virtual bool ignoresThrowable() const = 0;
+
+                /**
+                Returns <code>true</code> if this layout formats every event
+                exactly like the other layout, so output already formatted by
+                one can be written by an appender using the other.  A layout
+                that returns <code>true</code> when passed itself allows its
+                output to be reused.  The base class returns <code>false</code>.
+                */
+                virtual bool isEquivalent(const Layout& other) const;
         };
         LOG4CXX_PTR_DEF(Layout);
 }
@@ -28,6 +28,8 @@
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/helpers/mutex.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/spi/field.h>
+#include <log4cxx/spi/messagesupplier.h>
 #include <log4cxx/helpers/resourcebundle.h>
 #include <log4cxx/helpers/messagebuffer.h>
 
@@ -524,6 +526,28 @@ namespace log4cxx
         @param message message.
         */
         void forcedLog(const LevelPtr& level, const std::string& message) const;
+        /**
+        This method creates a new logging event with typed fields
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param fields fields of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::string& message,
+                        const log4cxx::spi::FieldList& fields,
+                        const log4cxx::spi::LocationInfo& location) const;
+        /**
+        This method creates a new logging event with one typed field
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param field field of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::string& message,
+                        const log4cxx::spi::Field& field,
+                        const log4cxx::spi::LocationInfo& location) const;
 
 #if LOG4CXX_WCHAR_T_API
         /**
@@ -542,6 +566,28 @@ namespace log4cxx
         @param message message.
         */
         void forcedLog(const LevelPtr& level, const std::wstring& message) const;
+        /**
+        This method creates a new logging event with typed fields
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param fields fields of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::wstring& message,
+                        const log4cxx::spi::FieldList& fields,
+                        const log4cxx::spi::LocationInfo& location) const;
+        /**
+        This method creates a new logging event with one typed field
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param field field of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::wstring& message,
+                        const log4cxx::spi::Field& field,
+                        const log4cxx::spi::LocationInfo& location) const;
 #endif
 #if LOG4CXX_UNICHAR_API || LOG4CXX_CFSTRING_API
         /**
@@ -560,6 +606,28 @@ namespace log4cxx
         @param message message.
         */
         void forcedLog(const LevelPtr& level, const std::basic_string<UniChar>& message) const;
+        /**
+        This method creates a new logging event with typed fields
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param fields fields of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::basic_string<UniChar>& message,
+                        const log4cxx::spi::FieldList& fields,
+                        const log4cxx::spi::LocationInfo& location) const;
+        /**
+        This method creates a new logging event with one typed field
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message message.
+        @param field field of the event.
+        @param location location of source of logging request.
+        */
+        void forcedLog(const LevelPtr& level, const std::basic_string<UniChar>& message,
+                        const log4cxx::spi::Field& field,
+                        const log4cxx::spi::LocationInfo& location) const;
 #endif
 #if LOG4CXX_CFSTRING_API
         /**
@@ -588,6 +656,71 @@ namespace log4cxx
         */
         void forcedLogLS(const LevelPtr& level, const LogString& message,
                         const log4cxx::spi::LocationInfo& location) const;
+        /**
+        This method creates a new logging event with typed fields
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message the message string to log.
+        @param fields fields of the event.
+        @param location location of the logging statement.
+        */
+        void forcedLogLS(const LevelPtr& level, const LogString& message,
+                        const log4cxx::spi::FieldList& fields,
+                        const log4cxx::spi::LocationInfo& location) const;
+        /**
+        This method creates a new logging event with one typed field
+        and logs the event without further checks.
+        @param level the level to log.
+        @param message the message string to log.
+        @param field field of the event.
+        @param location location of the logging statement.
+        */
+        void forcedLogLS(const LevelPtr& level, const LogString& message,
+                        const log4cxx::spi::Field& field,
+                        const log4cxx::spi::LocationInfo& location) const;
+
+        /**
+        This method creates a new logging event whose message is only
+        produced if an appender formats the event, and logs the event
+        without further checks.
+        @param level the level to log.
+        @param supplier supplier of the message.
+        @param location location of the logging statement.
+        */
+        void forcedLog(const LevelPtr& level,
+                        const log4cxx::spi::MessageSupplierPtr& supplier,
+                        const log4cxx::spi::LocationInfo& location) const;
+
+        /**
+        This method creates a new logging event whose message is only
+        produced if an appender formats the event, and logs the event
+        without further checks.
+        @param level the level to log.
+        @param supplier function or function object with the signature
+        <code>std::string supplier()</code>.
+        @param location location of the logging statement.
+        */
+        template<class F>
+        void forcedLogLazy(const LevelPtr& level, const F& supplier,
+                        const log4cxx::spi::LocationInfo& location) const {
+            log4cxx::spi::MessageSupplierPtr wrapper(
+                new log4cxx::spi::FunctorMessageSupplier<F>(supplier));
+            forcedLog(level, wrapper, location);
+        }
+
+        /**
+        This method creates a new logging event whose message is only
+        produced if an appender formats the event, and logs the event
+        without further checks.
+        @param level the level to log.
+        @param supplier supplier of the message.
+        @param location location of the logging statement.
+        */
+        void forcedLogLazy(const LevelPtr& level,
+                        const log4cxx::spi::MessageSupplierPtr& supplier,
+                        const log4cxx::spi::LocationInfo& location) const {
+            forcedLog(level, supplier, location);
+        }
 
         /**
         Get the additivity flag for this Logger instance.
@@ -1755,8 +1888,9 @@ Logs a message to a specified logger with a specified level.
 */
 #define LOG4CXX_LOG(logger, level, message) { \
         if (logger->isEnabledFor(level)) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXX_LOCATION); } }
+           logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); } }
 
 /**
 Logs a message to a specified logger with a specified level.
@@ -1767,8 +1901,40 @@ Logs a message to a specified logger with a specified level.
 */
 #define LOG4CXX_LOGLS(logger, level, message) { \
         if (logger->isEnabledFor(level)) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::LogCharMessageBuffer oss_; \
-           logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXX_LOCATION); } }
+           logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); } }
+
+/**
+Logs a message with a typed field to a specified logger with a specified level.
+The value is kept in its own type, see log4cxx::spi::Field, and is only
+converted to text if a layout renders it.
+
+@param logger the logger to be used.
+@param level the level to log.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_LOG_KV(logger, level, message, key, value) { \
+        if (logger->isEnabledFor(level)) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(level, oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); } }
+
+/**
+Logs a message produced on demand to a specified logger with a specified level.
+The supplier is only called if an appender formats the event.
+
+@param logger the logger to be used.
+@param level the level to log.
+@param supplier function or function object with the signature
+<code>std::string supplier()</code>, or a log4cxx::spi::MessageSupplierPtr.
+*/
+#define LOG4CXX_LOG_LAZY(logger, level, supplier) { \
+        if (logger->isEnabledFor(level)) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           logger->forcedLogLazy(level, supplier, LOG4CXX_CALL_SITE_LOCATION); } }
 
 #if !defined(LOG4CXX_THRESHOLD) || LOG4CXX_THRESHOLD <= 10000 
 /**
@@ -1779,10 +1945,40 @@ Logs a message to a specified logger with the DEBUG level.
 */
 #define LOG4CXX_DEBUG(logger, message) { \
         if (LOG4CXX_UNLIKELY(logger->isDebugEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getDebug(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the DEBUG level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_DEBUG_KV(logger, message, key, value) { \
+        if (LOG4CXX_UNLIKELY(logger->isDebugEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getDebug(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getDebug(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message produced on demand to a specified logger with the DEBUG level.
+The supplier is only called if an appender formats the event.
+
+@param logger the logger to be used.
+@param supplier function or function object with the signature
+<code>std::string supplier()</code>, or a log4cxx::spi::MessageSupplierPtr.
+*/
+#define LOG4CXX_DEBUG_LAZY(logger, supplier) { \
+        if (LOG4CXX_UNLIKELY(logger->isDebugEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           logger->forcedLogLazy(::log4cxx::Level::getDebug(), supplier, LOG4CXX_CALL_SITE_LOCATION); }}
 #else
 #define LOG4CXX_DEBUG(logger, message)
+#define LOG4CXX_DEBUG_KV(logger, message, key, value)
+#define LOG4CXX_DEBUG_LAZY(logger, supplier)
 #endif
 
 #if !defined(LOG4CXX_THRESHOLD) || LOG4CXX_THRESHOLD <= 5000 
@@ -1794,10 +1990,40 @@ Logs a message to a specified logger with the TRACE level.
 */
 #define LOG4CXX_TRACE(logger, message) { \
         if (LOG4CXX_UNLIKELY(logger->isTraceEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getTrace(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getTrace(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the TRACE level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_TRACE_KV(logger, message, key, value) { \
+        if (LOG4CXX_UNLIKELY(logger->isTraceEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getTrace(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message produced on demand to a specified logger with the TRACE level.
+The supplier is only called if an appender formats the event.
+
+@param logger the logger to be used.
+@param supplier function or function object with the signature
+<code>std::string supplier()</code>, or a log4cxx::spi::MessageSupplierPtr.
+*/
+#define LOG4CXX_TRACE_LAZY(logger, supplier) { \
+        if (LOG4CXX_UNLIKELY(logger->isTraceEnabled())) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           logger->forcedLogLazy(::log4cxx::Level::getTrace(), supplier, LOG4CXX_CALL_SITE_LOCATION); }}
 #else
 #define LOG4CXX_TRACE(logger, message)
+#define LOG4CXX_TRACE_KV(logger, message, key, value)
+#define LOG4CXX_TRACE_LAZY(logger, supplier)
 #endif
 
 #if !defined(LOG4CXX_THRESHOLD) || LOG4CXX_THRESHOLD <= 20000 
@@ -1809,10 +2035,26 @@ Logs a message to a specified logger with the INFO level.
 */
 #define LOG4CXX_INFO(logger, message) { \
         if (logger->isInfoEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getInfo(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getInfo(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the INFO level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_INFO_KV(logger, message, key, value) { \
+        if (logger->isInfoEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getInfo(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
 #else
 #define LOG4CXX_INFO(logger, message)
+#define LOG4CXX_INFO_KV(logger, message, key, value)
 #endif
 
 #if !defined(LOG4CXX_THRESHOLD) || LOG4CXX_THRESHOLD <= 30000 
@@ -1824,10 +2066,26 @@ Logs a message to a specified logger with the WARN level.
 */
 #define LOG4CXX_WARN(logger, message) { \
         if (logger->isWarnEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getWarn(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getWarn(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the WARN level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_WARN_KV(logger, message, key, value) { \
+        if (logger->isWarnEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getWarn(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
 #else
 #define LOG4CXX_WARN(logger, message)
+#define LOG4CXX_WARN_KV(logger, message, key, value)
 #endif
 
 #if !defined(LOG4CXX_THRESHOLD) || LOG4CXX_THRESHOLD <= 40000 
@@ -1839,8 +2097,23 @@ Logs a message to a specified logger with the ERROR level.
 */
 #define LOG4CXX_ERROR(logger, message) { \
         if (logger->isErrorEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getError(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the ERROR level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_ERROR_KV(logger, message, key, value) { \
+        if (logger->isErrorEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getError(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getError(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
 
 /**
 Logs a error if the condition is not true.
@@ -1851,11 +2124,13 @@ Logs a error if the condition is not true.
 */
 #define LOG4CXX_ASSERT(logger, condition, message) { \
         if (!(condition) && logger->isErrorEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getError(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getError(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
 
 #else
 #define LOG4CXX_ERROR(logger, message)
+#define LOG4CXX_ERROR_KV(logger, message, key, value)
 #define LOG4CXX_ASSERT(logger, condition, message)
 #endif
 
@@ -1868,10 +2143,26 @@ Logs a message to a specified logger with the FATAL level.
 */
 #define LOG4CXX_FATAL(logger, message) { \
         if (logger->isFatalEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
+           ::log4cxx::helpers::MessageBuffer oss_; \
+           logger->forcedLog(::log4cxx::Level::getFatal(), oss_.str(oss_ << message), LOG4CXX_CALL_SITE_LOCATION); }}
+
+/**
+Logs a message with a typed field to a specified logger with the FATAL level.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param key name of the field.
+@param value value of the field.
+*/
+#define LOG4CXX_FATAL_KV(logger, message, key, value) { \
+        if (logger->isFatalEnabled()) {\
+           LOG4CXX_DECLARE_CALL_SITE; \
            ::log4cxx::helpers::MessageBuffer oss_; \
-           logger->forcedLog(::log4cxx::Level::getFatal(), oss_.str(oss_ << message), LOG4CXX_LOCATION); }}
+           logger->forcedLog(::log4cxx::Level::getFatal(), oss_.str(oss_ << message), ::log4cxx::spi::Field(key, value), LOG4CXX_CALL_SITE_LOCATION); }}
 #else
 #define LOG4CXX_FATAL(logger, message)
+#define LOG4CXX_FATAL_KV(logger, message, key, value)
 #endif           
 
 /**
@@ -1883,7 +2174,8 @@ Logs a localized message with no parameter.
 */
 #define LOG4CXX_L7DLOG(logger, level, key) { \
         if (logger->isEnabledFor(level)) {\
-        logger->l7dlog(level, key, LOG4CXX_LOCATION); }}
+        LOG4CXX_DECLARE_CALL_SITE; \
+        logger->l7dlog(level, key, LOG4CXX_CALL_SITE_LOCATION); }}
 
 /**
 Logs a localized message with one parameter.
@@ -1895,7 +2187,8 @@ Logs a localized message with one parameter.
 */
 #define LOG4CXX_L7DLOG1(logger, level, key, p1) { \
         if (logger->isEnabledFor(level)) {\
-        logger->l7dlog(level, key, LOG4CXX_LOCATION, p1); }}
+        LOG4CXX_DECLARE_CALL_SITE; \
+        logger->l7dlog(level, key, LOG4CXX_CALL_SITE_LOCATION, p1); }}
 
 /**
 Logs a localized message with two parameters.
@@ -1908,7 +2201,8 @@ Logs a localized message with two parameters.
 */
 #define LOG4CXX_L7DLOG2(logger, level, key, p1, p2) { \
         if (logger->isEnabledFor(level)) {\
-        logger->l7dlog(level, key, LOG4CXX_LOCATION, p1, p2); }}
+        LOG4CXX_DECLARE_CALL_SITE; \
+        logger->l7dlog(level, key, LOG4CXX_CALL_SITE_LOCATION, p1, p2); }}
 
 /**
 Logs a localized message with three parameters.
@@ -1922,7 +2216,8 @@ Logs a localized message with three parameters.
 */
 #define LOG4CXX_L7DLOG3(logger, level, key, p1, p2, p3) { \
         if (logger->isEnabledFor(level)) {\
-        logger->l7dlog(level, key, LOG4CXX_LOCATION, p1, p2, p3); }}
+        LOG4CXX_DECLARE_CALL_SITE; \
+        logger->l7dlog(level, key, LOG4CXX_CALL_SITE_LOCATION, p1, p2, p3); }}
 
 /**@}*/
 
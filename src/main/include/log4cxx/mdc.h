@@ -41,6 +41,9 @@ namespace log4cxx
         child thread automatically inherits a <em>copy</em> of the mapped
         diagnostic context of its parent.
 
+        <p>Keys are interned in a process wide table when first used
+        and are never released, so keys should be drawn from a bounded
+        set rather than built from request or user data.
         */
         class LOG4CXX_EXPORT MDC
         {
@@ -225,6 +228,37 @@ namespace log4cxx
                 */
                 static void clear();
 
+                /**
+                * Gets the handle of a key, adding the key to the process wide
+                * table of interned keys if necessary.
+                *  @param key key.
+                *  @return key handle.
+                */
+                static int getKey(const LogString& key);
+
+                /**
+                * Gets the handle of a key without interning it.
+                *  @param key key.
+                *  @param handle receives the key handle.
+                *  @return true if the key has been interned.
+                */
+                static bool findKey(const LogString& key, int& handle);
+
+                /**
+                * Gets the name of an interned key.
+                *  @param handle key handle returned by getKey.
+                *  @return key name.
+                */
+                static const LogString& getKeyName(int handle);
+
+                /**
+                 *  Gets the context identified by an interned key.
+                 *  @param handle key handle returned by getKey.
+                 *  @param dest destination to which value is appended.
+                 *  @return true if key has associated value.
+                 */
+                static bool get(int handle, LogString& dest);
+
         private:
                 MDC(const MDC&);
                 MDC& operator=(const MDC&);
@@ -340,8 +340,8 @@ namespace log4cxx
         private:
                 NDC(const NDC&);
                 NDC& operator=(const NDC&);
-                static LogString& getMessage(DiagnosticContext& ctx);
-                static LogString& getFullMessage(DiagnosticContext& ctx);
+                static const LogString& getMessage(const DiagnosticContext& ctx);
+                static const LogString& getFullMessage(const DiagnosticContext& ctx);
         }; // class NDC;
 }  // namespace log4cxx
 
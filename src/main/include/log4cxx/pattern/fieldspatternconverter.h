@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_PATTERN_FIELDS_PATTERN_CONVERTER
+#define _LOG4CXX_PATTERN_FIELDS_PATTERN_CONVERTER
+
+#include <log4cxx/pattern/loggingeventpatternconverter.h>
+
+namespace log4cxx { namespace pattern {
+
+
+/**
+ * Formats the typed fields of the event, see log4cxx::spi::Field.
+ * Without an option all fields are output as space separated
+ * key=value pairs, with an option only the value of the named field.
+ * Values are converted to text only when formatted.
+ */
+class LOG4CXX_EXPORT FieldsPatternConverter
+  : public LoggingEventPatternConverter {
+  /**
+   * Name of field to output.
+   */
+  const LogString option;
+
+  /**
+   * Private constructor.
+   * @param name name of converter.
+   * @param option name of field, may be empty.
+   */
+  FieldsPatternConverter(const LogString& name, const LogString& option);
+
+  public:
+  DECLARE_LOG4CXX_PATTERN(FieldsPatternConverter)
+  BEGIN_LOG4CXX_CAST_MAP()
+       LOG4CXX_CAST_ENTRY(FieldsPatternConverter)
+       LOG4CXX_CAST_ENTRY_CHAIN(LoggingEventPatternConverter)
+  END_LOG4CXX_CAST_MAP()
+
+  /**
+   * Obtains an instance of FieldsPatternConverter.
+   * @param options options, may be null or first element contains name of field to format.
+   * @return instance of FieldsPatternConverter.
+   */
+  static PatternConverterPtr newInstance(
+    const std::vector<LogString>& options);
+
+  using LoggingEventPatternConverter::format;
+
+  void format(const log4cxx::spi::LoggingEventPtr& event,
+     LogString& toAppendTo,
+     log4cxx::helpers::Pool& p) const;
+};
+}
+}
+#endif
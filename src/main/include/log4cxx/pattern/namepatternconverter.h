@@ -20,7 +20,10 @@
 
 #include <log4cxx/pattern/loggingeventpatternconverter.h>
 #include <log4cxx/pattern/nameabbreviator.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/mutex.h>
 
+#include <map>
 #include <vector>
 
 namespace log4cxx {
@@ -37,6 +40,30 @@ class LOG4CXX_EXPORT NamePatternConverter : public LoggingEventPatternConverter
    */
   const NameAbbreviatorPtr abbreviator;
 
+  /**
+   * True if the abbreviator changes names and results are worth caching.
+   */
+  const bool cacheAbbreviations;
+
+  typedef std::map<LogString, LogString> AbbreviationMap;
+
+  /**
+   * Abbreviated names seen so far.  The map is never modified once
+   * published, an insertion under mutex publishes an extended copy
+   * with an atomic exchange, and lookups read the pointer with an
+   * atomic operation, so they do not need to lock.
+   */
+  mutable const AbbreviationMap* volatile abbreviations;
+
+  /**
+   * Superseded maps, released on destruction since other threads
+   * may still be reading them.
+   */
+  mutable std::vector<const AbbreviationMap*> retired;
+
+  log4cxx::helpers::Pool pool;
+  log4cxx::helpers::Mutex mutex;
+
 public:
 DECLARE_LOG4CXX_PATTERN(NamePatternConverter)
 BEGIN_LOG4CXX_CAST_MAP()
@@ -57,6 +84,8 @@ protected:
     const LogString& style,
     const std::vector<LogString>& options);
 
+  ~NamePatternConverter();
+
   /**
    * Abbreviate name in string buffer.
    * @param nameStart starting position of name to abbreviate.
@@ -64,8 +93,21 @@ protected:
    */
   void abbreviate(int nameStart, LogString& buf) const;
 
+  /**
+   * Append abbreviated name to string buffer, reusing the result
+   * computed for an earlier occurrence of the same name.
+   * @param name name to abbreviate.
+   * @param toAppendTo string buffer to which the abbreviation is appended.
+   */
+  void appendAbbreviated(const LogString& name, LogString& toAppendTo) const;
+
 private:
    NameAbbreviatorPtr getAbbreviator(const std::vector<LogString>& options);
+
+   /**
+    * Limit on the number of cached names, names beyond it are abbreviated on every use.
+    */
+   enum { MAX_ABBREVIATIONS = 128 };
 };
 
   }
@@ -40,6 +40,11 @@ class LOG4CXX_EXPORT PropertiesPatternConverter
    */
   const LogString option;
 
+  /**
+   * Interned handle of the property name, see MDC::getKey.
+   */
+  const int key;
+
   /**
    * Private constructor.
    * @param options options, may be null.
@@ -24,7 +24,8 @@ namespace log4cxx { namespace pattern {
 
 
 /**
- * Format the relative time in milliseconds.
+ * Format the relative time in milliseconds, or in microseconds
+ * or nanoseconds with the "us" or "ns" option, for example %r{ns}.
  *
  * 
  * 
@@ -42,9 +43,15 @@ END_LOG4CXX_CAST_MAP()
    */
   RelativeTimePatternConverter();
 
+  /**
+   * Constructor.
+   * @param nanosPerUnit nanoseconds in the displayed unit.
+   */
+  RelativeTimePatternConverter(int nanosPerUnit);
+
   /**
    * Obtains an instance of RelativeTimePatternConverter.
-   * @param options options, currently ignored, may be null.
+   * @param options options, "ms", "us" or "ns", may be empty.
    * @return instance of RelativeTimePatternConverter.
    */
   static PatternConverterPtr newInstance(
@@ -56,6 +63,9 @@ END_LOG4CXX_CAST_MAP()
   void format(const log4cxx::spi::LoggingEventPtr& event,
       LogString& toAppendTo,
       log4cxx::helpers::Pool& p) const;
+
+private:
+  const int nanosPerUnit;
 };
 }
 }
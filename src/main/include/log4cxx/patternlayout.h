@@ -124,6 +124,16 @@ namespace log4cxx
 
         </tr>
 
+        <tr>
+        <td align=center><b>K</b></td>
+
+        <td>Used to output the typed fields of the logging event, see
+        LOG4CXX_INFO_KV.  Without an option all fields are output as
+        space separated key=value pairs, <b>\%K{latency_us}</b> outputs
+        only the value of the named field.
+        </td>
+        </tr>
+
         <tr>
         <td align=center><b>l</b></td>
 
@@ -395,6 +405,12 @@ namespace log4cxx
                 virtual void format(LogString& output,
                      const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& pool) const;
 
+                /**
+                Returns <code>true</code> if the other layout is of the same class
+                and has the same conversion pattern.
+                */
+                virtual bool isEquivalent(const Layout& other) const;
+
         protected:
                 virtual log4cxx::pattern::PatternMap getFormatSpecifiers();
         };
@@ -90,6 +90,11 @@ namespace log4cxx {
         */
         virtual void subAppend(const spi::LoggingEventPtr& event, log4cxx::helpers::Pool& p);
 
+        /**
+         Events that trigger a rollover take the locked path.
+        */
+        virtual bool canAppendConcurrently(const spi::LoggingEventPtr& event);
+
         protected:
 
           RollingPolicyPtr getRollingPolicy() const;
@@ -25,6 +25,7 @@
 
 
 #include <log4cxx/layout.h>
+#include <typeinfo>
 
 namespace log4cxx
 {
@@ -68,6 +69,14 @@ namespace log4cxx
                 */
                 bool ignoresThrowable() const { return true; }
 
+                /**
+                Returns <code>true</code> if the other layout is of the same
+                type.  The dynamic type is compared since subclasses that
+                do not declare their own class share this class.
+                */
+                bool isEquivalent(const Layout& other) const
+                        { return typeid(other) == typeid(*this); }
+
                 virtual void activateOptions(log4cxx::helpers::Pool& /* p */) {}
                 virtual void setOption(const LogString& /* option */,
                      const LogString& /* value */) {}
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_SPI_FIELD_H
+#define _LOG4CXX_SPI_FIELD_H
+
+#if defined(_MSC_VER)
+#pragma warning (push)
+#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxx/logstring.h>
+#include <string>
+#include <vector>
+
+namespace log4cxx
+{
+        namespace spi
+        {
+                /**
+                A typed key/value pair carried by a logging event.
+
+                <p>Numeric and boolean values are stored as they are given
+                and only converted to text when a layout renders them, so a
+                field costs no formatting when the event is filtered out or
+                written to a sink that keeps the type.
+
+                <p>Integers wider than 64 bits are not supported, unsigned
+                values above the largest signed 64 bit value wrap.
+                */
+                class LOG4CXX_EXPORT Field
+                {
+                public:
+                        enum Type { INT64, DOUBLE, BOOLEAN, STRING, BYTES };
+
+                        Field(const std::string& key, int value);
+                        Field(const std::string& key, unsigned int value);
+                        Field(const std::string& key, long value);
+                        Field(const std::string& key, unsigned long value);
+                        Field(const std::string& key, log4cxx_int64_t value);
+                        Field(const std::string& key, unsigned long long value);
+                        Field(const std::string& key, double value);
+                        Field(const std::string& key, bool value);
+                        Field(const std::string& key, const char* value);
+                        Field(const std::string& key, const std::string& value);
+#if LOG4CXX_WCHAR_T_API
+                        Field(const std::string& key, const std::wstring& value);
+#endif
+                        /**
+                         *  Creates a field with an opaque byte sequence.
+                         *  @param key key.
+                         *  @param data bytes, copied.
+                         *  @param length number of bytes.
+                         */
+                        static Field bytes(const std::string& key,
+                                const void* data, size_t length);
+
+                        inline const LogString& getKey() const {
+                                return key;
+                        }
+
+                        inline Type getType() const {
+                                return type;
+                        }
+
+                        inline log4cxx_int64_t getInt64() const {
+                                return value.int64;
+                        }
+
+                        inline double getDouble() const {
+                                return value.dbl;
+                        }
+
+                        inline bool getBoolean() const {
+                                return value.boolean;
+                        }
+
+                        /**
+                         *  Gets the value of a STRING field.
+                         */
+                        inline const LogString& getString() const {
+                                return text;
+                        }
+
+                        /**
+                         *  Gets the value of a BYTES field.
+                         */
+                        inline const std::string& getBytes() const {
+                                return data;
+                        }
+
+                        /**
+                         *  Appends the value as text, bytes are written
+                         *  as lower case hexadecimal digits.
+                         *  @param dest destination.
+                         */
+                        void format(LogString& dest) const;
+
+                        /**
+                         *  Gets the name of the type as used by XMLLayout.
+                         */
+                        const logchar* getTypeName() const;
+
+                private:
+                        Field(const std::string& key, Type type);
+                        LogString key;
+                        Type type;
+                        union {
+                            log4cxx_int64_t int64;
+                            double dbl;
+                            bool boolean;
+                        } value;
+                        LogString text;
+                        std::string data;
+                };
+
+                LOG4CXX_LIST_DEF(FieldList, Field);
+        }
+}
+
+#if defined(_MSC_VER)
+#pragma warning (pop)
+#endif
+
+#endif //_LOG4CXX_SPI_FIELD_H
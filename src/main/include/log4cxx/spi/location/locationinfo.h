@@ -19,6 +19,7 @@
 #define _LOG4CXX_SPI_LOCATION_LOCATIONINFO_H
 
 #include <log4cxx/log4cxx.h>
+#include <log4cxx/logstring.h>
 #include <string>
 #include <log4cxx/helpers/objectoutputstream.h>
 
@@ -45,6 +46,45 @@ namespace log4cxx
 
         static const LocationInfo& getLocationUnavailable();
 
+       /**
+        *   Location of a single logging statement with its class,
+        *   method and file names parsed and decoded once.
+        *   @remarks Declared by the logging macros as a static per call
+        *       site, see LOG4CXX_DECLARE_CALL_SITE, so that location-aware
+        *       layouts do not repeat the work for every event.  The parsed names are allocated once and
+        *       intentionally never freed, and a CallSite holds only
+        *       pointers, so it has no destructor to run at exit and
+        *       locations taken from it stay valid while static objects
+        *       are destroyed.
+        */
+        class LOG4CXX_EXPORT CallSite
+        {
+        public:
+            CallSite( const char * const fileName,
+                      const char * const functionName,
+                      int lineNumber);
+
+            /**
+             *  Names parsed from the call site.
+             */
+            struct Names {
+                std::string className;
+                std::string methodName;
+                LogString decodedClassName;
+                LogString decodedMethodName;
+                LogString decodedFileName;
+            };
+
+            const char * const fileName;
+            const char * const functionName;
+            const int lineNumber;
+            const Names * const names;
+
+        private:
+            CallSite(const CallSite&);
+            CallSite& operator=(const CallSite&);
+        };
+
 
 
        /**
@@ -56,6 +96,13 @@ namespace log4cxx
                       const char * const functionName,
                       int lineNumber);
 
+       /**
+        *   Constructor.
+        *   @param site call site whose parsed names are shared by this location,
+        *       must outlive this object.
+        */
+        explicit LocationInfo( const CallSite& site );
+
        /**
         *   Default constructor.
         */
@@ -97,6 +144,27 @@ namespace log4cxx
         /** Returns the method name of the caller. */
         const std::string getMethodName() const;
 
+        /**
+         *   Returns the class name of the call site in the internal encoding.
+         *   @param buf buffer that receives the name when it is not cached.
+         *   @returns cached name or <code>buf</code>.
+         */
+        const LogString& getClassName(LogString& buf) const;
+
+        /**
+         *   Returns the file name of the caller in the internal encoding.
+         *   @param buf buffer that receives the name when it is not cached.
+         *   @returns cached name or <code>buf</code>.
+         */
+        const LogString& getFileName(LogString& buf) const;
+
+        /**
+         *   Returns the method name of the caller in the internal encoding.
+         *   @param buf buffer that receives the name when it is not cached.
+         *   @returns cached name or <code>buf</code>.
+         */
+        const LogString& getMethodName(LogString& buf) const;
+
         void write(log4cxx::helpers::ObjectOutputStream& os, log4cxx::helpers::Pool& p) const;
 
 
@@ -109,7 +177,9 @@ namespace log4cxx
 
         /** Caller's method name. */
         const char * methodName;
-        
+
+        /** Parsed names of the call site, may be null. */
+        const CallSite * callSite;
 
       };
   }
@@ -131,6 +201,22 @@ namespace log4cxx
       #define LOG4CXX_LOCATION ::log4cxx::spi::LocationInfo(__FILE__, \
            __LOG4CXX_FUNC__,                                                         \
            __LINE__)
+/**
+ *   Declares the static call site of a logging statement,
+ *   only usable as a statement inside a block.
+ */
+      #define LOG4CXX_DECLARE_CALL_SITE                                           \
+           static const ::log4cxx::spi::LocationInfo::CallSite log4cxx_site_(     \
+               __FILE__, __LOG4CXX_FUNC__, __LINE__)
+/**
+ *   Location of the call site declared by LOG4CXX_DECLARE_CALL_SITE.
+ */
+      #define LOG4CXX_CALL_SITE_LOCATION (::log4cxx::spi::LocationInfo(log4cxx_site_))
+  #else
+      //
+      //   a user supplied LOG4CXX_LOCATION is used as is
+      #define LOG4CXX_DECLARE_CALL_SITE
+      #define LOG4CXX_CALL_SITE_LOCATION LOG4CXX_LOCATION
   #endif
 
 #endif //_LOG4CXX_SPI_LOCATION_LOCATIONINFO_H
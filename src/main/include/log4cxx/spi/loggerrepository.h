@@ -28,6 +28,7 @@
 #include <log4cxx/spi/loggerfactory.h>
 #include <log4cxx/level.h>
 #include <log4cxx/spi/hierarchyeventlistener.h>
+#include <log4cxx/helpers/clock.h>
 
 namespace log4cxx
 {
@@ -82,6 +83,22 @@ namespace log4cxx
                             for an explanation. */
                 virtual const LevelPtr& getThreshold() const = 0;
 
+                /**
+                Set the clock used to time stamp the logging events
+                of this repository. By default, the clock is
+                <code>helpers::Clock::getDefault()</code>.
+                The default implementation ignores the clock so that
+                repositories that predate clocks keep compiling.  */
+                virtual void setClock(const helpers::ClockPtr& /* clock */) {}
+
+                /**
+                Get the clock used to time stamp logging events.
+                The default implementation returns
+                <code>helpers::Clock::getDefault()</code>.  */
+                virtual const helpers::ClockPtr& getClock() const {
+                    return helpers::Clock::getDefault();
+                }
+
                 virtual LoggerPtr getLogger(const LogString& name) = 0;
 
                 virtual LoggerPtr getLogger(const LogString& name,
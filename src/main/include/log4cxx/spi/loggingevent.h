@@ -31,6 +31,8 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/mdc.h>
 #include <log4cxx/spi/location/locationinfo.h>
+#include <log4cxx/spi/field.h>
+#include <log4cxx/spi/messagesupplier.h>
 #include <vector>
 
 
@@ -39,6 +41,9 @@ namespace log4cxx
         namespace helpers
         {
                 class ObjectOutputStream;
+                class Clock;
+                class MDCMap;
+                class NDCNode;
         }
 
         namespace spi
@@ -80,6 +85,35 @@ namespace log4cxx
                                 const LevelPtr& level,   const LogString& message,
                                 const log4cxx::spi::LocationInfo& location);
 
+                        /**
+                        Instantiate a LoggingEvent time stamped by the specified clock.
+
+                        @param logger The logger of this event.
+                        @param level The level of this event.
+                        @param message  The message of this event.
+                        @param location location of logging request.
+                        @param clock clock, typically the clock of the logger's repository.
+                        */
+                        LoggingEvent(const LogString& logger,
+                                const LevelPtr& level,   const LogString& message,
+                                const log4cxx::spi::LocationInfo& location,
+                                const log4cxx::helpers::Clock& clock);
+
+                        /**
+                        Instantiate a LoggingEvent whose message is produced
+                        on the first call to getMessage.
+
+                        @param logger The logger of this event.
+                        @param level The level of this event.
+                        @param supplier supplier of the message of this event.
+                        @param location location of logging request.
+                        @param clock clock, typically the clock of the logger's repository.
+                        */
+                        LoggingEvent(const LogString& logger,
+                                const LevelPtr& level,   const MessageSupplierPtr& supplier,
+                                const log4cxx::spi::LocationInfo& location,
+                                const log4cxx::helpers::Clock& clock);
+
                         ~LoggingEvent();
 
                         /** Return the level of this event. */
@@ -92,12 +126,26 @@ namespace log4cxx
                         }
 
                         /** Return the message for this logging event. */
-                        inline const LogString& getMessage() const
-                                { return message; }
+                        inline const LogString& getMessage() const {
+                                if (supplier != 0) {
+                                    supplyMessage();
+                                }
+                                return message;
+                        }
 
                         /** Return the message for this logging event. */
-                        inline const LogString& getRenderedMessage() const
-                                { return message; }
+                        inline const LogString& getRenderedMessage() const {
+                                return getMessage();
+                        }
+
+                        /**
+                        Produces the message now if the event is still referenced
+                        by someone other than the caller, such as an appender
+                        that keeps its events, so that the supplier never
+                        outlives the logging call.  Called by Logger once
+                        the appenders have been called.
+                        */
+                        void detachSupplier() const;
 
                         /**Returns the time when the application started,
                         in seconds elapsed since 01.01.1970.
@@ -113,6 +161,12 @@ namespace log4cxx
                         inline log4cxx_time_t getTimeStamp() const
                                 { return timeStamp; }
 
+                        /** Return the timeStamp of this event in nanoseconds
+                        elapsed since 1970-01-01, the nanoseconds within the microsecond
+                        are only significant if the clock of the event provides them. */
+                        inline log4cxx_int64_t getTimeStampNanos() const
+                                { return ((log4cxx_int64_t) timeStamp) * 1000 + nanos; }
+
                         /* Return the file where this log statement was written. */
                         inline const log4cxx::spi::LocationInfo& getLocationInformation() const
                                 { return locationInfo; }
@@ -152,6 +206,15 @@ namespace log4cxx
                         */
                         bool getMDC(const LogString& key, LogString& dest) const;
 
+                        /**
+                        * Appends the context corresponding to an interned key,
+                        * see MDC::getKey.
+                        * @param key key handle.
+                        * @param dest string to which value, if any, is appended.
+                        * @return true if key had a corresponding value.
+                        */
+                        bool getMDC(int key, LogString& dest) const;
+
                         LOG4CXX_LIST_DEF(KeySet, LogString);
                         /**
                         * Returns the set of of the key values in the MDC for the event.
@@ -168,6 +231,13 @@ namespace log4cxx
                         */
                         void getMDCCopy() const;
 
+                        /**
+                        Obtain this thread's NDC prior to serialization
+                        or asynchronous logging, the NDC is only rendered
+                        to a string when it is requested by getNDC.
+                        */
+                        void getNDCCopy() const;
+
                         /**
                         * Return a previously set property.
                         * @param key key.
@@ -188,6 +258,31 @@ namespace log4cxx
                         */
                         void setProperty(const LogString& key, const LogString& value);
 
+                        /**
+                        * Adds a typed field.
+                        * @param field field.
+                        */
+                        void addField(const Field& field);
+
+                        /**
+                        * Adds typed fields.
+                        * @param fields fields.
+                        */
+                        void addFields(const FieldList& fields);
+
+                        /**
+                        * Gets the typed fields in the order they were added.
+                        * @return fields, empty if none were added.
+                        */
+                        const FieldList& getFields() const;
+
+                        /**
+                        * Finds a typed field.
+                        * @param key key.
+                        * @return first field with the key or null.
+                        */
+                        const Field* getField(const LogString& key) const;
+
                 private:
                         /**
                         * The logger of the logging event.
@@ -198,16 +293,21 @@ namespace log4cxx
                         LevelPtr level;
 
                         /** The nested diagnostic context (NDC) of logging event. */
-                        mutable LogString* ndc;
+                        mutable const helpers::NDCNode* ndc;
 
                         /** The mapped diagnostic context (MDC) of logging event. */
-                        mutable MDC::Map* mdcCopy;
+                        mutable const helpers::MDCMap* mdcCopy;
 
                         /**
                         * A map of String keys and String values.
                         */
                         std::map<LogString, LogString> * properties;
 
+                        /**
+                        * Typed fields, allocated when the first field is added.
+                        */
+                        FieldList* fields;
+
                         /** Have we tried to do an NDC lookup? If we did, there is no need
                         *  to do it again.  Note that its value is always false when
                         *  serialized. Thus, a receiving SocketNode will never use it's own
@@ -223,13 +323,21 @@ namespace log4cxx
                         mutable bool mdcCopyLookupRequired;
 
                         /** The application supplied message of logging event. */
-                        LogString message;
+                        mutable LogString message;
+
+                        /** Supplier of the message until the message is requested. */
+                        mutable MessageSupplierPtr supplier;
+
+                        void supplyMessage() const;
 
 
                         /** The number of milliseconds elapsed from 1/1/1970 until logging event
                          was created. */
                         log4cxx_time_t timeStamp;
 
+                        /** Nanoseconds within the microsecond of timeStamp. */
+                        int nanos;
+
                         /** The is the location where this log statement was written. */
                         const log4cxx::spi::LocationInfo locationInfo;
 
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXX_SPI_MESSAGE_SUPPLIER_H
+#define _LOG4CXX_SPI_MESSAGE_SUPPLIER_H
+
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/objectimpl.h>
+#include <log4cxx/helpers/objectptr.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <string>
+
+namespace log4cxx
+{
+        namespace spi
+        {
+                /**
+                Produces the message of a logging event on demand.
+
+                <p>A logging event created with a supplier only asks for
+                its message when an appender that passed its threshold
+                and filters formats the event, so the cost of building an
+                expensive message is not paid for events that are
+                discarded.  If an appender keeps the event beyond the
+                logging call, the logger obtains the message before the
+                call returns, so the supplier never outlives the call and
+                may refer to local variables.
+                */
+                class LOG4CXX_EXPORT MessageSupplier : public virtual helpers::ObjectImpl
+                {
+                public:
+                        DECLARE_ABSTRACT_LOG4CXX_OBJECT(MessageSupplier)
+                        BEGIN_LOG4CXX_CAST_MAP()
+                                LOG4CXX_CAST_ENTRY(MessageSupplier)
+                        END_LOG4CXX_CAST_MAP()
+
+                        virtual ~MessageSupplier() {}
+
+                        /**
+                        Appends the message, called at most once per event.
+                        @param dest destination.
+                        */
+                        virtual void supply(LogString& dest) const = 0;
+                };
+                LOG4CXX_PTR_DEF(MessageSupplier);
+
+                /**
+                Adapts a function or function object with the signature
+                <code>std::string f()</code>, const when a function
+                object, to MessageSupplier.
+                */
+                template<class F>
+                class FunctorMessageSupplier : public MessageSupplier
+                {
+                public:
+                        FunctorMessageSupplier(const F& functor1) : functor(functor1) {
+                        }
+
+                        void supply(LogString& dest) const {
+                                std::string message(functor());
+                                helpers::Transcoder::decode(message, dest);
+                        }
+
+                private:
+                        FunctorMessageSupplier(const FunctorMessageSupplier&);
+                        FunctorMessageSupplier& operator=(const FunctorMessageSupplier&);
+                        F functor;
+                };
+        }
+}
+
+#endif //_LOG4CXX_SPI_MESSAGE_SUPPLIER_H
@@ -199,6 +199,12 @@ namespace log4cxx
                 Layout#appendHeader method.  */
                 virtual void writeHeader(log4cxx::helpers::Pool& p);
 
+                /**
+                Returns the current writer, may be null.  */
+                inline const log4cxx::helpers::WriterPtr& getWriter() const {
+                    return writer;
+                }
+
         private:
                 //
                 //  prevent copy and assignment
@@ -18,6 +18,12 @@
 #include <log4cxx/consoleappender.h>
 #include "logunit.h"
 #include "writerappendertestcase.h"
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/helpers/consoleoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <apr.h>
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -34,6 +40,12 @@ class ConsoleAppenderTestCase : public WriterAppenderTestCase
                 LOGUNIT_TEST(testDefaultThreshold);
                 LOGUNIT_TEST(testSetOptionThreshold);
                 LOGUNIT_TEST(testNoLayout);
+                LOGUNIT_TEST(testNonBlockingOptions);
+#if APR_HAS_THREADS
+                LOGUNIT_TEST(testNonBlockingDrops);
+                LOGUNIT_TEST(testNonBlockingWholeEvents);
+                LOGUNIT_TEST(testNonBlockingReactivate);
+#endif
    LOGUNIT_TEST_SUITE_END();
 
 
@@ -52,6 +64,88 @@ public:
             LOG4CXX_INFO(logger, "No layout specified for ConsoleAppender");
             logger->removeAppender(appender);
         }
+
+        void testNonBlockingOptions() {
+            ConsoleAppenderPtr appender(new ConsoleAppender());
+            LOGUNIT_ASSERT_EQUAL(false, appender->getDirectWrite());
+            LOGUNIT_ASSERT_EQUAL(false, appender->getNonBlocking());
+            appender->setOption(LOG4CXX_STR("DirectWrite"), LOG4CXX_STR("true"));
+            appender->setOption(LOG4CXX_STR("NonBlocking"), LOG4CXX_STR("true"));
+            appender->setOption(LOG4CXX_STR("BufferSize"), LOG4CXX_STR("16KB"));
+            LOGUNIT_ASSERT_EQUAL(true, appender->getDirectWrite());
+            LOGUNIT_ASSERT_EQUAL(true, appender->getNonBlocking());
+            LOGUNIT_ASSERT_EQUAL(16 * 1024, appender->getBufferSize());
+            LOGUNIT_ASSERT_EQUAL(0U, appender->getDroppedCount());
+        }
+
+        /**
+         *  Events larger than the buffer can never be written
+         *  and must be counted rather than waited on.
+         */
+        void testNonBlockingDrops() {
+            Pool p;
+            ConsoleAppenderPtr appender(new ConsoleAppender());
+            appender->setLayout(new SimpleLayout());
+            appender->setNonBlocking(true);
+            appender->setBufferSize(8);
+            appender->activateOptions(p);
+            LoggerPtr logger(Logger::getLogger("org.apache.log4j.ConsoleAppenderTestCase"));
+            bool additivity = logger->getAdditivity();
+            logger->setAdditivity(false);
+            logger->addAppender(appender);
+            for(int i = 0; i < 10; i++) {
+                LOG4CXX_INFO(logger, "longer than the buffer");
+            }
+            logger->removeAppender(appender);
+            logger->setAdditivity(additivity);
+            LOGUNIT_ASSERT_EQUAL(10U, appender->getDroppedCount());
+            appender->close();
+        }
+
+        /**
+         *  An event written in pieces is dropped whole
+         *  and counted once.
+         */
+        void testNonBlockingWholeEvents() {
+            Pool p;
+            ConsoleOutputStreamPtr stream(new ConsoleOutputStream(false, 100));
+            char data[60];
+            memset(data, 'A', sizeof(data));
+            stream->beginEvent();
+            for(int i = 0; i < 3; i++) {
+                ByteBuffer buf(data, sizeof(data));
+                stream->write(buf, p);
+                LOGUNIT_ASSERT_EQUAL((size_t) 0, buf.remaining());
+            }
+            stream->endEvent();
+            LOGUNIT_ASSERT_EQUAL(1U, stream->getDropped());
+            stream->close(p);
+        }
+
+        /**
+         *  Activating without NonBlocking forgets the
+         *  previous stream and its count.
+         */
+        void testNonBlockingReactivate() {
+            Pool p;
+            ConsoleAppenderPtr appender(new ConsoleAppender());
+            appender->setLayout(new SimpleLayout());
+            appender->setNonBlocking(true);
+            appender->setBufferSize(8);
+            appender->activateOptions(p);
+            LoggerPtr logger(Logger::getLogger("org.apache.log4j.ConsoleAppenderTestCase"));
+            bool additivity = logger->getAdditivity();
+            logger->setAdditivity(false);
+            logger->addAppender(appender);
+            LOG4CXX_INFO(logger, "longer than the buffer");
+            logger->removeAppender(appender);
+            logger->setAdditivity(additivity);
+            LOGUNIT_ASSERT_EQUAL(1U, appender->getDroppedCount());
+            appender->setNonBlocking(false);
+            appender->activateOptions(p);
+            LOGUNIT_ASSERT_EQUAL(0U, appender->getDroppedCount());
+            appender->close();
+        }
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(ConsoleAppenderTestCase);
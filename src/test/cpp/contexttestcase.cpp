@@ -0,0 +1,139 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/context.h>
+#include <log4cxx/mdc.h>
+#include <log4cxx/ndc.h>
+#include <log4cxx/helpers/thread.h>
+#include "insertwide.h"
+#include "logunit.h"
+
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+LOGUNIT_CLASS(ContextTestCase)
+{
+        LOGUNIT_TEST_SUITE(ContextTestCase);
+                LOGUNIT_TEST(testScope);
+                LOGUNIT_TEST(testEmpty);
+                LOGUNIT_TEST(testOtherThread);
+        LOGUNIT_TEST_SUITE_END();
+
+public:
+
+        void setUp() {
+            MDC::clear();
+            NDC::clear();
+        }
+
+        void tearDown() {
+            MDC::clear();
+            NDC::clear();
+        }
+
+        static LogString getNDC() {
+            LogString ndc;
+            NDC::get(ndc);
+            return ndc;
+        }
+
+        static LogString getMDC(const LogString& key) {
+            LogString value;
+            MDC::get(key, value);
+            return value;
+        }
+
+        /**
+         *   A context installed by a scope replaces the MDC and NDC
+         *   until the scope ends, changes within the scope are discarded.
+         */
+        void testScope() {
+            MDC::putLS(LOG4CXX_STR("user"), LOG4CXX_STR("alice"));
+            NDC::push("request");
+            NDC::push("step");
+            Context context;
+
+            MDC::clear();
+            NDC::clear();
+            NDC::push("other");
+            {
+                Context::Scope scope(context);
+                LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request step"), getNDC());
+                LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("alice"), getMDC(LOG4CXX_STR("user")));
+
+                MDC::putLS(LOG4CXX_STR("user"), LOG4CXX_STR("bob"));
+                NDC::push("nested");
+                LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request step nested"), getNDC());
+            }
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("other"), getNDC());
+            LOGUNIT_ASSERT_EQUAL(LogString(), getMDC(LOG4CXX_STR("user")));
+
+            context.install();
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request step"), getNDC());
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("alice"), getMDC(LOG4CXX_STR("user")));
+        }
+
+        /**
+         *   Installing a context captured with no MDC or NDC clears both.
+         */
+        void testEmpty() {
+            Context empty;
+            MDC::putLS(LOG4CXX_STR("user"), LOG4CXX_STR("alice"));
+            NDC::push("request");
+            {
+                Context::Scope scope(empty);
+                LOGUNIT_ASSERT(NDC::empty());
+                LOGUNIT_ASSERT_EQUAL(LogString(), getMDC(LOG4CXX_STR("user")));
+            }
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request"), getNDC());
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("alice"), getMDC(LOG4CXX_STR("user")));
+        }
+
+        struct Task {
+            Context context;
+            LogString ndc;
+            LogString user;
+        };
+
+        static void* LOG4CXX_THREAD_FUNC runTask(apr_thread_t* /* thread */, void* data) {
+            Task* task = (Task*) data;
+            Context::Scope scope(task->context);
+            task->ndc = getNDC();
+            task->user = getMDC(LOG4CXX_STR("user"));
+            NDC::push("worker");
+            return 0;
+        }
+
+        /**
+         *   A context captured on one thread can be installed on another.
+         */
+        void testOtherThread() {
+            MDC::putLS(LOG4CXX_STR("user"), LOG4CXX_STR("alice"));
+            NDC::push("request");
+            Task task;
+            Thread thread;
+            thread.run(runTask, &task);
+            thread.join();
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request"), task.ndc);
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("alice"), task.user);
+            LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("request"), getNDC());
+        }
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(ContextTestCase);
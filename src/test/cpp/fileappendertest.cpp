@@ -17,11 +17,57 @@
 #include <log4cxx/helpers/pool.h>
 #include <log4cxx/fileappender.h>
 #include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/helpers/fileinputstream.h>
+#include <log4cxx/helpers/inputstreamreader.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/fileoutputstream.h>
+#include <log4cxx/helpers/mappedfileoutputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
 #include "logunit.h"
+#include <map>
+#include <string.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
 
+namespace {
+    /**
+     *  Output stream that counts the syncs of the stream it wraps.
+     */
+    class SyncCountingOutputStream : public OutputStream {
+    public:
+        SyncCountingOutputStream(OutputStreamPtr& out1) : out(out1), syncs(0) {}
+        void close(Pool& p) { out->close(p); }
+        void flush(Pool& p) { out->flush(p); }
+        void write(ByteBuffer& buf, Pool& p) { out->write(buf, p); }
+        void sync(Pool& p) {
+            syncs++;
+            out->sync(p);
+        }
+        OutputStreamPtr out;
+        volatile int syncs;
+    };
+
+    /**
+     *  FileAppender that counts the syncs of its file.
+     */
+    class SyncCountingFileAppender : public FileAppender {
+    public:
+        SyncCountingFileAppender() : counter(0) {}
+        int getSyncs() const { return counter == 0 ? 0 : (int) counter->syncs; }
+    protected:
+        OutputStreamPtr createCommitStream(OutputStreamPtr& os) {
+            counter = new SyncCountingOutputStream(os);
+            OutputStreamPtr counted(counter);
+            return FileAppender::createCommitStream(counted);
+        }
+    private:
+        SyncCountingOutputStream* counter;
+    };
+}
+
 
 /**
  *
@@ -32,6 +78,14 @@ LOGUNIT_CLASS(FileAppenderTest) {
           LOGUNIT_TEST(testDirectoryCreation);
           LOGUNIT_TEST(testgetSetThreshold);
           LOGUNIT_TEST(testIsAsSevereAsThreshold);
+          LOGUNIT_TEST(testFlushInterval);
+          LOGUNIT_TEST(testConcurrentWrites);
+          LOGUNIT_TEST(testMapWindowSize);
+          LOGUNIT_TEST(testMapWindowSizeZeroTail);
+          LOGUNIT_TEST(testAsyncIO);
+          LOGUNIT_TEST(testCommitLevel);
+          LOGUNIT_TEST(testCommitLevelBuffered);
+          LOGUNIT_TEST(testPreallocation);
   LOGUNIT_TEST_SUITE_END();
 public:
   /**
@@ -77,6 +131,322 @@ public:
     LevelPtr debug = Level::getDebug();
     LOGUNIT_ASSERT(appender->isAsSevereAsThreshold(debug));
   }
+
+  /**
+   * Creates an appender that truncates the file and writes
+   * one message per line, options are set before activation.
+   */
+  static FileAppenderPtr createAppender(const File& file, Pool& p) {
+      file.deleteFile(p);
+      FileAppenderPtr appender(new FileAppender());
+      appender->setFile(file.getPath());
+      appender->setAppend(false);
+      appender->setLayout(new PatternLayout(LOG4CXX_STR("%m%n")));
+      return appender;
+  }
+
+  static spi::LoggingEventPtr createEvent(const LevelPtr& level, const LogString& msg) {
+      return new spi::LoggingEvent(LOG4CXX_STR("org.example.foo"),
+          level, msg, spi::LocationInfo::getLocationUnavailable());
+  }
+
+  /**
+   * Appends count events numbered from first.
+   */
+  static void appendNumbered(FileAppenderPtr& appender, int first, int count, Pool& p) {
+      for(int i = first; i < first + count; i++) {
+          LogString msg(LOG4CXX_STR("Hello, World "));
+          StringHelper::toString(i, p, msg);
+          appender->doAppend(createEvent(Level::getInfo(), msg), p);
+      }
+  }
+
+  /**
+   * Checks that the file holds exactly the events numbered from 0 to count - 1 in order.
+   */
+  void assertNumbered(const File& file, int count) {
+      std::vector<LogString> lines;
+      readLines(file, lines);
+      LOGUNIT_ASSERT_EQUAL((size_t) count, lines.size());
+      Pool p;
+      for(int i = 0; i < count; i++) {
+          LogString msg(LOG4CXX_STR("Hello, World "));
+          StringHelper::toString(i, p, msg);
+          LOGUNIT_ASSERT_EQUAL(msg, lines[i]);
+      }
+  }
+
+  /**
+   * Length in bytes of the events numbered from 0 to count - 1.
+   */
+  static size_t numberedLength(int count) {
+      Pool p;
+      size_t length = 0;
+      for(int i = 0; i < count; i++) {
+          LogString msg(LOG4CXX_STR("Hello, World "));
+          StringHelper::toString(i, p, msg);
+          length += msg.length() + LogString(LOG4CXX_EOL).length();
+      }
+      return length;
+  }
+
+  /**
+   * Tests that output held for a background write reaches
+   * the file within the flush interval rather than on close.
+   */
+  void testFlushInterval() {
+      Pool p;
+      File file(LOG4CXX_STR("output/flushinterval.log"));
+      FileAppenderPtr appender(createAppender(file, p));
+      appender->setBufferSize(64 * 1024);
+      appender->setFlushIntervalMillis(50);
+      appender->activateOptions(p);
+
+      appendNumbered(appender, 0, 1, p);
+      for(int i = 0; i < 100 && file.length(p) < numberedLength(1); i++) {
+          Thread::sleep(20);
+      }
+      LOGUNIT_ASSERT_EQUAL(numberedLength(1), file.length(p));
+      assertNumbered(file, 1);
+
+      appendNumbered(appender, 1, 99, p);
+      appender->close();
+      assertNumbered(file, 100);
+  }
+
+  struct AppendTask {
+      FileAppender* appender;
+      spi::LoggingEvent* event;
+      int count;
+  };
+
+  static void* LOG4CXX_THREAD_FUNC appendEvents(apr_thread_t* /* thread */, void* data) {
+      AppendTask* task = (AppendTask*) data;
+      Pool p;
+      spi::LoggingEventPtr event(task->event);
+      for(int i = 0; i < task->count; i++) {
+          task->appender->doAppend(event, p);
+      }
+      return 0;
+  }
+
+  /**
+   * Reads the lines of a file.
+   */
+  static void readLines(const File& file, std::vector<LogString>& lines) {
+      Pool p;
+      InputStreamPtr in(new FileInputStream(file));
+      InputStreamReaderPtr reader(new InputStreamReader(in));
+      LogString contents(reader->read(p));
+      const LogString eol(LOG4CXX_EOL);
+      LogString::size_type start = 0;
+      LogString::size_type end = contents.find(eol);
+      while(end != LogString::npos) {
+          lines.push_back(contents.substr(start, end - start));
+          start = end + eol.length();
+          end = contents.find(eol, start);
+      }
+      if (start < contents.length()) {
+          lines.push_back(contents.substr(start));
+      }
+  }
+
+  /**
+   * Tests that appends from several threads with ConcurrentWrites
+   * are neither lost nor overlapped, and are in the file
+   * before the appender is closed.
+   */
+  void testConcurrentWrites() {
+      Pool p;
+      File file(LOG4CXX_STR("output/concurrentwrites.log"));
+      FileAppenderPtr appender(createAppender(file, p));
+      appender->setConcurrentWrites(true);
+      appender->activateOptions(p);
+
+      //
+      //   each thread writes its own message so that
+      //      interleaved or overlapping writes show as bad lines
+      enum { THREADS = 4, COUNT = 1000 };
+      spi::LoggingEventPtr events[THREADS];
+      AppendTask tasks[THREADS];
+      Thread threads[THREADS];
+      for(int i = 0; i < THREADS; i++) {
+          LogString msg(LOG4CXX_STR("Hello, World from thread "));
+          StringHelper::toString(i, p, msg);
+          events[i] = createEvent(Level::getInfo(), msg);
+          AppendTask task = { appender, events[i], COUNT };
+          tasks[i] = task;
+      }
+      for(int i = 0; i < THREADS; i++) {
+          threads[i].run(appendEvents, &tasks[i]);
+      }
+      for(int i = 0; i < THREADS; i++) {
+          threads[i].join();
+      }
+
+      std::vector<LogString> lines;
+      readLines(file, lines);
+      appender->close();
+      LOGUNIT_ASSERT_EQUAL((size_t) (THREADS * COUNT), lines.size());
+      std::map<LogString, int> counts;
+      for(std::vector<LogString>::const_iterator iter = lines.begin();
+          iter != lines.end();
+          iter++) {
+          counts[*iter]++;
+      }
+      LOGUNIT_ASSERT_EQUAL((size_t) THREADS, counts.size());
+      for(int i = 0; i < THREADS; i++) {
+          LOGUNIT_ASSERT_EQUAL((int) COUNT, counts[events[i]->getMessage()]);
+      }
+  }
+
+  /**
+   * Tests that a memory mapped file grows a window at a time
+   * while open and holds exactly the appended events once closed.
+   */
+  void testMapWindowSize() {
+      if (!MappedFileOutputStream::isSupported()) {
+          return;
+      }
+      Pool p;
+      File file(LOG4CXX_STR("output/mapwindowsize.log"));
+      FileAppenderPtr appender(createAppender(file, p));
+      appender->setMapWindowSize(4096);
+      appender->activateOptions(p);
+
+      appendNumbered(appender, 0, 2000, p);
+      size_t mapped = file.length(p);
+      LOGUNIT_ASSERT(mapped >= numberedLength(2000));
+      LOGUNIT_ASSERT_EQUAL((size_t) 0, mapped % 4096);
+      appender->close();
+
+      LOGUNIT_ASSERT_EQUAL(numberedLength(2000), file.length(p));
+      assertNumbered(file, 2000);
+  }
+
+  /**
+   * Tests that appending to a memory mapped file continues after
+   * the last written byte when a previous process ended without
+   * close and left the zero filled end of its window.
+   */
+  void testMapWindowSizeZeroTail() {
+      if (!MappedFileOutputStream::isSupported()) {
+          return;
+      }
+      Pool p;
+      File file(LOG4CXX_STR("output/mapwindowsizetail.log"));
+      file.deleteFile(p);
+      {
+          FileOutputStream out(file.getPath(), false);
+          std::vector<char> bytes(10000, 0);
+          memcpy(&bytes[0], "Hello\n", 6);
+          ByteBuffer buf(&bytes[0], bytes.size());
+          out.write(buf, p);
+          out.close(p);
+      }
+
+      FileAppenderPtr appender(new FileAppender());
+      appender->setFile(file.getPath());
+      appender->setAppend(true);
+      appender->setMapWindowSize(4096);
+      appender->setLayout(new PatternLayout(LOG4CXX_STR("%m\n")));
+      appender->activateOptions(p);
+      spi::LoggingEventPtr event(new spi::LoggingEvent(LOG4CXX_STR("org.example.foo"),
+          Level::getInfo(), LOG4CXX_STR("World"),
+          spi::LocationInfo::getLocationUnavailable()));
+      appender->doAppend(event, p);
+      appender->close();
+
+      InputStreamPtr in(new FileInputStream(file));
+      InputStreamReaderPtr reader(new InputStreamReader(in));
+      LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("Hello\nWorld\n"), reader->read(p));
+  }
+
+  /**
+   * Tests that asynchronous writes cycling through all buffers
+   * reach the file in the order of the events.
+   */
+  void testAsyncIO() {
+      Pool p;
+      File file(LOG4CXX_STR("output/asyncio.log"));
+      FileAppenderPtr appender(createAppender(file, p));
+      appender->setBufferSize(256);
+      appender->setAsyncIO(true);
+      appender->activateOptions(p);
+
+      appendNumbered(appender, 0, 2000, p);
+      appender->close();
+
+      LOGUNIT_ASSERT_EQUAL(numberedLength(2000), file.length(p));
+      assertNumbered(file, 2000);
+  }
+  /**
+   * Appends 99 INFO events and one WARN event with CommitLevel WARN
+   * and an interval too long to pass during the test.
+   * @return syncs caused by the WARN event.
+   */
+  int appendCommitted(const File& file, bool buffered) {
+      Pool p;
+      file.deleteFile(p);
+      SyncCountingFileAppender* counting = new SyncCountingFileAppender();
+      FileAppenderPtr appender(counting);
+      appender->setFile(file.getPath());
+      appender->setAppend(false);
+      appender->setLayout(new PatternLayout(LOG4CXX_STR("%m%n")));
+      appender->setOption(LOG4CXX_STR("CommitIntervalMillis"), LOG4CXX_STR("60000"));
+      appender->setOption(LOG4CXX_STR("CommitLevel"), LOG4CXX_STR("WARN"));
+      if (buffered) {
+          appender->setBufferSize(64 * 1024);
+          appender->setFlushIntervalMillis(60000);
+      }
+      appender->activateOptions(p);
+
+      appendNumbered(appender, 0, 99, p);
+      LOGUNIT_ASSERT_EQUAL(0, counting->getSyncs());
+      LogString msg(LOG4CXX_STR("Hello, World "));
+      StringHelper::toString(99, p, msg);
+      appender->doAppend(createEvent(Level::getWarn(), msg), p);
+      int syncs = counting->getSyncs();
+      LOGUNIT_ASSERT_EQUAL(numberedLength(100), file.length(p));
+      appender->close();
+      assertNumbered(file, 100);
+      return syncs;
+  }
+
+  /**
+   * Tests that appending an event at CommitLevel syncs the file once.
+   */
+  void testCommitLevel() {
+      LOGUNIT_ASSERT_EQUAL(1, appendCommitted(File(LOG4CXX_STR("output/commitlevel.log")), false));
+  }
+
+  /**
+   * Tests that output held by FlushIntervalMillis is written
+   * before the commit for an event at CommitLevel.
+   */
+  void testCommitLevelBuffered() {
+      LOGUNIT_ASSERT_EQUAL(1, appendCommitted(File(LOG4CXX_STR("output/commitlevelbuffered.log")), true));
+  }
+
+  /**
+   * Tests that preallocated blocks and page cache drops
+   * do not change the size or content of the file while open.
+   */
+  void testPreallocation() {
+      Pool p;
+      File file(LOG4CXX_STR("output/preallocation.log"));
+      FileAppenderPtr appender(createAppender(file, p));
+      appender->setPreallocationSize(1024 * 1024);
+      appender->setDropCacheSize(4096);
+      appender->activateOptions(p);
+
+      appendNumbered(appender, 0, 2000, p);
+      LOGUNIT_ASSERT_EQUAL(numberedLength(2000), file.length(p));
+      assertNumbered(file, 2000);
+      appender->close();
+      LOGUNIT_ASSERT_EQUAL(numberedLength(2000), file.length(p));
+  }
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileAppenderTest);
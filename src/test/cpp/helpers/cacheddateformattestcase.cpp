@@ -24,6 +24,8 @@
 #include "../insertwide.h"
 #include <apr.h>
 #include <apr_time.h>
+#include <apr_atomic.h>
+#include <log4cxx/helpers/thread.h>
 #include "localechanger.h"
 
 using namespace log4cxx;
@@ -77,6 +79,10 @@ LOGUNIT_CLASS(CachedDateFormatTestCase)
      LOGUNIT_TEST( test19);
      LOGUNIT_TEST( test20);
      LOGUNIT_TEST( test21);
+#if APR_HAS_THREADS
+     LOGUNIT_TEST( test22);
+#endif
+     LOGUNIT_TEST( test23);
      LOGUNIT_TEST_SUITE_END();
 
 
@@ -607,6 +613,77 @@ void test21() {
     LOGUNIT_ASSERT_EQUAL(1000, maxValid);
 }
 
+#if APR_HAS_THREADS
+struct ThreadPackage {
+    CachedDateFormat* cached;
+    DateFormatPtr base;
+    apr_time_t start;
+    volatile apr_uint32_t failCount;
+};
+
+static void* LOG4CXX_THREAD_FUNC test22Action(apr_thread_t* /* thread */, void* data) {
+    ThreadPackage* package = (ThreadPackage*) data;
+    Pool p;
+    LogString expected;
+    LogString actual;
+    for(int i = 0; i < 20000; i++) {
+        apr_time_t ticks = package->start + (i % 3000) * 1000 + (i / 3000) * 1000000;
+        expected.erase(expected.begin(), expected.end());
+        actual.erase(actual.begin(), actual.end());
+        package->base->format(expected, ticks, p);
+        package->cached->format(actual, ticks, p);
+        if (expected != actual) {
+            apr_atomic_inc32(&package->failCount);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Check that concurrent use of a single format
+ * gives the same results as the underlying format.
+ */
+void test22() {
+    enum { THREAD_COUNT = 8 };
+    DateFormatPtr baseFormatter(new AbsoluteTimeDateFormat());
+    baseFormatter->setTimeZone(TimeZone::getGMT());
+    CachedDateFormat cachedFormatter(baseFormatter, 1000000);
+    ThreadPackage package;
+    package.cached = &cachedFormatter;
+    package.base = baseFormatter;
+    package.start = MICROSECONDS_PER_DAY * 12601L;
+    package.failCount = 0;
+    Thread threads[THREAD_COUNT];
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        threads[i].run(test22Action, &package);
+    }
+    for(int i = 0; i < THREAD_COUNT; i++) {
+        threads[i].join();
+    }
+    LOGUNIT_ASSERT_EQUAL((apr_uint32_t) 0, apr_atomic_read32(&package.failCount));
+}
+#endif
+
+/**
+ * Check that creating many formats, more than the number of
+ * thread keys a process may hold, keeps working and that a
+ * format does not see the cache of a destroyed one.
+ */
+void test23() {
+    DateFormatPtr baseFormatter(new AbsoluteTimeDateFormat());
+    baseFormatter->setTimeZone(TimeZone::getGMT());
+    apr_time_t ticks = MICROSECONDS_PER_DAY * 12601L;
+    Pool p;
+    for(int i = 0; i < 5000; i++) {
+        CachedDateFormat cachedFormatter(baseFormatter, 1000000);
+        LogString expected;
+        LogString actual;
+        baseFormatter->format(expected, ticks + i * 1000, p);
+        cachedFormatter.format(actual, ticks + i * 1000, p);
+        LOGUNIT_ASSERT_EQUAL(expected, actual);
+    }
+}
+
 };
 
 
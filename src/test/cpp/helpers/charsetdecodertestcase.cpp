@@ -19,6 +19,7 @@
 #include "../logunit.h"
 #include "../insertwide.h"
 #include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/transcoder.h>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -34,6 +35,10 @@ LOGUNIT_CLASS(CharsetDecoderTestCase)
                 LOGUNIT_TEST(decode1);
                 LOGUNIT_TEST(decode2);
                 LOGUNIT_TEST(decode8);
+                LOGUNIT_TEST(decode9);
+                LOGUNIT_TEST(decode10);
+                LOGUNIT_TEST(decode11);
+                LOGUNIT_TEST(decode12);
         LOGUNIT_TEST_SUITE_END();
 
         enum { BUFSIZE = 256 };
@@ -103,6 +108,65 @@ public:
           LOGUNIT_ASSERT_EQUAL(LogString(expected, 12), greeting);
         }
 
+        void decode9() {
+          CharsetDecoderPtr dec(CharsetDecoder::getISOLatinDecoder());
+          for(size_t pos = 0; pos <= 40; pos++) {
+            std::string buf(40, 'A');
+            buf.insert(pos, 1, (char) 0xE9);
+            ByteBuffer src(&buf[0], buf.length());
+            LogString greeting;
+            log4cxx_status_t stat = dec->decode(src, greeting);
+            LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, stat);
+            LOGUNIT_ASSERT_EQUAL((size_t) 0, src.remaining());
+
+            std::string utf8(40, 'A');
+            utf8.insert(pos, "\xC3\xA9");
+            LogString expected;
+            Transcoder::decodeUTF8(utf8, expected);
+            LOGUNIT_ASSERT_EQUAL(expected, greeting);
+          }
+        }
+
+        void decode10() {
+          CharsetDecoderPtr dec(CharsetDecoder::getDecoder(LOG4CXX_STR("US-ASCII")));
+          for(size_t pos = 0; pos <= 40; pos++) {
+            std::string buf(40, 'A');
+            buf.insert(pos, 1, (char) 0xE9);
+            ByteBuffer src(&buf[0], buf.length());
+            LogString greeting;
+            log4cxx_status_t stat = dec->decode(src, greeting);
+            LOGUNIT_ASSERT_EQUAL(true, CharsetDecoder::isError(stat));
+            LOGUNIT_ASSERT_EQUAL(pos, src.position());
+            LOGUNIT_ASSERT_EQUAL(LogString(pos, LOG4CXX_STR('A')), greeting);
+          }
+        }
+
+        void decode11() {
+          char buf[] = "\xF0\xD2\xC9\xD7\xC5\xD4, Pr\xFC\x66ung";
+          ByteBuffer src(buf, strlen(buf));
+          CharsetDecoderPtr dec(CharsetDecoder::getDecoder(LOG4CXX_STR("KOI8-R")));
+          LogString greeting;
+          log4cxx_status_t stat = dec->decode(src, greeting);
+          LOGUNIT_ASSERT_EQUAL(APR_SUCCESS, stat);
+          LOGUNIT_ASSERT_EQUAL((size_t) 0, src.remaining());
+          //
+          //   0xFC is a Cyrillic letter in KOI8-R
+          LogString expected;
+          Transcoder::decodeUTF8("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, Pr\xD0\xAD\x66ung", expected);
+          LOGUNIT_ASSERT_EQUAL(expected, greeting);
+        }
+
+        void decode12() {
+          char buf[] = "Hello\x81World";
+          ByteBuffer src(buf, strlen(buf));
+          CharsetDecoderPtr dec(CharsetDecoder::getDecoder(LOG4CXX_STR("windows-1252")));
+          LogString greeting;
+          log4cxx_status_t stat = dec->decode(src, greeting);
+          LOGUNIT_ASSERT_EQUAL(true, CharsetDecoder::isError(stat));
+          LOGUNIT_ASSERT_EQUAL((size_t) 5, src.position());
+          LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("Hello"), greeting);
+        }
+
 
 
 };
@@ -16,6 +16,10 @@
  */
 
 #include <log4cxx/helpers/charsetencoder.h>
+#include <log4cxx/helpers/transcoder.h>
+#include <log4cxx/helpers/outputstreamwriter.h>
+#include <log4cxx/helpers/bytearrayoutputstream.h>
+#include <log4cxx/helpers/pool.h>
 #include "../logunit.h"
 #include "../insertwide.h"
 #include <log4cxx/helpers/bytebuffer.h>
@@ -23,6 +27,7 @@
 #include <log4cxx/helpers/mutex.h>
 #include <log4cxx/helpers/condition.h>
 #include <log4cxx/helpers/synchronized.h>
+#include <log4cxx/helpers/exception.h>
 #include <apr.h>
 #include <apr_atomic.h>
 
@@ -38,6 +43,13 @@ LOGUNIT_CLASS(CharsetEncoderTestCase)
                 LOGUNIT_TEST(encode2);
                 LOGUNIT_TEST(encode3);
                 LOGUNIT_TEST(encode4);
+                LOGUNIT_TEST(encode5);
+                LOGUNIT_TEST(identity1);
+                LOGUNIT_TEST(identityWrite1);
+                LOGUNIT_TEST(singleByte1);
+                LOGUNIT_TEST(singleByte2);
+                LOGUNIT_TEST(cache1);
+                LOGUNIT_TEST(cache2);
 #if APR_HAS_THREADS        
                 LOGUNIT_TEST(thread1);
 #endif                
@@ -171,6 +183,149 @@ public:
           }
           LOGUNIT_ASSERT(iter == greeting.end());
         }
+
+        void encode5() {
+          CharsetEncoderPtr latin1(CharsetEncoder::getEncoder(LOG4CXX_STR("ISO-8859-1")));
+          CharsetEncoderPtr ascii(CharsetEncoder::getEncoder(LOG4CXX_STR("US-ASCII")));
+          CharsetEncoderPtr utf8(CharsetEncoder::getEncoder(LOG4CXX_STR("UTF-8")));
+          for(size_t pos = 0; pos <= 40; pos++) {
+             std::string utf8_greet(40, 'A');
+             utf8_greet.insert(pos, "\xC3\xA9");
+             LogString greeting;
+             Transcoder::decodeUTF8(utf8_greet, greeting);
+
+             char buf[BUFSIZE];
+             ByteBuffer out(buf, BUFSIZE);
+             LogString::const_iterator iter = greeting.begin();
+             log4cxx_status_t stat = latin1->encode(greeting, iter, out);
+             LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::isError(stat));
+             LOGUNIT_ASSERT(iter == greeting.end());
+             out.flip();
+             std::string latin1_greet(40, 'A');
+             latin1_greet.insert(pos, 1, (char) 0xE9);
+             LOGUNIT_ASSERT_EQUAL(latin1_greet, std::string(out.data(), out.limit()));
+
+             out.clear();
+             iter = greeting.begin();
+             stat = utf8->encode(greeting, iter, out);
+             LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::isError(stat));
+             out.flip();
+             LOGUNIT_ASSERT_EQUAL(utf8_greet, std::string(out.data(), out.limit()));
+
+             out.clear();
+             iter = greeting.begin();
+             stat = ascii->encode(greeting, iter, out);
+             LOGUNIT_ASSERT_EQUAL(true, CharsetEncoder::isError(stat));
+             LOGUNIT_ASSERT_EQUAL(pos, out.position());
+          }
+        }
+
+        void identity1() {
+#if LOG4CXX_LOGCHAR_IS_UTF8
+          LOGUNIT_ASSERT_EQUAL(true, CharsetEncoder::getUTF8Encoder()->isIdentity());
+#else
+          LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::getUTF8Encoder()->isIdentity());
+#endif
+          LOGUNIT_ASSERT_EQUAL(false,
+             CharsetEncoder::getEncoder(LOG4CXX_STR("ISO-8859-1"))->isIdentity());
+          LOGUNIT_ASSERT_EQUAL(false,
+             CharsetEncoder::getEncoder(LOG4CXX_STR("UTF-16BE"))->isIdentity());
+        }
+
+        void identityWrite1() {
+          LogString events[3];
+          Transcoder::decodeUTF8("first event\n", events[0]);
+          Transcoder::decodeUTF8(std::string(BUFSIZE * 5, 'A') + "\n", events[1]);
+          Transcoder::decodeUTF8("caf\xC3\xA9 \xE4\xB8\x83\n", events[2]);
+
+          ByteArrayOutputStream* bytes = new ByteArrayOutputStream();
+          OutputStreamPtr out(bytes);
+          CharsetEncoderPtr enc(CharsetEncoder::getUTF8Encoder());
+          OutputStreamWriter writer(out, enc);
+          Pool p;
+          for(int i = 0; i < 3; i++) {
+            writer.write(events[i], p);
+          }
+          writer.write(events[2], p);
+
+          std::string expected("first event\n");
+          expected.append(BUFSIZE * 5, 'A');
+          expected.append("\ncaf\xC3\xA9 \xE4\xB8\x83\n");
+          expected.append("caf\xC3\xA9 \xE4\xB8\x83\n");
+          std::vector<unsigned char> actual(bytes->toByteArray());
+          LOGUNIT_ASSERT_EQUAL(expected, std::string(actual.begin(), actual.end()));
+        }
+
+        void singleByte1() {
+          //
+          //   "Privet" in Cyrillic and "Pr\u00FCfung \u20AC"
+          LogString cyrillic;
+          Transcoder::decodeUTF8("\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", cyrillic);
+          LogString latin;
+          Transcoder::decodeUTF8("Pr\xC3\xBC\x66ung \xE2\x82\xAC", latin);
+
+          char buf[BUFSIZE];
+          ByteBuffer out(buf, BUFSIZE);
+          CharsetEncoderPtr koi8r(CharsetEncoder::getEncoder(LOG4CXX_STR("KOI8-R")));
+          LogString::const_iterator iter = cyrillic.begin();
+          log4cxx_status_t stat = koi8r->encode(cyrillic, iter, out);
+          LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::isError(stat));
+          LOGUNIT_ASSERT(iter == cyrillic.end());
+          out.flip();
+          LOGUNIT_ASSERT_EQUAL(std::string("\xF0\xD2\xC9\xD7\xC5\xD4"),
+              std::string(out.data(), out.limit()));
+
+          out.clear();
+          CharsetEncoderPtr cp1252(CharsetEncoder::getEncoder(LOG4CXX_STR("windows-1252")));
+          iter = latin.begin();
+          stat = cp1252->encode(latin, iter, out);
+          LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::isError(stat));
+          out.flip();
+          LOGUNIT_ASSERT_EQUAL(std::string("Pr\xFC\x66ung \x80"),
+              std::string(out.data(), out.limit()));
+
+          out.clear();
+          CharsetEncoderPtr latin9(CharsetEncoder::getEncoder(LOG4CXX_STR("ISO-8859-15")));
+          iter = latin.begin();
+          stat = latin9->encode(latin, iter, out);
+          LOGUNIT_ASSERT_EQUAL(false, CharsetEncoder::isError(stat));
+          out.flip();
+          LOGUNIT_ASSERT_EQUAL(std::string("Pr\xFC\x66ung \xA4"),
+              std::string(out.data(), out.limit()));
+        }
+
+        void singleByte2() {
+          LogString greeting;
+          Transcoder::decodeUTF8("Hello \xD0\x9F", greeting);
+          char buf[BUFSIZE];
+          ByteBuffer out(buf, BUFSIZE);
+          CharsetEncoderPtr cp1252(CharsetEncoder::getEncoder(LOG4CXX_STR("CP1252")));
+          LogString::const_iterator iter = greeting.begin();
+          log4cxx_status_t stat = cp1252->encode(greeting, iter, out);
+          LOGUNIT_ASSERT_EQUAL(true, CharsetEncoder::isError(stat));
+          LOGUNIT_ASSERT_EQUAL((size_t) 6, out.position());
+          LOGUNIT_ASSERT(iter != greeting.end());
+        }
+
+        void cache1() {
+          CharsetEncoderPtr enc1(CharsetEncoder::getEncoder(LOG4CXX_STR("KOI8-R")));
+          CharsetEncoderPtr enc2(CharsetEncoder::getEncoder(LOG4CXX_STR("koi8-r")));
+          LOGUNIT_ASSERT(enc1 == enc2);
+        }
+
+        /**
+         *  apr_xlate keeps conversion state per handle,
+         *  so those encoders are not shared.
+         */
+        void cache2() {
+          try {
+            CharsetEncoderPtr enc1(CharsetEncoder::getEncoder(LOG4CXX_STR("UTF-7")));
+            CharsetEncoderPtr enc2(CharsetEncoder::getEncoder(LOG4CXX_STR("UTF-7")));
+            LOGUNIT_ASSERT(enc1 != enc2);
+          } catch(IllegalArgumentException&) {
+            //   charset not supported by apr_xlate
+          }
+        }
         
 #if APR_HAS_THREADS        
         class ThreadPackage {
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/logstring.h>
+#include <log4cxx/helpers/clock.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/spi/loggerrepository.h>
+#include <log4cxx/spi/loggingevent.h>
+#include "../insertwide.h"
+#include "../logunit.h"
+#include <apr_time.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+
+/**
+   Unit test {@link Clock}.
+   
+   */
+LOGUNIT_CLASS(ClockTestCase) {
+  LOGUNIT_TEST_SUITE(ClockTestCase);
+          LOGUNIT_TEST(testDefault);
+          LOGUNIT_TEST(testCoarse);
+          LOGUNIT_TEST(testTSC);
+          LOGUNIT_TEST(testGetClock);
+          LOGUNIT_TEST(testRepositoryClock);
+  LOGUNIT_TEST_SUITE_END();
+
+  /**
+   * Asserts that the clock is within a second of apr_time_now.
+   */
+  void assertCurrent(const ClockPtr& clock) {
+    for(int i = 0; i < 1000; i++) {
+        log4cxx_int64_t before = ((log4cxx_int64_t) apr_time_now()) * 1000;
+        log4cxx_int64_t nanos = clock->currentTimeNanos();
+        log4cxx_int64_t after = ((log4cxx_int64_t) apr_time_now()) * 1000;
+        LOGUNIT_ASSERT(nanos > before - APR_INT64_C(1000000000));
+        LOGUNIT_ASSERT(nanos < after + APR_INT64_C(1000000000));
+    }
+  }
+
+  public:
+  void testDefault() {
+    assertCurrent(Clock::getDefault());
+  }
+
+  void testCoarse() {
+    assertCurrent(Clock::getCoarse());
+  }
+
+  void testTSC() {
+    assertCurrent(Clock::getTSC());
+  }
+
+  void testGetClock() {
+    ClockPtr defaultClock(Clock::getDefault());
+    LOGUNIT_ASSERT(Clock::getCoarse() == Clock::getClock(LOG4CXX_STR("Coarse"), defaultClock));
+    LOGUNIT_ASSERT(Clock::getTSC() == Clock::getClock(LOG4CXX_STR("TSC"), defaultClock));
+    LOGUNIT_ASSERT(defaultClock == Clock::getClock(LOG4CXX_STR("default"), Clock::getTSC()));
+    LOGUNIT_ASSERT(defaultClock == Clock::getClock(LOG4CXX_STR("sundial"), defaultClock));
+  }
+
+  /**
+   * Events are time stamped by the clock of the repository.
+   */
+  void testRepositoryClock() {
+    LoggerRepositoryPtr repository(LogManager::getLoggerRepository());
+    LOGUNIT_ASSERT(Clock::getDefault() == repository->getClock());
+    LoggingEvent event(LOG4CXX_STR("org.example"), Level::getInfo(),
+        LOG4CXX_STR("Hello"), LOG4CXX_LOCATION, *Clock::getTSC());
+    LOGUNIT_ASSERT_EQUAL(event.getTimeStamp(), (log4cxx_time_t) (event.getTimeStampNanos() / 1000));
+    LOGUNIT_ASSERT(event.getTimeStamp() <= apr_time_now() + 1000000);
+  }
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(ClockTestCase);
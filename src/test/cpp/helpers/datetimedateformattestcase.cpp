@@ -18,6 +18,7 @@
 #define __STDC_CONSTANT_MACROS
 #include <log4cxx/logstring.h>
 #include <log4cxx/helpers/datetimedateformat.h>
+#include <log4cxx/helpers/simpledateformat.h>
 #include "../logunit.h"
 #include <log4cxx/helpers/pool.h>
 #include "../insertwide.h"
@@ -70,6 +71,8 @@ LOGUNIT_CLASS(DateTimeDateFormatTestCase)
   LOGUNIT_TEST( test7 );
   LOGUNIT_TEST( test8 );
 #endif
+  LOGUNIT_TEST( test9 );
+  LOGUNIT_TEST( test10 );
   LOGUNIT_TEST_SUITE_END();
 
 
@@ -235,6 +238,56 @@ public:
   }
 #endif
 
+  /**
+   * Check that a compiled pattern agrees with the token by token
+   * formatting, a trailing 'z' prevents the second formatter
+   * from being compiled.
+   */
+  void test9()
+  {
+    const logchar* zones[] = { LOG4CXX_STR("GMT"), LOG4CXX_STR("GMT-6"),
+         LOG4CXX_STR("GMT+05:30"), LOG4CXX_STR("GMT-09:45") };
+    LogString pattern(LOG4CXX_STR("yyyy-MM-dd D w W HH k mm ss SSS SSSSSS Z "));
+    Pool p;
+    for(size_t i = 0; i < sizeof(zones)/sizeof(zones[0]); i++) {
+        TimeZonePtr zone(TimeZone::getTimeZone(zones[i]));
+        SimpleDateFormat compiled(pattern);
+        compiled.setTimeZone(zone);
+        SimpleDateFormat tokens(pattern + LOG4CXX_STR("z"));
+        tokens.setTimeZone(zone);
+        apr_time_t start = MICROSECONDS_PER_DAY * 12400 + 123456;
+        for(apr_time_t t = start - MICROSECONDS_PER_DAY * 1000;
+            t < start + MICROSECONDS_PER_DAY * 1000;
+            t += APR_INT64_C(3599999999) * 7) {
+            LogString actual;
+            compiled.format(actual, t, p);
+            LogString expected;
+            tokens.format(expected, t, p);
+            LOGUNIT_ASSERT_EQUAL(expected.substr(0, actual.length()), actual);
+        }
+    }
+  }
+
+  /**
+   * Check nanosecond formatting by compiled and uncompiled patterns.
+   */
+  void test10()
+  {
+    log4cxx_int64_t nanos = MICROSECONDS_PER_DAY * 12419000 + APR_INT64_C(3723012345678);
+    Pool p;
+    SimpleDateFormat compiled(LOG4CXX_STR("HH:mm:ss,SSSSSSSSS"));
+    compiled.setTimeZone(TimeZone::getGMT());
+    LogString actual;
+    compiled.formatNanos(actual, nanos, p);
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("01:02:03,012345678"), actual);
+
+    SimpleDateFormat tokens(LOG4CXX_STR("HH:mm:ss,SSSSSSSSS z"));
+    tokens.setTimeZone(TimeZone::getGMT());
+    actual.erase();
+    tokens.formatNanos(actual, nanos, p);
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("01:02:03,012345678"), actual.substr(0, 18));
+  }
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(DateTimeDateFormatTestCase);
@@ -0,0 +1,260 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/formatbuffer.h>
+#include "../logunit.h"
+
+#include <log4cxx/writerappender.h>
+#include <log4cxx/simplelayout.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/logmanager.h>
+#include <log4cxx/level.h>
+#include <log4cxx/helpers/outputstreamwriter.h>
+#include <log4cxx/helpers/outputstream.h>
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/spi/loggingevent.h>
+#include <log4cxx/spi/location/locationinfo.h>
+#include <new>
+#include <stdlib.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+using namespace log4cxx::spi;
+
+//
+//   counts heap allocations made through operator new
+//      by any code in the test program
+//
+static volatile unsigned long allocations = 0;
+
+#if __cplusplus >= 201103L
+#define LOG4CXX_TEST_THROW_BAD_ALLOC
+#define LOG4CXX_TEST_NOTHROW noexcept
+#else
+#define LOG4CXX_TEST_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define LOG4CXX_TEST_NOTHROW throw()
+#endif
+
+void* operator new(size_t size) LOG4CXX_TEST_THROW_BAD_ALLOC {
+    allocations++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) LOG4CXX_TEST_THROW_BAD_ALLOC {
+    return operator new(size);
+}
+
+void operator delete(void* p) LOG4CXX_TEST_NOTHROW {
+    free(p);
+}
+
+void operator delete[](void* p) LOG4CXX_TEST_NOTHROW {
+    free(p);
+}
+
+namespace {
+    /**
+     *  Output stream that discards its output.
+     */
+    class NullOutputStream : public OutputStream {
+    public:
+        NullOutputStream() : count(0) {}
+        void close(Pool&) {}
+        void flush(Pool&) {}
+        void write(ByteBuffer& buf, Pool&) {
+            count += buf.remaining();
+            buf.position(buf.limit());
+        }
+        size_t count;
+    };
+
+    /**
+     *  SimpleLayout that counts calls to format.
+     */
+    class CountingLayout : public SimpleLayout {
+    public:
+        CountingLayout() : count(0) {}
+        void format(LogString& output, const LoggingEventPtr& event, Pool& p) const {
+            count++;
+            SimpleLayout::format(output, event, p);
+        }
+        mutable int count;
+    };
+
+    WriterAppenderPtr createAppender(const LayoutPtr& layout,
+                                     NullOutputStream*& nos) {
+        Pool p;
+        nos = new NullOutputStream();
+        OutputStreamPtr os(nos);
+        CharsetEncoderPtr enc(CharsetEncoder::getUTF8Encoder());
+        WriterPtr writer(new OutputStreamWriter(os, enc));
+        WriterAppenderPtr appender(new WriterAppender());
+        appender->setLayout(layout);
+        appender->setWriter(writer);
+        appender->activateOptions(p);
+        return appender;
+    }
+}
+
+/**
+ *   Tests reuse of the per-thread formatting buffers.
+ */
+LOGUNIT_CLASS(FormatBufferTestCase)
+{
+   LOGUNIT_TEST_SUITE(FormatBufferTestCase);
+      LOGUNIT_TEST(testReuse);
+      LOGUNIT_TEST(testNested);
+      LOGUNIT_TEST(testHighWater);
+      LOGUNIT_TEST(testAppendDoesNotAllocate);
+      LOGUNIT_TEST(testSharedFormatting);
+      LOGUNIT_TEST(testPatternLayoutEquivalence);
+   LOGUNIT_TEST_SUITE_END();
+
+public:
+   void tearDown() {
+      LogManager::resetConfiguration();
+   }
+
+   void testReuse() {
+      const LogString::value_type* first = 0;
+      {
+          FormatBuffer buf;
+          buf.get().append(100, 0x41);
+          first = buf.get().data();
+      }
+      FormatBuffer buf;
+      LOGUNIT_ASSERT(buf.get().empty());
+      LOGUNIT_ASSERT(buf.get().capacity() >= 100);
+      buf.get().append(100, 0x42);
+      LOGUNIT_ASSERT(first == buf.get().data());
+   }
+
+   void testNested() {
+      FormatBuffer outer;
+      outer.get().append(LOG4CXX_STR("outer"));
+      {
+          FormatBuffer inner;
+          LOGUNIT_ASSERT(&outer.get() != &inner.get());
+          LOGUNIT_ASSERT(inner.get().empty());
+          inner.get().append(LOG4CXX_STR("inner"));
+      }
+      LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("outer"), outer.get());
+   }
+
+   void testHighWater() {
+      {
+          FormatBuffer buf;
+          buf.get().append(FormatBuffer::HIGH_WATER + 1, 0x41);
+      }
+      FormatBuffer buf;
+      LOGUNIT_ASSERT(buf.get().capacity() <= FormatBuffer::HIGH_WATER);
+   }
+
+   /**
+    *  Once the buffers have grown to the size of the messages,
+    *  appending does not allocate.
+    */
+   void testAppendDoesNotAllocate() {
+      Pool p;
+      NullOutputStream* nos = 0;
+      CountingLayout* layout = new CountingLayout();
+      WriterAppenderPtr appender(createAppender(layout, nos));
+      //
+      //   alternate between two events so each append
+      //      formats the event again
+      LoggingEventPtr events[2];
+      for(int i = 0; i < 2; i++) {
+          events[i] = new LoggingEvent(LOG4CXX_STR("org.example.foo"),
+              Level::getInfo(), LOG4CXX_STR("Hello, World"),
+              LocationInfo::getLocationUnavailable());
+      }
+
+      appender->doAppend(events[0], p);
+      appender->doAppend(events[1], p);
+      size_t expected = nos->count / 2;
+      LOGUNIT_ASSERT(expected > 0);
+
+      unsigned long before = allocations;
+      for(int i = 0; i < 100; i++) {
+          appender->doAppend(events[i % 2], p);
+      }
+      unsigned long after = allocations;
+      LOGUNIT_ASSERT_EQUAL(0UL, after - before);
+      LOGUNIT_ASSERT_EQUAL(102, layout->count);
+      LOGUNIT_ASSERT_EQUAL(expected * 102, nos->count);
+      appender->close();
+   }
+
+   /**
+    *  Appenders with equivalent layouts format an event once,
+    *  a subclass is not equivalent to its base class.
+    */
+   void testSharedFormatting() {
+      NullOutputStream* nos0 = 0;
+      NullOutputStream* nos1 = 0;
+      NullOutputStream* nos2 = 0;
+      NullOutputStream* nos3 = 0;
+      CountingLayout* layout1 = new CountingLayout();
+      CountingLayout* layout2 = new CountingLayout();
+      LoggerPtr root(Logger::getRootLogger());
+      //
+      //   the SimpleLayout formats first, CountingLayout shares its
+      //      class but must not reuse its output
+      root->addAppender(createAppender(new SimpleLayout(), nos0));
+      root->addAppender(createAppender(layout1, nos1));
+      root->addAppender(createAppender(layout2, nos2));
+      root->addAppender(createAppender(
+          new PatternLayout(LOG4CXX_STR("%m%n")), nos3));
+
+      LoggerPtr logger(Logger::getLogger("org.example.foo"));
+      LOG4CXX_INFO(logger, "Hello, World");
+      LOGUNIT_ASSERT_EQUAL(1, layout1->count);
+      LOGUNIT_ASSERT_EQUAL(0, layout2->count);
+      LOGUNIT_ASSERT(nos1->count > 0);
+      LOGUNIT_ASSERT_EQUAL(nos0->count, nos1->count);
+      LOGUNIT_ASSERT_EQUAL(nos1->count, nos2->count);
+      LOGUNIT_ASSERT(nos3->count < nos1->count);
+
+      LOG4CXX_INFO(logger, "Hello, World");
+      LOGUNIT_ASSERT_EQUAL(2, layout1->count);
+      LOGUNIT_ASSERT_EQUAL(0, layout2->count);
+      LOGUNIT_ASSERT_EQUAL(nos1->count, nos2->count);
+   }
+
+   /**
+    *  Pattern layouts are equivalent when they share their pattern.
+    */
+   void testPatternLayoutEquivalence() {
+      PatternLayout layout1(LOG4CXX_STR("%c %m%n"));
+      PatternLayout layout2(LOG4CXX_STR("%c %m%n"));
+      PatternLayout layout3(LOG4CXX_STR("%m%n"));
+      SimpleLayout simple;
+      LOGUNIT_ASSERT(layout1.isEquivalent(layout2));
+      LOGUNIT_ASSERT(!layout1.isEquivalent(layout3));
+      LOGUNIT_ASSERT(!layout1.isEquivalent(simple));
+      LOGUNIT_ASSERT(simple.isEquivalent(SimpleLayout()));
+      LOGUNIT_ASSERT(!simple.isEquivalent(CountingLayout()));
+   }
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(FormatBufferTestCase);
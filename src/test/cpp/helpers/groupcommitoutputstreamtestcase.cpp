@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxx/helpers/groupcommitoutputstream.h>
+#include "../logunit.h"
+
+#include <log4cxx/helpers/bytebuffer.h>
+#include <log4cxx/helpers/pool.h>
+#include <log4cxx/helpers/thread.h>
+#include <log4cxx/helpers/exception.h>
+
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+
+namespace {
+    /**
+     *  Output stream that counts bytes written and syncs.
+     */
+    class SyncCountingOutputStream : public OutputStream {
+    public:
+        SyncCountingOutputStream() : count(0), syncs(0), closed(false), failSync(false) {}
+        void close(Pool&) { closed = true; }
+        void flush(Pool&) {}
+        void write(ByteBuffer& buf, Pool&) {
+            count += buf.remaining();
+            buf.position(buf.limit());
+        }
+        void sync(Pool&) {
+            syncs++;
+            if (failSync) {
+                throw IOException();
+            }
+        }
+        size_t count;
+        volatile int syncs;
+        bool closed;
+        bool failSync;
+    };
+
+    void write(OutputStream& os, size_t length, Pool& p) {
+        char data[100] = { 0 };
+        ByteBuffer buf(data, length);
+        os.write(buf, p);
+    }
+}
+
+/**
+ *   Tests batching of syncs by GroupCommitOutputStream.
+ */
+LOGUNIT_CLASS(GroupCommitOutputStreamTestCase)
+{
+   LOGUNIT_TEST_SUITE(GroupCommitOutputStreamTestCase);
+      LOGUNIT_TEST(testAwaitCommit);
+      LOGUNIT_TEST(testCommitInterval);
+      LOGUNIT_TEST(testCommitSize);
+      LOGUNIT_TEST(testClose);
+      LOGUNIT_TEST(testCommitFailure);
+   LOGUNIT_TEST_SUITE_END();
+
+public:
+   /**
+    *  Waiting starts a commit without waiting for the interval,
+    *  and does not sync again if nothing was written.
+    */
+   void testAwaitCommit() {
+      Pool p;
+      SyncCountingOutputStream* out = new SyncCountingOutputStream();
+      OutputStreamPtr os(out);
+      GroupCommitOutputStreamPtr gcos(new GroupCommitOutputStream(os, 60000, 0));
+      write(*gcos, 10, p);
+      gcos->awaitCommit(p);
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+      gcos->awaitCommit(p);
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+      gcos->close(p);
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+   }
+
+   /**
+    *  Written bytes are synced once the interval has passed.
+    */
+   void testCommitInterval() {
+      Pool p;
+      SyncCountingOutputStream* out = new SyncCountingOutputStream();
+      OutputStreamPtr os(out);
+      GroupCommitOutputStreamPtr gcos(new GroupCommitOutputStream(os, 50, 0));
+      write(*gcos, 10, p);
+      for(int i = 0; i < 100 && out->syncs == 0; i++) {
+         Thread::sleep(20);
+      }
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+      gcos->close(p);
+   }
+
+   /**
+    *  Writing commitSize bytes starts a commit before the interval.
+    */
+   void testCommitSize() {
+      Pool p;
+      SyncCountingOutputStream* out = new SyncCountingOutputStream();
+      OutputStreamPtr os(out);
+      GroupCommitOutputStreamPtr gcos(new GroupCommitOutputStream(os, 60000, 100));
+      write(*gcos, 50, p);
+      Thread::sleep(100);
+      LOGUNIT_ASSERT_EQUAL(0, (int) out->syncs);
+      write(*gcos, 50, p);
+      for(int i = 0; i < 100 && out->syncs == 0; i++) {
+         Thread::sleep(20);
+      }
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+      gcos->close(p);
+   }
+
+   /**
+    *  close commits the remaining bytes and closes the destination.
+    */
+   void testClose() {
+      Pool p;
+      SyncCountingOutputStream* out = new SyncCountingOutputStream();
+      OutputStreamPtr os(out);
+      GroupCommitOutputStreamPtr gcos(new GroupCommitOutputStream(os, 60000, 0));
+      write(*gcos, 10, p);
+      gcos->close(p);
+      LOGUNIT_ASSERT_EQUAL(1, (int) out->syncs);
+      LOGUNIT_ASSERT_EQUAL((size_t) 10, out->count);
+      LOGUNIT_ASSERT(out->closed);
+   }
+
+   /**
+    *  A failed commit is reported to the threads waiting for the
+    *  bytes it covered, and a later commit covers them again.
+    */
+   void testCommitFailure() {
+      Pool p;
+      SyncCountingOutputStream* out = new SyncCountingOutputStream();
+      OutputStreamPtr os(out);
+      GroupCommitOutputStreamPtr gcos(new GroupCommitOutputStream(os, 60000, 0));
+      write(*gcos, 10, p);
+      out->failSync = true;
+      bool thrown = false;
+      try {
+         gcos->awaitCommit(p);
+      } catch(IOException&) {
+         thrown = true;
+      }
+      LOGUNIT_ASSERT(thrown);
+      out->failSync = false;
+      int syncs = out->syncs;
+      thrown = false;
+      try {
+         gcos->awaitCommit(p);
+      } catch(IOException&) {
+         thrown = true;
+      }
+      LOGUNIT_ASSERT(thrown);
+      LOGUNIT_ASSERT_EQUAL(syncs, (int) out->syncs);
+      write(*gcos, 10, p);
+      gcos->awaitCommit(p);
+      LOGUNIT_ASSERT_EQUAL(syncs + 1, (int) out->syncs);
+      gcos->close(p);
+      LOGUNIT_ASSERT(out->closed);
+   }
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(GroupCommitOutputStreamTestCase);
@@ -43,6 +43,8 @@ LOGUNIT_CLASS(TimeZoneTestCase) {
           LOGUNIT_TEST(test4);
           LOGUNIT_TEST(test5);
           LOGUNIT_TEST(test6);
+          LOGUNIT_TEST(test7);
+          LOGUNIT_TEST(test8);
   LOGUNIT_TEST_SUITE_END();
 
 #define MICROSECONDS_PER_DAY APR_INT64_C(86400000000)
@@ -119,6 +121,67 @@ void test6() {
   LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("GMT"), tz->getID());
 }
 
+/**
+ * Checks that the cached offsets of the default timezone
+ * agree with apr_time_exp_lt over several years.
+ */
+void test7() {
+  TimeZonePtr tz(TimeZone::getDefault());
+  apr_time_t start = MICROSECONDS_PER_DAY * 12000 + 1234;
+  apr_time_t end = start + MICROSECONDS_PER_DAY * 1500;
+  for(apr_time_t t = start; t < end; t += APR_INT64_C(3599999999) * 5) {
+    apr_time_exp_t expected;
+    apr_time_exp_lt(&expected, t);
+    apr_time_exp_t exploded;
+    tz->explode(&exploded, t);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_gmtoff, exploded.tm_gmtoff);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_isdst, exploded.tm_isdst);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_year, exploded.tm_year);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_yday, exploded.tm_yday);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_hour, exploded.tm_hour);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_min, exploded.tm_min);
+    LOGUNIT_ASSERT_EQUAL(expected.tm_usec, exploded.tm_usec);
+  }
+}
+
+
+/**
+ * Checks the seconds either side of each offset transition of
+ * the default timezone, after exploding a later time so that the
+ * cached range was found by scanning backwards.
+ */
+void test8() {
+  TimeZonePtr tz(TimeZone::getDefault());
+  const apr_time_t hour = APR_INT64_C(3600000000);
+  const apr_time_t second = APR_USEC_PER_SEC;
+  apr_time_t start = MICROSECONDS_PER_DAY * 12000;
+  apr_time_t end = start + MICROSECONDS_PER_DAY * 1500;
+  apr_time_exp_t previous;
+  apr_time_exp_lt(&previous, start);
+  for(apr_time_t t = start + hour; t < end; t += hour) {
+    apr_time_exp_t expected;
+    apr_time_exp_lt(&expected, t);
+    if (expected.tm_gmtoff != previous.tm_gmtoff) {
+      //
+      //   find the first second of the new offset
+      apr_time_t transition = t - hour;
+      while(apr_time_exp_lt(&expected, transition), expected.tm_gmtoff == previous.tm_gmtoff) {
+        transition += second;
+      }
+      apr_time_exp_t exploded;
+      tz->explode(&exploded, transition + MICROSECONDS_PER_DAY);
+      for(apr_time_t probe = transition - second; probe <= transition + second; probe += second) {
+        apr_time_exp_lt(&expected, probe);
+        tz->explode(&exploded, probe);
+        LOGUNIT_ASSERT_EQUAL(expected.tm_gmtoff, exploded.tm_gmtoff);
+        LOGUNIT_ASSERT_EQUAL(expected.tm_isdst, exploded.tm_isdst);
+        LOGUNIT_ASSERT_EQUAL(expected.tm_hour, exploded.tm_hour);
+        LOGUNIT_ASSERT_EQUAL(expected.tm_sec, exploded.tm_sec);
+      }
+    }
+    previous = expected;
+  }
+}
 
 };
 
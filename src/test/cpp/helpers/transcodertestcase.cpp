@@ -53,6 +53,7 @@ LOGUNIT_CLASS(TranscoderTestCase)
                 LOGUNIT_TEST(testDecodeUTF8_2);
                 LOGUNIT_TEST(testDecodeUTF8_3);
                 LOGUNIT_TEST(testDecodeUTF8_4);
+                LOGUNIT_TEST(testDecodeUTF8_5);
 #if LOG4CXX_UNICHAR_API
                 LOGUNIT_TEST(udecode2);
                 LOGUNIT_TEST(udecode4);
@@ -249,6 +250,28 @@ public:
         LOGUNIT_ASSERT_EQUAL(true, iter == out.end());
     }
 
+    /**
+     *   Places a non-ASCII character at each position across several
+     *   ASCII run boundaries and checks that it survives a round trip.
+     */
+    void testDecodeUTF8_5() {
+        for(size_t pos = 0; pos <= 40; pos++) {
+            std::string src(40, 'a');
+            src.insert(pos, "\xC2\xA9");
+            LogString out;
+            Transcoder::decodeUTF8(src, out);
+            LogString::const_iterator iter = out.begin();
+            for(size_t i = 0; i < 41; i++) {
+                unsigned int sv = Transcoder::decode(out, iter);
+                LOGUNIT_ASSERT_EQUAL(i == pos ? 0xA9U : (unsigned int) 'a', sv);
+            }
+            LOGUNIT_ASSERT_EQUAL(true, iter == out.end());
+            std::string encoded;
+            Transcoder::encodeUTF8(out, encoded);
+            LOGUNIT_ASSERT_EQUAL(src, encoded);
+        }
+    }
+
 
 #if LOG4CXX_UNICHAR_API
         void udecode2() {
@@ -72,6 +72,7 @@ LOGUNIT_CLASS(LoggerTestCase)
                 LOGUNIT_TEST(testHierarchy1);
                 LOGUNIT_TEST(testTrace);
                 LOGUNIT_TEST(testIsTraceEnabled);
+                LOGUNIT_TEST(testLazyMessage);
         LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -453,7 +454,53 @@ public:
         LOGUNIT_ASSERT_EQUAL(false, root->isTraceEnabled());
     }
 
+    /**
+     * Tests that a lazily supplied message is only produced
+     * once the event is accepted by an appender, and before
+     * the logging call returns if the appender keeps the event.
+     */
+    void testLazyMessage() {
+        VectorAppenderPtr appender = new VectorAppender();
+        appender->setThreshold(Level::getWarn());
+        LoggerPtr root = Logger::getRootLogger();
+        root->addAppender(appender);
+        root->setLevel(Level::getDebug());
+
+        int calls = 0;
+        CountingSupplier supplier(&calls);
+        LOG4CXX_TRACE_LAZY(root, supplier);
+        LOG4CXX_DEBUG_LAZY(root, supplier);
+        LOGUNIT_ASSERT_EQUAL((size_t) 0, appender->vector.size());
+        LOGUNIT_ASSERT_EQUAL(0, calls);
+
+        appender->setThreshold(Level::getAll());
+        LOG4CXX_DEBUG_LAZY(root, supplier);
+        LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->vector.size());
+        LOGUNIT_ASSERT_EQUAL(1, calls);
+
+        LoggingEventPtr event = appender->vector[0];
+        LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("Supplied")), event->getMessage());
+        LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("Supplied")), event->getRenderedMessage());
+        LOGUNIT_ASSERT_EQUAL(1, calls);
+
+        spi::MessageSupplierPtr counting(
+            new spi::FunctorMessageSupplier<CountingSupplier>(supplier));
+        LOG4CXX_DEBUG_LAZY(root, counting);
+        LOGUNIT_ASSERT_EQUAL((size_t) 2, appender->vector.size());
+        LOGUNIT_ASSERT_EQUAL(2, calls);
+        LOGUNIT_ASSERT_EQUAL(LogString(LOG4CXX_STR("Supplied")), appender->vector[1]->getMessage());
+    }
+
 protected:
+        struct CountingSupplier {
+            CountingSupplier(int* c) : calls(c) {}
+            std::string operator()() const {
+                (*calls)++;
+                return "Supplied";
+            }
+            int* calls;
+        };
+
         static LogString MSG;
         LoggerPtr logger;
         AppenderPtr a1;
@@ -20,6 +20,8 @@
 #include <log4cxx/file.h>
 #include <log4cxx/logger.h>
 #include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/stringhelper.h>
+#include <log4cxx/helpers/pool.h>
 #include "insertwide.h"
 #include "logunit.h"
 #include "util/compare.h"
@@ -27,11 +29,14 @@
 
 
 using namespace log4cxx;
+using namespace log4cxx::helpers;
 
 LOGUNIT_CLASS(MDCTestCase)
 {
         LOGUNIT_TEST_SUITE(MDCTestCase);
                 LOGUNIT_TEST(test1);
+                LOGUNIT_TEST(testKeys);
+                LOGUNIT_TEST(testManyKeys);
         LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -55,6 +60,54 @@ public:
                 std::string actual(MDC::get(key));
                 LOGUNIT_ASSERT_EQUAL(expected, actual);
         }
+
+        /**
+         *   Interned keys are stable and share the values of the named keys.
+         */
+        void testKeys()
+        {
+                LogString name(LOG4CXX_STR("testKeys.key"));
+                int handle;
+                LOGUNIT_ASSERT(!MDC::findKey(name, handle));
+                int key = MDC::getKey(name);
+                LOGUNIT_ASSERT_EQUAL(key, MDC::getKey(name));
+                LOGUNIT_ASSERT(MDC::findKey(name, handle));
+                LOGUNIT_ASSERT_EQUAL(key, handle);
+                LOGUNIT_ASSERT_EQUAL(name, MDC::getKeyName(key));
+
+                MDC::putLS(name, LOG4CXX_STR("value"));
+                LogString value;
+                LOGUNIT_ASSERT(MDC::get(key, value));
+                LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value"), value);
+
+                LogString previous;
+                LOGUNIT_ASSERT(MDC::remove(name, previous));
+                value.erase();
+                LOGUNIT_ASSERT(!MDC::get(key, value));
+        }
+
+        /**
+         *   Keys interned across several chunks of the key table
+         *   keep their handles while the table grows.
+         */
+        void testManyKeys()
+        {
+                Pool p;
+                std::vector<int> handles;
+                for(int i = 0; i < 1000; i++) {
+                    LogString name(LOG4CXX_STR("testManyKeys."));
+                    StringHelper::toString(i, p, name);
+                    handles.push_back(MDC::getKey(name));
+                }
+                for(int i = 0; i < 1000; i++) {
+                    LogString name(LOG4CXX_STR("testManyKeys."));
+                    StringHelper::toString(i, p, name);
+                    int handle;
+                    LOGUNIT_ASSERT(MDC::findKey(name, handle));
+                    LOGUNIT_ASSERT_EQUAL(handles[i], handle);
+                    LOGUNIT_ASSERT_EQUAL(name, MDC::getKeyName(handle));
+                }
+        }
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(MDCTestCase);
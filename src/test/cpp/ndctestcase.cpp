@@ -37,6 +37,7 @@ LOGUNIT_CLASS(NDCTestCase)
                 LOGUNIT_TEST(testPushPop);
                 LOGUNIT_TEST(test1);
                 LOGUNIT_TEST(testInherit);
+                LOGUNIT_TEST(testFullMessage);
         LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -101,6 +102,36 @@ public:
            LOGUNIT_ASSERT_EQUAL(expected3, NDC::pop());
         }
 
+        /**
+         *   The full message joins the frames from the bottom up
+         *   and follows pushes and pops at any depth.
+         */
+        void testFullMessage() {
+           NDC::push("a");
+           NDC::push("b");
+           NDC::push("c");
+           LOGUNIT_ASSERT_EQUAL(3, NDC::getDepth());
+           LogString full;
+           LOGUNIT_ASSERT(NDC::get(full));
+           LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("a b c"), full);
+           NDC::pop();
+           NDC::push("d");
+           full.erase();
+           LOGUNIT_ASSERT(NDC::get(full));
+           LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("a b d"), full);
+
+           NDC::Stack* clone = NDC::cloneStack();
+           LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("a b d"), clone->top().second);
+           NDC::clear();
+           LOGUNIT_ASSERT(NDC::empty());
+           NDC::inherit(clone);
+           NDC::push("e");
+           full.erase();
+           LOGUNIT_ASSERT(NDC::get(full));
+           LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("a b d e"), full);
+           NDC::clear();
+        }
+
 };
 
 
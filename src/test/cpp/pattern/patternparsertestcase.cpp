@@ -71,6 +71,7 @@ LOGUNIT_CLASS(PatternParserTestCase)
       LOGUNIT_TEST(testBasic1);
       LOGUNIT_TEST(testBasic2);
       LOGUNIT_TEST(testMultiOption);
+      LOGUNIT_TEST(testAbbreviatedLogger);
    LOGUNIT_TEST_SUITE_END();
 
    LoggingEventPtr event;
@@ -231,6 +232,27 @@ public:
        expected);
    }
 
+   /**
+    *  Abbreviations are cached by the converter, formatting several
+    *  loggers repeatedly must give the same result every time.
+    */
+   void testAbbreviatedLogger()  {
+     std::vector<LogString> options;
+     options.push_back(LOG4CXX_STR("1."));
+     PatternConverterPtr converter(LoggerPatternConverter::newInstance(options));
+     LoggingEventPtr other(new LoggingEvent(
+         LOG4CXX_STR("org.apache.log4cxx.Other"), Level::getInfo(), LOG4CXX_STR("msg 2"), LOG4CXX_LOCATION));
+     Pool p;
+     for(int i = 0; i < 3; i++) {
+         LogString actual;
+         converter->format(event, actual, p);
+         LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("o.foobar"), actual);
+         actual.erase();
+         converter->format(other, actual, p);
+         LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("o.a.l.Other"), actual);
+     }
+   }
+
 };
 
 //
@@ -55,6 +55,8 @@ LOGUNIT_CLASS(SizeBasedRollingTest)  {
            LOGUNIT_TEST(test4);
            LOGUNIT_TEST(test5);
            LOGUNIT_TEST(test6);
+           LOGUNIT_TEST(test7);
+           LOGUNIT_TEST(test8);
    LOGUNIT_TEST_SUITE_END();
 
    LoggerPtr root;
@@ -344,7 +346,83 @@ LOGUNIT_CLASS(SizeBasedRollingTest)  {
 
     LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sbr-test6.log"),  File("witness/rolling/sbr-test3.log")));
   }
+
+  /**
+   * Same as test2 but with a memory mapped active file.
+   */
+  void test7() {
+    PatternLayoutPtr layout = new PatternLayout(LOG4CXX_STR("%m\n"));
+    RollingFileAppenderPtr rfa = new RollingFileAppender();
+    rfa->setName(LOG4CXX_STR("ROLLING"));
+    rfa->setAppend(false);
+    rfa->setLayout(layout);
+    rfa->setFile(LOG4CXX_STR("output/sizeBased-test7.log"));
+    rfa->setMapWindowSize(64 * 1024);
+
+    FixedWindowRollingPolicyPtr swrp = new FixedWindowRollingPolicy();
+    SizeBasedTriggeringPolicyPtr sbtp = new SizeBasedTriggeringPolicy();
+
+    sbtp->setMaxFileSize(100);
+    swrp->setMinIndex(0);
+
+    swrp->setFileNamePattern(LOG4CXX_STR("output/sizeBased-test7.%i"));
+    Pool p;
+    swrp->activateOptions(p);
+
+    rfa->setRollingPolicy(swrp);
+    rfa->setTriggeringPolicy(sbtp);
+    rfa->activateOptions(p);
+    root->addAppender(rfa);
+
+    common(logger, 0);
+    rfa->close();
+
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test7.log"),
+     File("witness/rolling/sbr-test2.log")));
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test7.0"),
+     File("witness/rolling/sbr-test2.0")));
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test7.1"),
+     File("witness/rolling/sbr-test2.1")));
+  }
   
+
+  /**
+   * Tests that rolling happens at the same events when the
+   * file is double buffered and the flusher has not yet written.
+   */
+  void test8() {
+    PatternLayoutPtr layout = new PatternLayout(LOG4CXX_STR("%m\n"));
+    RollingFileAppenderPtr rfa = new RollingFileAppender();
+    rfa->setName(LOG4CXX_STR("ROLLING"));
+    rfa->setAppend(false);
+    rfa->setLayout(layout);
+    rfa->setFlushIntervalMillis(60000);
+
+    FixedWindowRollingPolicyPtr swrp = new FixedWindowRollingPolicy();
+    SizeBasedTriggeringPolicyPtr sbtp = new SizeBasedTriggeringPolicy();
+
+    sbtp->setMaxFileSize(100);
+    swrp->setMinIndex(0);
+
+    swrp->setFileNamePattern(LOG4CXX_STR("output/sizeBased-test8.%i"));
+    Pool p;
+    swrp->activateOptions(p);
+
+    rfa->setRollingPolicy(swrp);
+    rfa->setTriggeringPolicy(sbtp);
+    rfa->activateOptions(p);
+    root->addAppender(rfa);
+
+    common(logger, 0);
+    rfa->close();
+
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.0"),
+     File("witness/rolling/sbr-test2.log")));
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.1"),
+     File("witness/rolling/sbr-test2.0")));
+    LOGUNIT_ASSERT_EQUAL(true, Compare::compare(File("output/sizeBased-test8.2"),
+     File("witness/rolling/sbr-test2.1")));
+  }
 };
 
 
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxx/spi/location/locationinfo.h>
+#include "../logunit.h"
+
+using namespace log4cxx;
+using namespace log4cxx::spi;
+
+//
+//   LOG4CXX_LOCATION must remain an expression usable
+//      at namespace scope and in default arguments
+static const LocationInfo namespaceLocation(LOG4CXX_LOCATION);
+
+static int lineOf(const LocationInfo& location = LOG4CXX_LOCATION) {
+    return location.getLineNumber();
+}
+
+/**
+   Unit tests for LocationInfo
+ */
+LOGUNIT_CLASS(LocationInfoTest)
+{
+        LOGUNIT_TEST_SUITE(LocationInfoTest);
+                LOGUNIT_TEST(testClassAndMethodName);
+                LOGUNIT_TEST(testCallSite);
+                LOGUNIT_TEST(testCallSiteShared);
+                LOGUNIT_TEST(testLocationExpression);
+        LOGUNIT_TEST_SUITE_END();
+
+public:
+  void testClassAndMethodName() {
+    LocationInfo loc("foo.cpp", "void Foo::bar(int)", 42);
+    LOGUNIT_ASSERT_EQUAL((std::string) "Foo", loc.getClassName());
+    LOGUNIT_ASSERT_EQUAL((std::string) "bar", loc.getMethodName());
+    LogString buf;
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("Foo"), loc.getClassName(buf));
+  }
+
+  /**
+   * Names taken from a call site must match those parsed on demand.
+   */
+  void testCallSite() {
+    static const LocationInfo::CallSite site("foo.cpp", "int Foo::bar()", 7);
+    LocationInfo cached(site);
+    LocationInfo parsed("foo.cpp", "int Foo::bar()", 7);
+    LOGUNIT_ASSERT_EQUAL(parsed.getClassName(), cached.getClassName());
+    LOGUNIT_ASSERT_EQUAL(parsed.getMethodName(), cached.getMethodName());
+    LOGUNIT_ASSERT_EQUAL(parsed.getLineNumber(), cached.getLineNumber());
+    LogString buf1, buf2;
+    LOGUNIT_ASSERT_EQUAL(parsed.getClassName(buf1), cached.getClassName(buf2));
+    LOGUNIT_ASSERT_EQUAL(parsed.getMethodName(buf1), cached.getMethodName(buf2));
+    LOGUNIT_ASSERT_EQUAL(parsed.getFileName(buf1), cached.getFileName(buf2));
+    LOGUNIT_ASSERT(buf2.empty());
+  }
+
+  /**
+   * Repeated execution of a statement that declares a call site
+   * should reuse the cached names.
+   */
+  void testCallSiteShared() {
+    const LogString* names[2];
+    LogString buf;
+    for (int i = 0; i < 2; i++) {
+        LOG4CXX_DECLARE_CALL_SITE;
+        LocationInfo loc(LOG4CXX_CALL_SITE_LOCATION);
+        names[i] = &loc.getMethodName(buf);
+    }
+    LOGUNIT_ASSERT(names[0] == names[1]);
+    LOGUNIT_ASSERT(names[0] != &buf);
+  }
+
+  /**
+   * LOG4CXX_LOCATION at namespace scope and as a default argument.
+   */
+  void testLocationExpression() {
+    LOGUNIT_ASSERT(namespaceLocation.getLineNumber() > 0);
+    LOGUNIT_ASSERT(lineOf() > 0);
+  }
+
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(LocationInfoTest);
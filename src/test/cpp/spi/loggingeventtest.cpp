@@ -19,7 +19,11 @@
 #include <log4cxx/logmanager.h>
 #include <log4cxx/ndc.h>
 #include <log4cxx/mdc.h>
+#include <log4cxx/patternlayout.h>
+#include <log4cxx/helpers/bytearrayoutputstream.h>
+#include <log4cxx/helpers/objectoutputstream.h>
 #include "../logunit.h"
+#include <algorithm>
 
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -38,6 +42,9 @@ LOGUNIT_CLASS(LoggingEventTest)
                 LOGUNIT_TEST(testSerializationWithLocation);
                 LOGUNIT_TEST(testSerializationNDC);
                 LOGUNIT_TEST(testSerializationMDC);
+                LOGUNIT_TEST(testSnapshot);
+                LOGUNIT_TEST(testFields);
+                LOGUNIT_TEST(testFieldsReplaceMDC);
          LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -48,6 +55,8 @@ public:
 
         void tearDown()
         {
+            NDC::clear();
+            MDC::clear();
             LogManager::shutdown();
         }
         
@@ -116,6 +125,124 @@ public:
       "witness/serialization/mdc.bin", event, 237));
   }
 
+  /**
+   * Snapshots taken by an event are not affected by later
+   * changes to the MDC and NDC of the thread.
+   */
+  void testSnapshot() {
+    MDC::put("snapkey", "value1");
+    NDC::push("outer");
+
+    LoggingEventPtr event =
+      new LoggingEvent(
+        LOG4CXX_STR("root"), Level::getInfo(), LOG4CXX_STR("Hello, world."), LocationInfo::getLocationUnavailable());
+    LogString ndc;
+    event->getNDC(ndc);
+    event->getMDCCopy();
+    LoggingEventPtr other =
+      new LoggingEvent(
+        LOG4CXX_STR("root"), Level::getInfo(), LOG4CXX_STR("Hello, world."), LocationInfo::getLocationUnavailable());
+    other->getNDC(ndc);
+    other->getMDCCopy();
+
+    MDC::put("snapkey", "value2");
+    MDC::put("otherkey", "value3");
+    NDC::push("inner");
+
+    LogString value;
+    LOGUNIT_ASSERT(event->getMDC(LOG4CXX_STR("snapkey"), value));
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value1"), value);
+    value.erase();
+    LOGUNIT_ASSERT(!event->getMDC(LOG4CXX_STR("otherkey"), value));
+    LOGUNIT_ASSERT(event->getNDC(value));
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("outer"), value);
+    value.erase();
+    LOGUNIT_ASSERT(other->getNDC(value));
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("outer"), value);
+
+    value.erase();
+    LOGUNIT_ASSERT(MDC::get(MDC::getKey(LOG4CXX_STR("snapkey")), value));
+    LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXX_STR("value2"), value);
+  }
+
+  /**
+   * Typed fields keep their type and are rendered by %K.
+   */
+  void testFields() {
+    LoggingEventPtr event =
+      new LoggingEvent(
+        LOG4CXX_STR("root"), Level::getInfo(), LOG4CXX_STR("Hello, world."), LocationInfo::getLocationUnavailable());
+    LOGUNIT_ASSERT(event->getFields().empty());
+    event->addField(Field("count", -1234567890123LL));
+    event->addField(Field("ratio", 0.25));
+    event->addField(Field("ok", true));
+    event->addField(Field("user", "alice"));
+    event->addField(Field::bytes("id", "\x01\xAB", 2));
+
+    const Field* count = event->getField(LOG4CXX_STR("count"));
+    LOGUNIT_ASSERT(count != 0);
+    LOGUNIT_ASSERT_EQUAL((int) Field::INT64, (int) count->getType());
+    LOGUNIT_ASSERT(count->getInt64() == -1234567890123LL);
+    LOGUNIT_ASSERT(event->getField(LOG4CXX_STR("missing")) == 0);
+
+    PatternLayout layout(LOG4CXX_STR("%K|%K{user}"));
+    Pool p;
+    LogString result;
+    layout.format(result, event, p);
+    LOGUNIT_ASSERT_EQUAL(
+      (LogString) LOG4CXX_STR("count=-1234567890123 ratio=0.25 ok=true user=alice id=01ab|alice"),
+      result);
+  }
+
+
+  /**
+   * Counts the occurrences of a string in serialized bytes.
+   */
+  static int count(const std::vector<unsigned char>& bytes, const std::string& str) {
+    int found = 0;
+    for(size_t i = 0; i + str.size() <= bytes.size(); i++) {
+      if (std::equal(str.begin(), str.end(), bytes.begin() + i)) {
+        found++;
+      }
+    }
+    return found;
+  }
+
+  /**
+   * A field replaces an MDC entry or an earlier field with the same
+   * key since java.util.Hashtable rejects duplicate keys.
+   */
+  void testFieldsReplaceMDC() {
+    MDC::Map mdc;
+    mdc[LOG4CXX_STR("dup")] = LOG4CXX_STR("mdcvalue");
+    mdc[LOG4CXX_STR("other")] = LOG4CXX_STR("othervalue");
+    FieldList fields;
+    fields.push_back(Field("dup", "firstfield"));
+    fields.push_back(Field("dup", "lastfield"));
+
+    ByteArrayOutputStreamPtr memOut = new ByteArrayOutputStream();
+    Pool p;
+    ObjectOutputStream objOut(memOut, p);
+    objOut.writeObject(mdc, fields, p);
+    objOut.close(p);
+    std::vector<unsigned char> bytes(memOut->toByteArray());
+
+    const unsigned char header[] = { ObjectOutputStream::TC_BLOCKDATA,
+        0x08, 0x00, 0x00, 0x00, 0x07 };
+    std::vector<unsigned char>::iterator size =
+        std::search(bytes.begin(), bytes.end(), header, header + sizeof(header));
+    LOGUNIT_ASSERT(size + sizeof(header) + 4 <= bytes.end());
+    size += sizeof(header);
+    LOGUNIT_ASSERT_EQUAL(0, (int) size[0]);
+    LOGUNIT_ASSERT_EQUAL(0, (int) size[1]);
+    LOGUNIT_ASSERT_EQUAL(0, (int) size[2]);
+    LOGUNIT_ASSERT_EQUAL(2, (int) size[3]);
+    LOGUNIT_ASSERT_EQUAL(1, count(bytes, "dup"));
+    LOGUNIT_ASSERT_EQUAL(1, count(bytes, "lastfield"));
+    LOGUNIT_ASSERT_EQUAL(0, count(bytes, "firstfield"));
+    LOGUNIT_ASSERT_EQUAL(0, count(bytes, "mdcvalue"));
+    LOGUNIT_ASSERT_EQUAL(1, count(bytes, "othervalue"));
+  }
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(LoggingEventTest);